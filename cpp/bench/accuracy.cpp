@@ -0,0 +1,277 @@
+// Statistical accuracy mode: for every sampler variant, spot and trial budget,
+// runs the sampler with `repeats` seeds and compares the estimates with the
+// spot's exact equity (full enumeration of runouts and opponent holdings).
+//
+// Per row: bias (mean estimate - exact), its z-score across seeds (randomized
+// variants only; a deterministic sampler's error is all "bias"), RMSE, the
+// RMSE plain i.i.d. sampling would have at that budget, the sampler's own mean
+// effective-sample-size ratio (ESS / trials), ms per run, and
+// efficiency = 1 / (RMSE^2 * ms), i.e. precision bought per CPU-millisecond.
+
+#include "accuracy.hpp"
+#include "bench_util.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/simulation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace poker_sim_bench {
+
+namespace {
+
+using poker_sim::HandRank;
+
+struct Spot {
+  const char* name;
+  const char* hero;
+  const char* board;
+  int opponents;
+};
+
+/// Fixed corpus: draws, made hands and multiway pots on each post-flop street.
+/// Preflop spots are left out; their exact enumeration is too slow here.
+const Spot kCorpus[] = {
+  {"flop/AhKh-Qh7h2c/1", "AhKh", "Qh7h2c", 1},
+  {"flop/8c8d-Ks7d2h/1", "8c8d", "Ks7d2h", 1},
+  {"flop/JcTc-9c8h2d/1", "JcTc", "9c8h2d", 1},
+  {"turn/JsTs-9s8h2c3d/1", "JsTs", "9s8h2c3d", 1},
+  {"turn/JsTs-9s8h2c3d/2", "JsTs", "9s8h2c3d", 2},
+  {"turn/AcAd-KhQhJc4s/2", "AcAd", "KhQhJc4s", 2},
+  {"river/QcJc-Qd9h5s3c2d/1", "QcJc", "Qd9h5s3c2d", 1},
+  {"river/QcJc-Qd9h5s3c2d/3", "QcJc", "Qd9h5s3c2d", 3},
+  {"river/5c4c-3h2sAdKcKd/2", "5c4c", "3h2sAdKcKd", 2},
+};
+
+const std::uint32_t kBudgets[] = {1000, 4000, 16000, 64000};
+
+struct Variant {
+  const char* name;
+  poker_sim::SamplerMode sampler;
+  bool randomized;  // deterministic variants get no bias z-score
+};
+
+const Variant kVariants[] = {
+  {"iid", poker_sim::SamplerMode::IID, true},
+  {"stratified", poker_sim::SamplerMode::STRATIFIED, true},
+  {"antithetic", poker_sim::SamplerMode::ANTITHETIC, true},
+  {"lhs", poker_sim::SamplerMode::LATIN_HYPERCUBE, true},
+  {"sobol", poker_sim::SamplerMode::SOBOL, false},
+  {"sobol_scrambled", poker_sim::SamplerMode::SOBOL_SCRAMBLED, true},
+};
+
+struct Exact {
+  double share = 0, share_sq = 0;  // mean pot share and its mean square
+  double equity() const { return share; }
+  /// Per-trial variance of the pot-share outcome under i.i.d. sampling.
+  double variance() const { return share_sq - share * share; }
+};
+
+struct OppHand {
+  HandRank rank;
+  std::uint64_t mask;
+};
+
+/// Sums the hero's pot share (and its square) over every set of k disjoint
+/// opponent hands; `tied` counts opponents so far level with the hero.
+void count_sets(const std::vector<OppHand>& hands, std::size_t start, int k, std::uint64_t used,
+                HandRank best, int tied, HandRank hero, double& share, double& share_sq,
+                std::uint64_t& total) {
+  if (k == 0) {
+    ++total;
+    if (best <= hero) {
+      share += 1.0 / (1 + tied);
+      share_sq += 1.0 / ((1 + tied) * (1 + tied));
+    }
+    return;
+  }
+  for (std::size_t i = start; i < hands.size(); ++i) {
+    if (hands[i].mask & used) continue;
+    count_sets(hands, i + 1, k - 1, used | hands[i].mask, std::max(best, hands[i].rank),
+               tied + (hands[i].rank == hero), hero, share, share_sq, total);
+  }
+}
+
+Exact exact_equity(const std::vector<uint8_t>& hero, const std::vector<uint8_t>& board, int opponents) {
+  std::uint64_t known = 0;
+  for (uint8_t c : hero) known |= 1ull << c;
+  for (uint8_t c : board) known |= 1ull << c;
+  std::vector<uint8_t> deck;
+  for (int c = 0; c < 52; ++c)
+    if (!(known >> c & 1)) deck.push_back(static_cast<uint8_t>(c));
+
+  double share = 0, share_sq = 0;
+  std::uint64_t total = 0;
+  uint8_t cards[7];
+  std::copy(board.begin(), board.end(), cards);
+  const int need = 5 - static_cast<int>(board.size());
+  const int n = static_cast<int>(deck.size());
+
+  auto score_runout = [&](std::uint64_t runout) {
+    cards[5] = hero[0];
+    cards[6] = hero[1];
+    HandRank hero_rank = poker_sim::evaluate_hand(cards, 7);
+    std::vector<OppHand> hands;
+    for (int i = 0; i < n; ++i) {
+      if (runout >> deck[i] & 1) continue;
+      for (int j = i + 1; j < n; ++j) {
+        if (runout >> deck[j] & 1) continue;
+        cards[5] = deck[i];
+        cards[6] = deck[j];
+        hands.push_back({poker_sim::evaluate_hand(cards, 7), (1ull << deck[i]) | (1ull << deck[j])});
+      }
+    }
+    count_sets(hands, 0, opponents, 0, 0, 0, hero_rank, share, share_sq, total);
+  };
+
+  // Runouts of up to two cards; longer ones are outside this corpus.
+  if (need == 0) {
+    score_runout(0);
+  } else if (need == 1) {
+    for (int i = 0; i < n; ++i) {
+      cards[4] = deck[i];
+      score_runout(1ull << deck[i]);
+    }
+  } else {
+    for (int i = 0; i < n; ++i)
+      for (int j = i + 1; j < n; ++j) {
+        cards[3] = deck[i];
+        cards[4] = deck[j];
+        score_runout((1ull << deck[i]) | (1ull << deck[j]));
+      }
+  }
+  Exact e;
+  e.share = share / total;
+  e.share_sq = share_sq / total;
+  return e;
+}
+
+struct Row {
+  std::string variant, spot;
+  std::uint32_t trials = 0;
+  double exact = 0, mean = 0, bias = 0, bias_z = 0, rmse = 0, rmse_iid = 0, ess_ratio = 0, ms = 0,
+         efficiency = 0;
+};
+
+void write_json(std::FILE* f, const std::vector<Row>& rows, int repeats) {
+  write_json_context(f);
+  std::fprintf(f, "  \"repeats\": %d,\n  \"accuracy\": [\n", repeats);
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    const Row& r = rows[i];
+    std::fprintf(f,
+                 "    {\"variant\": \"%s\", \"spot\": \"%s\", \"trials\": %u, \"exact_equity\": %.6f, "
+                 "\"mean_equity\": %.6f, \"bias\": %.6e, \"bias_z\": %.3f, \"rmse\": %.6e, "
+                 "\"rmse_iid\": %.6e, \"ess_ratio\": %.4f, \"ms_per_run\": %.4f, \"efficiency\": %.6e}%s\n",
+                 json_escape(r.variant).c_str(), json_escape(r.spot).c_str(), r.trials, r.exact, r.mean,
+                 r.bias, r.bias_z, r.rmse, r.rmse_iid, r.ess_ratio, r.ms, r.efficiency,
+                 i + 1 < rows.size() ? "," : "");
+  }
+  std::fprintf(f, "  ]\n}\n");
+}
+
+}  // namespace
+
+int run_accuracy(const AccuracyOptions& opts) {
+  const int repeats = opts.repeats > 1 ? opts.repeats : 2;
+  std::vector<Row> rows;
+  bool biased = false;
+
+  if (!opts.json)
+    std::printf("%-40s %7s %8s %10s %7s %9s %9s %6s %9s %11s\n", "variant/spot", "trials", "exact",
+                "bias", "bias_z", "rmse", "rmse_iid", "ess/n", "ms/run", "efficiency");
+
+  for (const Spot& spot : kCorpus) {
+    bool any = false;
+    for (const Variant& v : kVariants)
+      any = any || (std::string(v.name) + "/" + spot.name).find(opts.filter) != std::string::npos;
+    if (!any) continue;
+
+    const auto hero = parse_cards(spot.hero);
+    const auto board = parse_cards(spot.board);
+    const Exact exact = exact_equity(hero, board, spot.opponents);
+
+    for (const Variant& v : kVariants) {
+      std::string label = std::string(v.name) + "/" + spot.name;
+      if (label.find(opts.filter) == std::string::npos) continue;
+      for (std::uint32_t trials : kBudgets) {
+        double sum = 0, sum_sq_err = 0, seconds = 0, ess = 0;
+        std::vector<double> est;
+        for (int r = 0; r < repeats; ++r) {
+          auto t0 = std::chrono::steady_clock::now();
+          poker_sim::SimResult res = poker_sim::run_monte_carlo(hero, board, spot.opponents, trials,
+                                                                static_cast<unsigned>(r + 1), v.sampler);
+          seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+          double eq = res.equity();
+          ess += res.effective_samples / res.total;
+          est.push_back(eq);
+          sum += eq;
+          sum_sq_err += (eq - exact.equity()) * (eq - exact.equity());
+        }
+        Row row;
+        row.variant = v.name;
+        row.spot = spot.name;
+        row.trials = trials;
+        row.exact = exact.equity();
+        row.mean = sum / repeats;
+        row.bias = row.mean - row.exact;
+        double var = 0;
+        for (double e : est) var += (e - row.mean) * (e - row.mean);
+        double se = std::sqrt(var / (repeats - 1) / repeats);
+        if (v.randomized) row.bias_z = se > 0 ? row.bias / se : (row.bias == 0 ? 0 : 1e9);
+        row.rmse = std::sqrt(sum_sq_err / repeats);
+        row.rmse_iid = std::sqrt(exact.variance() / trials);
+        row.ess_ratio = ess / repeats;
+        row.ms = seconds * 1e3 / repeats;
+        row.efficiency = row.rmse > 0 ? 1.0 / (row.rmse * row.rmse * row.ms) : 0;
+        // |z| > 5 is far outside sampling noise for 16+ seeds: the sampler is biased.
+        if (std::fabs(row.bias_z) > 5) biased = true;
+        if (!opts.json) {
+          std::printf("%-40s %7u %8.4f %+10.5f %+7.2f %9.5f %9.5f %6.2f %9.3f %11.4g%s\n", label.c_str(),
+                      trials, row.exact, row.bias, row.bias_z, row.rmse, row.rmse_iid, row.ess_ratio, row.ms,
+                      row.efficiency, std::fabs(row.bias_z) > 5 ? "  BIASED" : "");
+          std::fflush(stdout);
+        }
+        rows.push_back(row);
+      }
+    }
+  }
+
+  if (!opts.json) {
+    std::printf("\n%-16s %7s %12s %12s %10s %11s\n", "variant", "trials", "mean|bias|", "rms(rmse)",
+                "ms/spot", "efficiency");
+    for (const Variant& v : kVariants) {
+      for (std::uint32_t trials : kBudgets) {
+        double abs_bias = 0, mse = 0, ms = 0;
+        int n = 0;
+        for (const Row& r : rows) {
+          if (r.variant != v.name || r.trials != trials) continue;
+          abs_bias += std::fabs(r.bias);
+          mse += r.rmse * r.rmse;
+          ms += r.ms;
+          ++n;
+        }
+        if (n == 0) continue;
+        std::printf("%-16s %7u %12.5f %12.5f %10.3f %11.4g\n", v.name, trials, abs_bias / n,
+                    std::sqrt(mse / n), ms / n, mse > 0 ? 1.0 / (mse / n * ms / n) : 0.0);
+      }
+    }
+  }
+  if (opts.json) write_json(stdout, rows, repeats);
+  if (!opts.out_path.empty()) {
+    std::FILE* f = std::fopen(opts.out_path.c_str(), "w");
+    if (!f) {
+      std::fprintf(stderr, "cannot write %s\n", opts.out_path.c_str());
+      return 1;
+    }
+    write_json(f, rows, repeats);
+    std::fclose(f);
+  }
+  return biased ? 1 : 0;
+}
+
+}  // namespace poker_sim_bench
@@ -0,0 +1,24 @@
+// Statistical accuracy mode of poker_sim_bench: run_monte_carlo vs exact equities.
+
+#ifndef POKER_SIM_BENCH_ACCURACY_HPP
+#define POKER_SIM_BENCH_ACCURACY_HPP
+
+#include <string>
+
+namespace poker_sim_bench {
+
+struct AccuracyOptions {
+  std::string filter;     // substring of "variant/spot" names to run
+  int repeats = 16;       // independent seeds per (spot, budget)
+  bool json = false;
+  std::string out_path;
+};
+
+/// Compares each sampler variant against exact enumeration over a fixed corpus
+/// of spots and trial budgets; reports bias, RMSE and wall time. Returns the
+/// process exit code.
+int run_accuracy(const AccuracyOptions& opts);
+
+}  // namespace poker_sim_bench
+
+#endif
@@ -0,0 +1,420 @@
+// Micro/macro benchmark suite for the simulation engine.
+//
+// Each benchmark runs its body with a growing iteration count until it takes at
+// least --min-time seconds, then reports time per iteration and items/sec.
+// --json emits Google Benchmark's JSON layout, so runs from two versions can be
+// diffed with its tools/compare.py (or any script reading "benchmarks").
+//
+// --accuracy switches to the statistical accuracy mode (see accuracy.cpp).
+//
+// Usage: poker_sim_bench [--filter SUBSTR] [--min-time SEC] [--json] [--out FILE]
+//                        [--accuracy [--repeats N]]
+
+#include "accuracy.hpp"
+#include "bench_util.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/hand_index.hpp"
+#include "poker_sim/hand_strength.hpp"
+#include "poker_sim/outs.hpp"
+#include "poker_sim/parallel.hpp"
+#include "poker_sim/range_equity.hpp"
+#include "poker_sim/simulation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using poker_sim::HandRank;
+
+/// Sink that keeps benchmark results observable so the optimizer can't drop them.
+std::atomic<std::uint64_t> g_sink{0};
+
+struct Benchmark {
+  std::string name;
+  /// Runs `iters` iterations and returns the number of items processed.
+  std::function<std::uint64_t(std::uint64_t iters)> body;
+  /// Extra per-second counters: name and items-per-iteration multiplier.
+  std::vector<std::pair<std::string, double>> rates;
+};
+
+struct Result {
+  std::string name;
+  std::uint64_t iterations = 0;
+  double real_ns = 0;  // per iteration
+  double cpu_ns = 0;   // per iteration, summed over threads
+  double items_per_second = 0;
+  std::vector<std::pair<std::string, double>> counters;
+};
+
+Result run(const Benchmark& b, double min_time) {
+  std::uint64_t iters = 1;
+  for (;;) {
+    std::clock_t c0 = std::clock();
+    auto t0 = std::chrono::steady_clock::now();
+    std::uint64_t items = b.body(iters);
+    double real = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double cpu = static_cast<double>(std::clock() - c0) / CLOCKS_PER_SEC;
+    if (real >= min_time || iters >= (1ull << 40)) {
+      Result r;
+      r.name = b.name;
+      r.iterations = iters;
+      r.real_ns = real * 1e9 / iters;
+      r.cpu_ns = cpu * 1e9 / iters;
+      r.items_per_second = items / real;
+      for (const auto& rate : b.rates)
+        r.counters.push_back({rate.first, rate.second * iters / real});
+      return r;
+    }
+    // Aim a bit past min_time, growing at most 10x per round.
+    double scale = real > 0 ? min_time * 1.4 / real : 10.0;
+    iters = static_cast<std::uint64_t>(iters * std::min(10.0, std::max(2.0, scale)));
+  }
+}
+
+/// Fixed pool of random 7-card hands for the evaluator micro benchmarks.
+std::vector<std::vector<uint8_t>> random_hands(std::size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> deck(52);
+  for (int c = 0; c < 52; ++c) deck[c] = static_cast<uint8_t>(c);
+  std::vector<std::vector<uint8_t>> hands;
+  for (std::size_t i = 0; i < n; ++i) {
+    std::shuffle(deck.begin(), deck.end(), rng);
+    hands.emplace_back(deck.begin(), deck.begin() + 7);
+  }
+  return hands;
+}
+
+/// Fixed spot per board size: hero A♠K♠ and a dry board.
+const std::vector<uint8_t> kHero = {51, 50};
+std::vector<uint8_t> board_of_size(int n) {
+  static const std::vector<uint8_t> full = {8, 20, 30, 2, 17};  // Tc 9d 6h 4c 6d
+  return std::vector<uint8_t>(full.begin(), full.begin() + n);
+}
+
+constexpr std::uint32_t kTrialsPerIter = 1000;
+
+std::vector<Benchmark> make_benchmarks() {
+  std::vector<Benchmark> benches;
+
+  static const auto hands = random_hands(4096, 7);
+  benches.push_back({"eval/compare_hands", [](std::uint64_t iters) {
+    std::uint64_t acc = 0;
+    for (std::uint64_t i = 0; i < iters; ++i)
+      acc += poker_sim::compare_hands(hands[i & 4095], hands[(i + 1) & 4095]) + 1;
+    g_sink += acc;
+    return iters;
+  }, {}});
+  benches.push_back({"eval/evaluate_hand", [](std::uint64_t iters) {
+    std::uint64_t acc = 0;
+    for (std::uint64_t i = 0; i < iters; ++i)
+      acc += poker_sim::evaluate_hand(hands[i & 4095].data(), 7);
+    g_sink += acc;
+    return iters;
+  }, {}});
+  benches.push_back({"eval/evaluate_hand_reference", [](std::uint64_t iters) {
+    std::uint64_t acc = 0;
+    for (std::uint64_t i = 0; i < iters; ++i)
+      acc += poker_sim::evaluate_hand_reference(hands[i & 4095].data(), 7);
+    g_sink += acc;
+    return iters;
+  }, {}});
+
+  // Suit-isomorphism index per street over the random hand pool (hole cards
+  // first, then 0/3/4/5 board cards), and the inverse on those indices.
+  const std::pair<const char*, poker_sim::Street> streets[] = {
+      {"preflop", poker_sim::Street::PREFLOP},
+      {"flop", poker_sim::Street::FLOP},
+      {"turn", poker_sim::Street::TURN},
+      {"river", poker_sim::Street::RIVER},
+  };
+  for (const auto& st : streets) {
+    const poker_sim::HandIndexer& indexer = poker_sim::street_indexer(st.second);
+    benches.push_back({std::string("hand_index/index/") + st.first, [&indexer](std::uint64_t iters) {
+      std::uint64_t acc = 0;
+      for (std::uint64_t i = 0; i < iters; ++i) acc += indexer.index(hands[i & 4095].data());
+      g_sink += acc;
+      return iters;
+    }, {}});
+    std::vector<std::uint64_t> indices;
+    for (const auto& h : hands) indices.push_back(indexer.index(h.data()));
+    benches.push_back({std::string("hand_index/unindex/") + st.first, [&indexer, indices](std::uint64_t iters) {
+      std::uint64_t acc = 0;
+      uint8_t cards[7];
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        indexer.unindex(indices[i & 4095], cards);
+        acc += cards[0];
+      }
+      g_sink += acc;
+      return iters;
+    }, {}});
+  }
+
+  // Dealing alone, mirroring run_monte_carlo's per-trial work (its Dealer):
+  // the live deck is built once; each trial copies it and draws the rest of
+  // the board and the opponents' cards by partial Fisher-Yates.
+  for (int board : {0, 3, 4, 5}) {
+    for (int opp : {1, 8}) {
+      std::string name = "deal/board:" + std::to_string(board) + "/opponents:" + std::to_string(opp);
+      benches.push_back({name, [board, opp](std::uint64_t iters) {
+        std::mt19937 rng(1);
+        std::vector<uint8_t> used(kHero);
+        auto b = board_of_size(board);
+        used.insert(used.end(), b.begin(), b.end());
+        std::vector<uint8_t> deck;
+        for (int c = 0; c < 52; ++c)
+          if (std::find(used.begin(), used.end(), static_cast<uint8_t>(c)) == used.end())
+            deck.push_back(static_cast<uint8_t>(c));
+        const int size = static_cast<int>(deck.size()), need = 5 - board + 2 * opp;
+        std::uint64_t acc = 0;
+        for (std::uint64_t i = 0; i < iters; ++i) {
+          uint8_t buf[52];
+          std::copy(deck.begin(), deck.end(), buf);
+          for (int k = 0; k < need; ++k)
+            std::swap(buf[k], buf[k + std::uniform_int_distribution<int>(0, size - k - 1)(rng)]);
+          acc += buf[need - 1];
+        }
+        g_sink += acc;
+        return iters;
+      }, {}});
+    }
+  }
+
+  // Full engine: one iteration = one run_monte_carlo call of kTrialsPerIter
+  // trials; items are trials, evaluations are the hero's hand plus one per
+  // opponent at each showdown.
+  for (int board : {0, 3, 4, 5}) {
+    for (int opp = 1; opp <= 8; ++opp) {
+      std::string name = "monte_carlo/board:" + std::to_string(board) + "/opponents:" + std::to_string(opp);
+      benches.push_back({name, [board, opp](std::uint64_t iters) {
+        auto b = board_of_size(board);
+        std::uint64_t acc = 0;
+        for (std::uint64_t i = 0; i < iters; ++i)
+          acc += poker_sim::run_monte_carlo(kHero, b, opp, kTrialsPerIter, static_cast<unsigned>(i + 1)).wins;
+        g_sink += acc;
+        return iters * kTrialsPerIter;
+      }, {{"evaluations_per_second", (opp + 1.0) * kTrialsPerIter}}});
+    }
+  }
+
+  // Range path: "random" is the same deal distribution as monte_carlo/ above,
+  // so the pair measures alias sampling + rejection against the plain shuffle.
+  // Eight copies of the narrow range almost never fit together; it stops at 3.
+  for (const char* range : {"random", "TT+,AQs+,KQo"}) {
+    for (int board : {0, 3, 5}) {
+      for (int opp : {1, 3, 8}) {
+        if (opp == 8 && std::strcmp(range, "random") != 0) continue;
+        std::string name = std::string("monte_carlo_range/") + range + "/board:" + std::to_string(board) +
+                           "/opponents:" + std::to_string(opp);
+        benches.push_back({name, [range, board, opp](std::uint64_t iters) {
+          auto b = board_of_size(board);
+          std::vector<poker_sim::HandRange> ranges(opp, poker_sim::HandRange::parse(range));
+          std::uint64_t acc = 0;
+          for (std::uint64_t i = 0; i < iters; ++i)
+            acc += poker_sim::run_monte_carlo_ranges(kHero, b, ranges, kTrialsPerIter,
+                                                     static_cast<unsigned>(i + 1)).wins;
+          g_sink += acc;
+          return iters * kTrialsPerIter;
+        }, {{"evaluations_per_second", (opp + 1.0) * kTrialsPerIter}}});
+      }
+    }
+  }
+
+  // Known-hands all-in: preflop samples the default 20000 runouts, later
+  // streets enumerate. One iteration is one multiway_equity call.
+  for (int board : {0, 3, 4}) {
+    for (int players : {2, 6, 9}) {
+      std::string name = "multiway/board:" + std::to_string(board) + "/players:" + std::to_string(players);
+      benches.push_back({name, [board, players](std::uint64_t iters) {
+        // Club/diamond pocket pairs, clear of the hero's cards and the board.
+        static const std::vector<std::vector<uint8_t>> pairs = {
+            {12, 25}, {11, 24}, {10, 23}, {9, 22}, {6, 19}, {5, 18}, {3, 16}, {1, 14}};
+        std::vector<std::vector<uint8_t>> hands = {kHero};
+        hands.insert(hands.end(), pairs.begin(), pairs.begin() + (players - 1));
+        auto b = board_of_size(board);
+        std::uint64_t acc = 0;
+        for (std::uint64_t i = 0; i < iters; ++i)
+          acc += poker_sim::multiway_equity(hands, b, 0, 20000, static_cast<unsigned>(i + 1)).runouts;
+        g_sink += acc;
+        return iters;
+      }, {}});
+    }
+  }
+
+  // Outs: one analyze_outs call (every next card) on one thread.
+  for (int board : {3, 4}) {
+    std::string name = "outs/board:" + std::to_string(board);
+    benches.push_back({name, [board](std::uint64_t iters) {
+      auto b = board_of_size(board);
+      const auto full = poker_sim::HandRange::full();
+      std::uint64_t acc = 0;
+      for (std::uint64_t i = 0; i < iters; ++i) acc += poker_sim::analyze_outs(kHero, b, full, 0, 1).outs;
+      g_sink += acc;
+      return iters;
+    }, {}});
+  }
+
+  // Hand strength/potential: one uncached hand_strength call (the cache is
+  // cleared first), so this is the cost of a fresh spot.
+  for (int board : {3, 4, 5}) {
+    std::string name = "hand_strength/board:" + std::to_string(board);
+    benches.push_back({name, [board](std::uint64_t iters) {
+      auto b = board_of_size(board);
+      double acc = 0;
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        poker_sim::clear_hand_strength_cache();
+        acc += poker_sim::hand_strength(kHero, b).ehs;
+      }
+      g_sink += static_cast<std::uint64_t>(acc);
+      return iters;
+    }, {}});
+  }
+
+  // Equity histogram against a random hand: one exact pass over every runout.
+  for (int board : {3, 4}) {
+    std::string name = "equity_histogram/board:" + std::to_string(board);
+    benches.push_back({name, [board](std::uint64_t iters) {
+      auto b = board_of_size(board);
+      const auto full = poker_sim::HandRange::full();
+      double acc = 0;
+      for (std::uint64_t i = 0; i < iters; ++i) acc += poker_sim::equity_histogram(kHero, b, full).equity;
+      g_sink += static_cast<std::uint64_t>(acc);
+      return iters;
+    }, {}});
+  }
+
+  // Exact range vs range: one iteration scores every runout; items are runouts.
+  for (int board : {3, 4, 5}) {
+    std::string name = "range_equity/random-vs-random/board:" + std::to_string(board);
+    benches.push_back({name, [board](std::uint64_t iters) {
+      auto b = board_of_size(board);
+      const auto full = poker_sim::HandRange::full();
+      std::uint64_t runouts = 0;
+      for (std::uint64_t i = 0; i < iters; ++i)
+        runouts += poker_sim::range_vs_range_equity(full, full, b).runouts;
+      g_sink += runouts;
+      return runouts;
+    }, {}});
+  }
+
+  // Thread scaling: N concurrent run_monte_carlo calls (one per worker, as
+  // under several API workers). Ideal scaling keeps per-thread trials/sec flat.
+  unsigned max_threads = poker_sim::default_thread_count();
+  std::vector<unsigned> counts;
+  for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+  counts.push_back(max_threads);
+  for (unsigned threads : counts) {
+    std::string name = "threads/monte_carlo/board:3/opponents:3/threads:" + std::to_string(threads);
+    benches.push_back({name, [threads](std::uint64_t iters) {
+      auto b = board_of_size(3);
+      poker_sim::parallel_for(threads, threads, [&](std::size_t t) {
+        std::uint64_t acc = 0;
+        for (std::uint64_t i = 0; i < iters; ++i)
+          acc += poker_sim::run_monte_carlo(kHero, b, 3, kTrialsPerIter,
+                                            static_cast<unsigned>(t * iters + i + 1)).wins;
+        g_sink += acc;
+      });
+      return iters * kTrialsPerIter * threads;
+    }, {{"trials_per_second_per_thread", static_cast<double>(kTrialsPerIter)}}});
+  }
+  return benches;
+}
+
+void write_json(std::FILE* f, const std::vector<Result>& results) {
+  poker_sim_bench::write_json_context(f);
+  std::fprintf(f, "  \"benchmarks\": [\n");
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    std::fprintf(f, "    {\n");
+    std::fprintf(f, "      \"name\": \"%s\",\n", poker_sim_bench::json_escape(r.name).c_str());
+    std::fprintf(f, "      \"run_name\": \"%s\",\n", poker_sim_bench::json_escape(r.name).c_str());
+    std::fprintf(f, "      \"run_type\": \"iteration\",\n");
+    std::fprintf(f, "      \"iterations\": %llu,\n", static_cast<unsigned long long>(r.iterations));
+    std::fprintf(f, "      \"real_time\": %.3f,\n", r.real_ns);
+    std::fprintf(f, "      \"cpu_time\": %.3f,\n", r.cpu_ns);
+    std::fprintf(f, "      \"time_unit\": \"ns\",\n");
+    for (const auto& c : r.counters)
+      std::fprintf(f, "      \"%s\": %.6e,\n", poker_sim_bench::json_escape(c.first).c_str(), c.second);
+    std::fprintf(f, "      \"items_per_second\": %.6e\n", r.items_per_second);
+    std::fprintf(f, "    }%s\n", i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(f, "  ]\n}\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string filter, out_path;
+  double min_time = 0.2;
+  bool json = false, accuracy = false;
+  int repeats = 16;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+      min_time = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--json")) {
+      json = true;
+    } else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) {
+      out_path = argv[++i];
+    } else if (!std::strcmp(argv[i], "--accuracy")) {
+      accuracy = true;
+    } else if (!std::strcmp(argv[i], "--repeats") && i + 1 < argc) {
+      repeats = std::atoi(argv[++i]);
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--filter SUBSTR] [--min-time SEC] [--json] [--out FILE]"
+                   " [--accuracy [--repeats N]]\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+
+  if (accuracy) {
+    poker_sim_bench::AccuracyOptions opts;
+    opts.filter = filter;
+    opts.repeats = repeats;
+    opts.json = json;
+    opts.out_path = out_path;
+    return poker_sim_bench::run_accuracy(opts);
+  }
+
+  std::vector<Result> results;
+  if (!json) std::printf("%-56s %14s %14s %12s\n", "Benchmark", "Time/iter", "Iterations", "items/s");
+  for (const Benchmark& b : make_benchmarks()) {
+    if (!filter.empty() && b.name.find(filter) == std::string::npos) continue;
+    Result r = run(b, min_time);
+    if (!json) {
+      std::printf("%-56s %11.0f ns %14llu %11.3gM", r.name.c_str(), r.real_ns,
+                  static_cast<unsigned long long>(r.iterations), r.items_per_second / 1e6);
+      for (const auto& c : r.counters) std::printf("  %s=%.3gM", c.first.c_str(), c.second / 1e6);
+      std::printf("\n");
+      std::fflush(stdout);
+    }
+    results.push_back(std::move(r));
+  }
+
+  if (json) write_json(stdout, results);
+  if (!out_path.empty()) {
+    std::FILE* f = std::fopen(out_path.c_str(), "w");
+    if (!f) {
+      std::fprintf(stderr, "cannot write %s\n", out_path.c_str());
+      return 1;
+    }
+    write_json(f, results);
+    std::fclose(f);
+  }
+  return 0;
+}
@@ -0,0 +1,51 @@
+// Helpers shared by the poker_sim_bench modes.
+
+#ifndef POKER_SIM_BENCH_UTIL_HPP
+#define POKER_SIM_BENCH_UTIL_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace poker_sim_bench {
+
+inline std::string json_escape(const std::string& s) {
+  std::string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out;
+}
+
+/// Writes the opening brace and the Google Benchmark-style "context" object.
+inline void write_json_context(std::FILE* f) {
+  char date[64];
+  std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof date, "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  std::fprintf(f, "{\n  \"context\": {\n");
+  std::fprintf(f, "    \"date\": \"%s\",\n", date);
+  std::fprintf(f, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+#ifdef NDEBUG
+  std::fprintf(f, "    \"library_build_type\": \"release\"\n");
+#else
+  std::fprintf(f, "    \"library_build_type\": \"debug\"\n");
+#endif
+  std::fprintf(f, "  },\n");
+}
+
+/// Parses "AhKd..." (rank 23456789TJQKA, suit cdhs) into card indices.
+inline std::vector<uint8_t> parse_cards(const std::string& s) {
+  static const std::string ranks = "23456789TJQKA", suits = "cdhs";
+  std::vector<uint8_t> out;
+  for (std::size_t i = 0; i + 1 < s.size(); i += 2)
+    out.push_back(static_cast<uint8_t>(suits.find(s[i + 1]) * 13 + ranks.find(s[i])));
+  return out;
+}
+
+}  // namespace poker_sim_bench
+
+#endif
@@ -0,0 +1,215 @@
+// Exhaustive evaluator verification: enumerates every 5-card and 7-card hand,
+// checks category frequencies against the known totals, cross-checks every
+// backend against the first one selected, and reports hands/sec per backend.
+//
+// Usage: poker_sim_verify_eval [--threads N] [--backend NAME]... [--five-only] [--seven-only]
+
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/parallel.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using poker_sim::HandRank;
+
+namespace {
+
+struct Backend {
+  const char* name;
+  HandRank (*eval)(const uint8_t*, int);
+};
+
+const Backend kBackends[] = {
+  {"bitmask", poker_sim::evaluate_hand},
+  {"reference", poker_sim::evaluate_hand_reference},
+};
+
+const char* const kCategoryNames[9] = {
+  "high card", "one pair", "two pair", "three of a kind", "straight",
+  "flush", "full house", "four of a kind", "straight flush",
+};
+
+const std::array<std::uint64_t, 9> kExpected5 = {
+  1302540, 1098240, 123552, 54912, 10200, 5108, 3744, 624, 40,
+};
+const std::array<std::uint64_t, 9> kExpected7 = {
+  23294460, 58627800, 31433400, 6461620, 6180020, 4047644, 3473184, 224848, 41584,
+};
+
+/// Work is split by the two lowest cards; each chunk enumerates the rest.
+struct Chunk { uint8_t c0, c1; };
+
+std::vector<Chunk> make_chunks() {
+  std::vector<Chunk> chunks;
+  for (int a = 0; a < 52; ++a)
+    for (int b = a + 1; b < 52; ++b)
+      chunks.push_back({static_cast<uint8_t>(a), static_cast<uint8_t>(b)});
+  return chunks;
+}
+
+template <int Depth, int N, typename F>
+void for_each_suffix(uint8_t* hand, int start, F& f) {
+  if constexpr (Depth == N) {
+    f(hand);
+  } else {
+    for (int c = start; c <= 52 - (N - Depth); ++c) {
+      hand[Depth] = static_cast<uint8_t>(c);
+      for_each_suffix<Depth + 1, N>(hand, c + 1, f);
+    }
+  }
+}
+
+/// Enumerates every n-card hand (n = 5 or 7) whose two lowest cards are the chunk's.
+template <typename F>
+void for_each_hand(int n, const Chunk& chunk, F& f) {
+  uint8_t hand[7] = {chunk.c0, chunk.c1};
+  if (n == 5) for_each_suffix<2, 5>(hand, chunk.c1 + 1, f);
+  else for_each_suffix<2, 7>(hand, chunk.c1 + 1, f);
+}
+
+inline std::uint64_t mix(std::uint64_t h, std::uint64_t v) {
+  return (h ^ v) * 1099511628211ull;
+}
+
+struct PassResult {
+  std::array<std::uint64_t, 9> freq{};
+  std::vector<std::uint64_t> chunk_digest;
+  std::uint64_t hands = 0;
+  double seconds = 0;
+
+  std::uint64_t digest() const {
+    std::uint64_t h = 14695981039346656037ull;
+    for (std::uint64_t d : chunk_digest) h = mix(h, d);
+    return h;
+  }
+};
+
+PassResult run_pass(const Backend& be, int n, const std::vector<Chunk>& chunks, unsigned threads) {
+  PassResult res;
+  res.chunk_digest.assign(chunks.size(), 0);
+  std::vector<std::array<std::uint64_t, 9>> chunk_freq(chunks.size());
+
+  auto t0 = std::chrono::steady_clock::now();
+  poker_sim::parallel_for(chunks.size(), threads, [&](std::size_t i) {
+    std::array<std::uint64_t, 9> freq{};
+    std::uint64_t h = 14695981039346656037ull;
+    auto visit = [&](const uint8_t* hand) {
+      HandRank r = be.eval(hand, n);
+      ++freq[poker_sim::hand_category(r)];
+      h = mix(h, r);
+    };
+    for_each_hand(n, chunks[i], visit);
+    chunk_freq[i] = freq;
+    res.chunk_digest[i] = h;
+  });
+  res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  for (const auto& f : chunk_freq)
+    for (int k = 0; k < 9; ++k) res.freq[k] += f[k];
+  for (std::uint64_t f : res.freq) res.hands += f;
+  return res;
+}
+
+std::string card_name(uint8_t c) {
+  static const char* ranks = "23456789TJQKA";
+  static const char* suits = "cdhs";
+  return std::string{ranks[poker_sim::card_rank(c)], suits[poker_sim::card_suit(c)]};
+}
+
+/// Re-enumerates the first differing chunk and prints the disagreeing hands.
+void report_mismatch(const Backend& a, const Backend& b, int n, const Chunk& chunk) {
+  int shown = 0;
+  auto visit = [&](const uint8_t* hand) {
+    HandRank ra = a.eval(hand, n), rb = b.eval(hand, n);
+    if (ra == rb || shown >= 5) return;
+    std::string cards;
+    for (int i = 0; i < n; ++i) cards += card_name(hand[i]) + " ";
+    std::printf("    %s: %s=0x%06x %s=0x%06x\n", cards.c_str(), a.name, ra, b.name, rb);
+    ++shown;
+  };
+  for_each_hand(n, chunk, visit);
+}
+
+bool verify(int n, const std::vector<const Backend*>& backends, unsigned threads) {
+  const auto& expected = n == 5 ? kExpected5 : kExpected7;
+  const auto chunks = make_chunks();
+  bool ok = true;
+  std::vector<PassResult> results;
+
+  for (const Backend* be : backends) {
+    PassResult res = run_pass(*be, n, chunks, threads);
+    bool freq_ok = res.freq == expected;
+    std::printf("%d-card  %-10s %11llu hands  %8.3f s  %8.2f M hands/s  freq %s  digest %016llx\n",
+                n, be->name, static_cast<unsigned long long>(res.hands), res.seconds,
+                res.hands / res.seconds / 1e6, freq_ok ? "OK" : "MISMATCH",
+                static_cast<unsigned long long>(res.digest()));
+    if (!freq_ok) {
+      ok = false;
+      for (int k = 0; k < 9; ++k)
+        if (res.freq[k] != expected[k])
+          std::printf("    %-16s got %llu, expected %llu\n", kCategoryNames[k],
+                      static_cast<unsigned long long>(res.freq[k]),
+                      static_cast<unsigned long long>(expected[k]));
+    }
+    if (!results.empty() && res.digest() != results[0].digest()) {
+      ok = false;
+      std::printf("    ranks differ from %s\n", backends[0]->name);
+      for (std::size_t i = 0; i < chunks.size(); ++i) {
+        if (res.chunk_digest[i] != results[0].chunk_digest[i]) {
+          report_mismatch(*backends[0], *be, n, chunks[i]);
+          break;
+        }
+      }
+    }
+    results.push_back(std::move(res));
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned threads = 0;
+  bool five = true, seven = true;
+  std::vector<const Backend*> backends;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else if (!std::strcmp(argv[i], "--backend") && i + 1 < argc) {
+      const char* name = argv[++i];
+      const Backend* found = nullptr;
+      for (const Backend& be : kBackends)
+        if (!std::strcmp(be.name, name)) found = &be;
+      if (!found) {
+        std::fprintf(stderr, "unknown backend: %s\n", name);
+        return 2;
+      }
+      backends.push_back(found);
+    } else if (!std::strcmp(argv[i], "--five-only")) {
+      seven = false;
+    } else if (!std::strcmp(argv[i], "--seven-only")) {
+      five = false;
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--threads N] [--backend NAME]... [--five-only] [--seven-only]\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+  if (backends.empty())
+    for (const Backend& be : kBackends) backends.push_back(&be);
+
+  std::printf("threads: %u\n", threads ? threads : poker_sim::default_thread_count());
+  bool ok = true;
+  if (five) ok = verify(5, backends, threads) && ok;
+  if (seven) ok = verify(7, backends, threads) && ok;
+  std::printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
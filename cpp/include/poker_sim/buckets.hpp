@@ -0,0 +1,78 @@
+#ifndef POKER_SIM_BUCKETS_HPP
+#define POKER_SIM_BUCKETS_HPP
+
+#include "poker_sim/hand_index.hpp"
+#include "poker_sim/table_file.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace poker_sim {
+
+/// Equity-distribution features of every canonical (hole, flop) pair, in
+/// HandIndexer({2, 3}) order: for each pair, the cumulative histogram of its
+/// river hand strength over the 1081 runouts (see flop_strength_histograms).
+struct FlopFeatures {
+  unsigned bins = 0;
+  std::vector<std::uint16_t> cumulative;  // size() x bins; last column is 1081
+  std::vector<double> weights;            // raw (hole, flop) deals in each class
+  std::uint64_t size() const { return weights.size(); }
+};
+
+/// Computes FlopFeatures over the 1755 canonical flops, spread over worker
+/// threads (0 = default). Throws std::invalid_argument for bins outside 1-100.
+FlopFeatures compute_flop_features(unsigned bins = 50, unsigned num_threads = 0);
+
+struct Clustering {
+  std::vector<std::uint16_t> assignment;  // bucket of each point
+  std::vector<float> centroids;           // buckets x bins, cumulative fractions
+  unsigned iterations = 0;                // Lloyd iterations run
+  double inertia = 0;                     // weighted mean squared distance to the centroid
+};
+
+/// Weighted k-means over the cumulative histograms. Squared L2 between CDFs
+/// stands in for the earth mover's distance (L1 between CDFs in one
+/// dimension) so centroids remain plain means. Seeded by k-means++ on a
+/// sample; stops after `iterations` rounds or when no point moves. The
+/// result depends only on the seed, not on the thread count.
+Clustering cluster_features(const FlopFeatures& features,
+                            unsigned buckets = 200,
+                            unsigned iterations = 50,
+                            unsigned seed = 0,
+                            unsigned num_threads = 0);
+
+/// Writes bucket assignments for an indexer's classes as a TableKind::BUCKETS
+/// table file: section "buckets" holds one uint16 per class in index order,
+/// params[0] the bucket count. Throws std::runtime_error on I/O failure.
+void write_bucket_file(const std::string& path,
+                       const std::vector<int>& cards_per_round,
+                       const std::vector<std::uint16_t>& assignment,
+                       unsigned buckets,
+                       bool compress = false);
+
+/// Read-only view of a bucket file.
+class BucketTable {
+ public:
+  /// Throws std::runtime_error if the file is missing or malformed.
+  explicit BucketTable(const std::string& path);
+
+  std::uint64_t size() const { return entries_; }
+  unsigned buckets() const { return buckets_; }
+  const HandIndexer& indexer() const { return indexer_; }
+  const TableFile& file() const { return file_; }
+
+  std::uint16_t operator[](std::uint64_t index) const { return data_[index]; }
+  /// Bucket of a deal given round by round (hole cards, then the board).
+  std::uint16_t bucket(const uint8_t* cards) const { return data_[indexer_.index(cards)]; }
+
+ private:
+  TableFile file_;
+  HandIndexer indexer_;
+  const std::uint16_t* data_ = nullptr;
+  std::uint64_t entries_ = 0;
+  unsigned buckets_ = 0;
+};
+
+}  // namespace poker_sim
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef POKER_SIM_EQUITY_GRID_HPP
+#define POKER_SIM_EQUITY_GRID_HPP
+
+#include "poker_sim/range.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace poker_sim {
+
+/// Random opponent deals each runout is scored against with 2+ opponents.
+constexpr int kGridOpponentDeals = 8;
+
+/// Equity of every starting-hand class on one board against random hands.
+struct EquityGrid {
+  /// Mean equity (pot share, splits shared 1/k) of each class's live
+  /// holdings, in preflop_class order; 0 where the board and dead cards
+  /// block every holding of the class.
+  std::array<double, kNumPreflopClasses> equity{};
+  std::array<int, kNumPreflopClasses> holdings{};  // live holdings per class
+  /// True when every runout and opponent deal is counted (heads-up with
+  /// enumerated runouts, or read from a precomputed table).
+  bool exact = false;
+  std::uint64_t runouts = 0;  // board completions evaluated
+};
+
+/// Scores all 169 classes together: each runout ranks every live holding once
+/// and every holding is scored from that ranking. Heads-up, holdings are swept
+/// in strength order against every opponent holding, with blocked holdings
+/// subtracted per card; against 2-8 opponents each runout draws
+/// kGridOpponentDeals opponent deals that every unblocked holding is compared
+/// with. Runouts are enumerated when there are at most num_trials of them
+/// (every flop, turn and river) and sampled otherwise. With no dead cards,
+/// preflop heads-up is read from the preflop matrix and flops against 1-3
+/// opponents from the flop equity table when they are loaded. Work is split
+/// into fixed chunks with their own random streams, so the result does not
+/// depend on num_threads (0 = default). Throws std::invalid_argument.
+EquityGrid equity_grid(const std::vector<uint8_t>& board,
+                       int num_opponents = 1,
+                       std::uint32_t num_trials = 2000,
+                       unsigned seed = 0,
+                       std::uint64_t dead_mask = 0,
+                       unsigned num_threads = 0);
+
+}  // namespace poker_sim
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef POKER_SIM_FLOP_EQUITY_HPP
+#define POKER_SIM_FLOP_EQUITY_HPP
+
+#include "poker_sim/table_file.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace poker_sim {
+
+/// Opponent counts covered by the flop equity table.
+constexpr int kFlopEquityMaxOpponents = 3;
+
+/// Stored values per (hole, flop) class: one outcome distribution per
+/// opponent count, 2 + 3 + 4 of them.
+constexpr int kFlopEquityValues = 9;
+
+/// Exact showdown distribution of a hole-card pair on a flop against 1-3
+/// uniformly random opponent hands, over every runout and deal.
+struct FlopOutcome {
+  int opponents = 0;
+  /// ways[j]: P(no opponent is ahead and exactly j tie the hero), i.e. the
+  /// pot goes to the hero alone (j = 0) or splits j + 1 ways.
+  std::array<double, kFlopEquityMaxOpponents + 1> ways{};
+  /// Deals behind the distribution: runouts x opponent holdings.
+  double deals = 0;
+
+  double win() const { return ways[0]; }
+  double equity() const {
+    double e = 0;
+    for (int j = 0; j <= opponents; ++j) e += ways[j] / (j + 1);
+    return e;
+  }
+};
+
+/// Computes the table: kFlopEquityValues probabilities, scaled to 0-65535,
+/// for each of the 1,286,792 classes of street_indexer(Street::FLOP), in
+/// index order. Each class is exact over all 1081 runouts and every deal of
+/// the opponents' hands. Works over the 134,459 suit-canonical river boards
+/// on worker threads (0 = default); the result does not depend on the
+/// thread count.
+std::vector<std::uint16_t> compute_flop_equity(unsigned num_threads = 0);
+
+/// Writes compute_flop_equity output as a TableKind::FLOP_EQUITY table file
+/// (section "outcomes"). Throws std::invalid_argument on a wrong size,
+/// std::runtime_error on I/O failure.
+void write_flop_equity_file(const std::string& path,
+                            const std::vector<std::uint16_t>& values,
+                            bool compress = false);
+
+/// Read-only view of a flop equity file.
+class FlopEquityTable {
+ public:
+  /// Throws std::runtime_error if the file is missing or malformed.
+  explicit FlopEquityTable(const std::string& path);
+
+  const TableFile& file() const { return file_; }
+
+  /// Outcome of hole_cards (2) on flop (3) against 1-3 opponents. Throws
+  /// std::invalid_argument on bad input.
+  FlopOutcome lookup(const std::vector<uint8_t>& hole_cards,
+                     const std::vector<uint8_t>& flop,
+                     int num_opponents) const;
+
+ private:
+  TableFile file_;
+  const std::uint16_t* data_ = nullptr;
+};
+
+/// Maps the table run_monte_carlo answers flop spots from (1-3 opponents, no
+/// dead cards); an empty path unloads it. Throws like FlopEquityTable.
+void load_flop_equity_table(const std::string& path);
+
+/// The loaded table, or null.
+std::shared_ptr<const FlopEquityTable> flop_equity_table();
+
+}  // namespace poker_sim
+
+#endif
@@ -13,6 +13,47 @@ constexpr int HIGH_CARD = 0, ONE_PAIR = 1, TWO_PAIR = 2, THREE_KIND = 3,
 inline int card_rank(uint8_t c) { return c % 13; }
 inline int card_suit(uint8_t c) { return c / 13; }
 
+/// Bit c set for every card c (0-51) in the list.
+inline std::uint64_t card_mask(const std::vector<uint8_t>& cards) {
+  std::uint64_t m = 0;
+  for (uint8_t c : cards) m |= 1ull << c;
+  return m;
+}
+
+/// Packed strength of the best 5-card hand: category in bits 20-23, then five
+/// 4-bit tiebreak ranks (most significant first). Higher value = stronger hand.
+using HandRank = std::uint32_t;
+
+inline int hand_category(HandRank r) { return static_cast<int>(r >> 20); }
+
+/// Rank multiplicity and suit masks of a partial hand, built one card at a
+/// time. Many completions of the same cards (e.g. every holding on a board)
+/// copy a state holding the shared cards and add only their own.
+class HandState {
+ public:
+  void add(uint8_t c) {
+    const std::uint32_t bit = 1u << card_rank(c);
+    int k = 0;
+    while (k < 3 && (by_count_[k] & bit)) ++k;
+    by_count_[k] |= bit;
+    suit_mask_[card_suit(c)] |= bit;
+  }
+
+  /// Strength of the best 5-card hand of the 5-7 cards added.
+  HandRank rank() const;
+
+ private:
+  std::uint32_t by_count_[4] = {0, 0, 0, 0};  // ranks held at least k + 1 times
+  std::uint32_t suit_mask_[4] = {0, 0, 0, 0};
+};
+
+/// Bitmask evaluator for 5-7 cards.
+HandRank evaluate_hand(const uint8_t* cards, int n);
+
+/// Original combinatorial evaluator (best of all 5-card subsets), kept as the
+/// reference backend for verification.
+HandRank evaluate_hand_reference(const uint8_t* cards, int n);
+
 /// Compare two 7-card hands. Returns 1 if h1 wins, -1 if h2 wins, 0 if tie.
 int compare_hands(const std::vector<uint8_t>& h1, const std::vector<uint8_t>& h2);
 
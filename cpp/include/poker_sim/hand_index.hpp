@@ -0,0 +1,80 @@
+#ifndef POKER_SIM_HAND_INDEX_HPP
+#define POKER_SIM_HAND_INDEX_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace poker_sim {
+
+/// Perfect index of the suit-isomorphism classes of a deal split into rounds
+/// (Waugh, "A Fast and Optimal Hand Isomorphism Algorithm"). Rounds {2, 3}
+/// index hole cards + flop: 1,286,792 classes, numbered 0..size()-1. Cards
+/// are unordered within a round but not across rounds, and two deals get the
+/// same index exactly when a relabelling of suits maps one onto the other.
+class HandIndexer {
+ public:
+  /// 1-4 rounds, 1-7 cards each and 13 cards at most in total (any suit
+  /// can then hold all of them). Throws std::invalid_argument.
+  explicit HandIndexer(std::vector<int> cards_per_round);
+
+  std::uint64_t size() const { return size_; }
+  int rounds() const { return static_cast<int>(cards_per_round_.size()); }
+  int total_cards() const { return total_cards_; }
+
+  /// Index of cards[0..total_cards()), listed round by round.
+  std::uint64_t index(const uint8_t* cards) const;
+
+  /// Writes the canonical member of class `index` (< size()) to cards.
+  void unindex(std::uint64_t index, uint8_t* cards) const;
+
+ private:
+  /// A suit's card count in each round, as a base-14 code.
+  struct Shape {
+    int code;
+    std::uint64_t size;  // rank assignments with this shape
+  };
+  /// Sorted multiset of the four suits' shapes, with its index range.
+  struct Configuration {
+    std::array<int, 4> shapes;  // shape ids, largest code first
+    std::uint64_t offset;
+  };
+  /// Per-suit count vector -> configuration and the suit order that sorts it.
+  struct CountEntry {
+    std::int32_t configuration = -1;
+    std::array<uint8_t, 4> order{};
+  };
+
+  std::size_t count_key(const int counts[][4]) const;
+
+  std::vector<int> cards_per_round_;
+  int total_cards_ = 0;
+  std::vector<Shape> shapes_;
+  std::vector<Configuration> configurations_;
+  std::vector<CountEntry> by_counts_;
+  std::uint64_t size_ = 0;
+};
+
+/// Betting rounds, by board size 0, 3, 4, 5.
+enum class Street { PREFLOP, FLOP, TURN, RIVER };
+
+/// Shared indexer over (hole cards, board) for a street, with the board as
+/// one round: 169, 1,286,792, 13,960,050 and 123,156,254 classes. Built on
+/// first use; safe to call from any thread.
+const HandIndexer& street_indexer(Street street);
+
+/// Street of a board of 0, 3, 4 or 5 cards. Throws std::invalid_argument.
+Street street_of_board(std::size_t board_size);
+
+/// Class of (hole_cards, board) on its street. Throws std::invalid_argument
+/// on a bad or repeated card.
+std::uint64_t street_index(const std::vector<uint8_t>& hole_cards, const std::vector<uint8_t>& board);
+
+/// Canonical (hole_cards, board) of a class. Throws std::invalid_argument.
+std::pair<std::vector<uint8_t>, std::vector<uint8_t>> street_unindex(Street street, std::uint64_t index);
+
+}  // namespace poker_sim
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef POKER_SIM_HAND_STRENGTH_HPP
+#define POKER_SIM_HAND_STRENGTH_HPP
+
+#include "poker_sim/range.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace poker_sim {
+
+/// Flop runouts (turn + river pairs) sampled by default; a flop has at most 1081.
+constexpr unsigned kDefaultFlopRunouts = 256;
+
+/// Hand strength and potential of a hole-card pair against one uniformly
+/// random opponent holding (Billings et al.; EHS^2 after Johanson).
+struct HandStrength {
+  double hs = 0;    // share of holdings beaten now, ties half
+  double ppot = 0;  // P(behind or tied now -> ahead at the river)
+  double npot = 0;  // P(ahead or tied now -> behind at the river)
+  double ehs = 0;   // hs * (1 - npot) + (1 - hs) * ppot
+  double ehs2 = 0;  // mean over runouts of the river hand strength squared
+  double equity = 0;  // mean river hand strength (equity against a random hand)
+  std::uint32_t runouts = 0;  // runouts enumerated or sampled (0 on the river)
+  bool exact = false;
+};
+
+/// Strength of hole_cards (2) on a board of 3-5 cards, dead_mask cards out
+/// of play. Turn and river are enumerated exactly; a flop samples
+/// flop_runouts distinct runouts (exact when that covers them all) with a
+/// fixed seed. Results are cached process-wide under the suit-canonical
+/// form of (hole, board, dead cards), so isomorphic spots cost one
+/// computation. Throws std::invalid_argument.
+HandStrength hand_strength(const std::vector<uint8_t>& hole_cards,
+                           const std::vector<uint8_t>& board,
+                           std::uint64_t dead_mask = 0,
+                           unsigned flop_runouts = kDefaultFlopRunouts,
+                           unsigned seed = 0);
+
+struct HandSpot {
+  std::vector<uint8_t> hole_cards;
+  std::vector<uint8_t> board;
+};
+
+/// hand_strength for each spot, spread over worker threads (0 = default).
+std::vector<HandStrength> hand_strength_batch(const std::vector<HandSpot>& spots,
+                                              std::uint64_t dead_mask = 0,
+                                              unsigned flop_runouts = kDefaultFlopRunouts,
+                                              unsigned seed = 0,
+                                              unsigned num_threads = 0);
+
+/// How the hero's equity against a range is spread over the coming cards.
+struct EquityHistogram {
+  double equity = 0;  // mean equity (weighted pot share at showdown)
+  /// Fraction of next cards after which the hero's equity lands in each of
+  /// the equal-width bins over [0, 1].
+  std::vector<double> next_card;
+  /// Flop only: the same over complete (turn, river) runouts.
+  std::vector<double> next_two_cards;
+  std::uint32_t runouts = 0;  // complete boards scored
+};
+
+/// Exact equity histogram of hole_cards against opponent_range on a flop (3)
+/// or turn (4), with `bins` bins (1-100). The mean comes from the same pass.
+/// On the flop every unordered runout is scored once and reused by both of
+/// its turn cards, so the cost is that of one exact flop equity query.
+/// Throws std::invalid_argument.
+EquityHistogram equity_histogram(const std::vector<uint8_t>& hole_cards,
+                                 const std::vector<uint8_t>& board,
+                                 const HandRange& opponent_range,
+                                 std::uint64_t dead_mask = 0,
+                                 unsigned bins = 10);
+
+/// River hand-strength histograms of every holding on a flop: for each
+/// (turn, river) runout the holding's share of the 990 possible opponent
+/// holdings beaten (ties half) goes into one of `bins` equal bins over
+/// [0, 1]. out has kNumCombos rows of `bins` counts, by combo_index; rows of
+/// holdings touching the flop stay zero, the others sum to 1081. One sorted
+/// sweep per runout serves all holdings at once. Throws std::invalid_argument.
+void flop_strength_histograms(const std::vector<uint8_t>& flop, unsigned bins, std::uint16_t* out);
+
+/// Entries in the hand_strength cache, and a way to empty it.
+std::size_t hand_strength_cache_size();
+void clear_hand_strength_cache();
+
+}  // namespace poker_sim
+
+#endif
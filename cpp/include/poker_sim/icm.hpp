@@ -0,0 +1,41 @@
+#ifndef POKER_SIM_ICM_HPP
+#define POKER_SIM_ICM_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace poker_sim {
+
+/// Most players with chips icm_equity solves exactly; larger fields are sampled.
+constexpr int kIcmMaxExactPlayers = 20;
+
+/// Prize equity of each player under the independent chip model.
+struct IcmEquity {
+  std::vector<double> equity;  // per player, in payout units
+  bool exact = false;
+  std::uint64_t trials = 0;  // finishing orders sampled; 0 when exact
+};
+
+/// Malmuth-Harville ICM: each place goes to a remaining player with
+/// probability proportional to their stack. payouts[k] is the prize for
+/// place k + 1; places past the field are ignored. Players with no chips take
+/// the places below everyone with chips and share their prizes evenly.
+///
+/// Up to kIcmMaxExactPlayers players with chips, the place probabilities come
+/// from a DP over the subsets of players already placed, each subset's
+/// probability computed once and reused by every ordering that reaches it,
+/// only as deep as the paid places. Larger fields sample num_trials finishing
+/// orders down to the last paid place, drawing each place by stack from a
+/// Fenwick tree of the players left (O(places log n) per order). Sampling is
+/// split into fixed chunks with their own random streams, so the result does
+/// not depend on num_threads (0 = default). Throws std::invalid_argument on
+/// negative stacks or payouts, no chips at all, or num_trials = 0.
+IcmEquity icm_equity(const std::vector<double>& stacks,
+                     const std::vector<double>& payouts,
+                     std::uint32_t num_trials = 20000,
+                     unsigned seed = 0,
+                     unsigned num_threads = 0);
+
+}  // namespace poker_sim
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef POKER_SIM_PARALLEL_HPP
+#define POKER_SIM_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace poker_sim {
+
+/// Worker count to use when the caller passes 0: hardware concurrency, at least 1.
+inline unsigned default_thread_count() {
+  unsigned n = std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+/// Calls fn(i) for every i in [0, n). Indices are handed out one at a time from
+/// a shared counter, so uneven work items balance across threads. fn must be
+/// safe to call concurrently for distinct i. num_threads = 0 means default.
+template <typename Fn>
+void parallel_for(std::size_t n, unsigned num_threads, Fn&& fn) {
+  if (num_threads == 0) num_threads = default_thread_count();
+  num_threads = static_cast<unsigned>(std::min<std::size_t>(num_threads, n));
+  if (num_threads <= 1) {
+    for (std::size_t i = 0; i < n; ++i) fn(i);
+    return;
+  }
+  std::atomic<std::size_t> next{0};
+  auto worker = [&]() {
+    for (std::size_t i = next++; i < n; i = next++) fn(i);
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (unsigned t = 1; t < num_threads; ++t) threads.emplace_back(worker);
+  worker();
+  for (auto& th : threads) th.join();
+}
+
+/// parallel_for on threads started once and kept for the pool's lifetime, for
+/// callers that fan out many small batches (a thread start per batch would
+/// dominate). The calling thread works too, so num_threads - 1 are started
+/// (0 = default). One run at a time; fn must not call run on the same pool.
+class WorkerPool {
+ public:
+  explicit WorkerPool(unsigned num_threads) {
+    if (num_threads == 0) num_threads = default_thread_count();
+    for (unsigned t = 1; t < num_threads; ++t) threads_.emplace_back([this] { serve(); });
+  }
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& th : threads_) th.join();
+  }
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /// Calls fn(i) for every i in [0, n) and returns once all calls are done.
+  template <typename Fn>
+  void run(std::size_t n, Fn&& fn) {
+    if (threads_.empty() || n <= 1) {
+      for (std::size_t i = 0; i < n; ++i) fn(i);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      call_ = [](void* f, std::size_t i) { (*static_cast<std::remove_reference_t<Fn>*>(f))(i); };
+      fn_ = const_cast<void*>(static_cast<const void*>(&fn));
+      n_ = n;
+      next_ = 0;
+      busy_ = threads_.size();
+      ++batch_;
+    }
+    wake_.notify_all();
+    work();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+  }
+
+ private:
+  void work() {
+    for (std::size_t i = next_++; i < n_; i = next_++) call_(fn_, i);
+  }
+
+  void serve() {
+    std::uint64_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&] { return stop_ || batch_ != seen; });
+        if (stop_) return;
+        seen = batch_;
+      }
+      work();
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--busy_ == 0) done_.notify_one();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_, done_;
+  void (*call_)(void*, std::size_t) = nullptr;
+  void* fn_ = nullptr;
+  std::size_t n_ = 0;
+  std::atomic<std::size_t> next_{0};
+  std::size_t busy_ = 0;     // workers still in the current batch
+  std::uint64_t batch_ = 0;  // bumped per run; workers wait for a new value
+  bool stop_ = false;
+};
+
+}  // namespace poker_sim
+
+#endif
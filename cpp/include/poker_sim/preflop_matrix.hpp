@@ -0,0 +1,86 @@
+#ifndef POKER_SIM_PREFLOP_MATRIX_HPP
+#define POKER_SIM_PREFLOP_MATRIX_HPP
+
+#include "poker_sim/range.hpp"
+#include "poker_sim/range_equity.hpp"
+#include "poker_sim/table_file.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace poker_sim {
+
+/// Boards of five cards from the 48 left beside two holdings.
+constexpr std::uint64_t kPreflopBoards = 1712304;
+
+/// Ordered pairs of disjoint holdings from classes i and j (preflop_class).
+int preflop_matchups(int i, int j);
+
+/// All-in result of class i against class j, over every pair of disjoint
+/// holdings and every board.
+struct PreflopMatchup {
+  double win = 0;
+  double tie = 0;
+  double matchups = 0;  // holding pairs, each dealt kPreflopBoards boards
+
+  double equity() const { return win + tie / 2; }
+};
+
+/// Computes the matrix: win then tie probability of each class against each
+/// class, 2 x 169 x 169 values in row-major (hero, villain) order. Exact over
+/// all boards; sweeps the 134,459 suit-canonical boards once, each weighted by
+/// the boards it stands for, on worker threads (0 = default). The result does
+/// not depend on the thread count.
+std::vector<float> compute_preflop_matrix(unsigned num_threads = 0);
+
+/// Writes compute_preflop_matrix output as a TableKind::PREFLOP_MATRIX table
+/// file (sections "win" and "tie"). Throws std::invalid_argument on a wrong
+/// size, std::runtime_error on I/O failure.
+void write_preflop_matrix_file(const std::string& path, const std::vector<float>& values, bool compress = false);
+
+/// Read-only view of a preflop matrix file.
+class PreflopMatrix {
+ public:
+  /// Throws std::runtime_error if the file is missing or malformed.
+  explicit PreflopMatrix(const std::string& path);
+
+  const TableFile& file() const { return file_; }
+
+  /// Class i against class j. Throws std::invalid_argument out of range.
+  PreflopMatchup matchup(int i, int j) const;
+  double equity(int i, int j) const { return matchup(i, j).equity(); }
+
+  /// Class i against a uniformly random hand: the matchups-weighted row.
+  PreflopMatchup versus_random(int i) const;
+
+  /// Row-major 169 x 169 probabilities.
+  const float* wins() const { return win_; }
+  const float* ties() const { return tie_; }
+
+ private:
+  TableFile file_;
+  const float* win_ = nullptr;
+  const float* tie_ = nullptr;
+};
+
+/// Preflop range-vs-range equity from the matrix: each range becomes a
+/// vector of mean holding weight per class, and the totals are the products
+/// a' (N o W) b and a' (N o T) b with N the matchup counts. Exact when each
+/// range weights a class's holdings equally (all range notation except
+/// single combos); otherwise holdings take their class's average. Per-holding
+/// equities are those of their class. Throws std::invalid_argument if the
+/// ranges cannot meet.
+RangeEquity preflop_range_equity(const PreflopMatrix& matrix, const HandRange& a, const HandRange& b);
+
+/// Maps the matrix that run_monte_carlo (preflop, one opponent, no dead
+/// cards) and range_vs_range_equity (empty board) answer from; an empty path
+/// unloads it. Throws like PreflopMatrix.
+void load_preflop_matrix(const std::string& path);
+
+/// The loaded matrix, or null.
+std::shared_ptr<const PreflopMatrix> preflop_matrix();
+
+}  // namespace poker_sim
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef POKER_SIM_PUSH_FOLD_HPP
+#define POKER_SIM_PUSH_FOLD_HPP
+
+#include "poker_sim/preflop_matrix.hpp"
+#include <array>
+#include <vector>
+
+namespace poker_sim {
+
+/// Largest table solve_push_fold takes.
+constexpr int kPushFoldMaxPlayers = 9;
+
+/// A jam-or-fold spot in big blinds. Players act in stacks order; the last
+/// two post the small and big blind (heads-up, the small blind acts first).
+struct PushFoldSpot {
+  std::vector<double> stacks;  // starting stacks, blinds and antes included
+  double small_blind = 0.5;
+  double ante = 0;  // posted by every player
+  /// Prizes by place. Empty plays for chips; otherwise every outcome is worth
+  /// its change in icm_equity over the table's stacks ($EV), the table
+  /// standing for the whole field.
+  std::vector<double> payouts;
+};
+
+/// Per-class probabilities in preflop_class order.
+using ClassStrategy = std::array<double, kNumPreflopClasses>;
+
+/// Equilibrium of a push/fold game: the first player in jams or folds and
+/// each player behind calls or folds the jam.
+struct PushFoldSolution {
+  int players = 0;
+  std::vector<ClassStrategy> jam;   // [seat]: jam when folded to; zero for the big blind
+  std::vector<ClassStrategy> call;  // [caller * players + jammer]; zero unless caller > jammer
+  std::vector<double> ev;           // expected change per seat: big blinds, or payout units with payouts
+  double exploitability = 0;        // most a single seat gains by deviating per hand, in ev's units
+  int iterations = 0;
+
+  const ClassStrategy& call_vs(int caller, int jammer) const { return call[caller * players + jammer]; }
+};
+
+/// Solves a push/fold spot with CFR+ over the 169 classes, every class's
+/// values for a decision coming from one pass of matrix-vector products
+/// with the matchup counts and equities of the preflop matrix, so card
+/// removal between the two all-in hands is exact. Players not in the all-in
+/// are dealt independently of it, and once a jam is called the players left
+/// fold (no three-way all-ins). With payouts, ties take the mean of the
+/// winning and losing prize equities. Stops after max_iterations or once
+/// exploitability is below tolerance (big blinds; with payouts, prize equity
+/// valued at the table's chips per prize pool), and returns the average
+/// strategy. Throws
+/// std::invalid_argument unless there are 2 to kPushFoldMaxPlayers stacks,
+/// each larger than its blind and ante, and payouts are non-negative.
+PushFoldSolution solve_push_fold(const PreflopMatrix& matrix,
+                                 const PushFoldSpot& spot,
+                                 int max_iterations = 2000,
+                                 double tolerance = 1e-4);
+
+/// solve_push_fold for players equal stacks at each depth (big blinds),
+/// depths solved on worker threads (0 = default).
+std::vector<PushFoldSolution> push_fold_charts(const PreflopMatrix& matrix,
+                                               const std::vector<double>& depths,
+                                               int players = 2,
+                                               double ante = 0,
+                                               const std::vector<double>& payouts = {},
+                                               int max_iterations = 2000,
+                                               double tolerance = 1e-4,
+                                               unsigned num_threads = 0);
+
+}  // namespace poker_sim
+
+#endif
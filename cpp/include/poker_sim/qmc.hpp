@@ -0,0 +1,33 @@
+#ifndef POKER_SIM_QMC_HPP
+#define POKER_SIM_QMC_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace poker_sim {
+
+/// Sobol low-discrepancy sequence in up to SobolSequence::kMaxDims dimensions
+/// (Joe-Kuo direction numbers), generated in Gray-code order. Coordinates are
+/// 32-bit fixed point: u = x / 2^32. An optional per-dimension XOR mask applies
+/// a random digital shift, which makes every point uniform on [0,1)^d while
+/// keeping the net structure (randomized QMC).
+class SobolSequence {
+ public:
+  static constexpr int kMaxDims = 21;  // 5 board cards + 8 opponents x 2
+
+  explicit SobolSequence(int dims, std::vector<std::uint32_t> shift = {});
+
+  int dims() const { return dims_; }
+  /// Writes the next point's dims() coordinates to out.
+  void next(std::uint32_t* out);
+
+ private:
+  int dims_;
+  std::uint32_t index_ = 0;
+  std::vector<std::uint32_t> directions_;  // dims x 32
+  std::vector<std::uint32_t> state_;
+};
+
+}  // namespace poker_sim
+
+#endif
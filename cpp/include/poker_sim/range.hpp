@@ -0,0 +1,85 @@
+#ifndef POKER_SIM_RANGE_HPP
+#define POKER_SIM_RANGE_HPP
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace poker_sim {
+
+/// Two-card holdings are indexed 0..1325: for cards a < b, index = b*(b-1)/2 + a.
+constexpr int kNumCombos = 1326;
+
+inline int combo_index(uint8_t a, uint8_t b) {
+  if (a > b) std::swap(a, b);
+  return b * (b - 1) / 2 + a;
+}
+
+/// Cards (low, high) of a holding index.
+std::pair<uint8_t, uint8_t> combo_cards(int index);
+
+/// 52-bit card mask of a holding index.
+std::uint64_t combo_mask(int index);
+
+/// Starting-hand classes ("AA", "AKs", "AKo", ...), numbered on the 13x13
+/// grid with aces first: row * 13 + column, pairs on the diagonal, suited
+/// hands above it (row = higher rank) and offsuit hands below.
+constexpr int kNumPreflopClasses = 169;
+
+/// Class of hole cards a, b (distinct).
+int preflop_class(uint8_t a, uint8_t b);
+
+/// Class of a name like "AKs", "t9o" or "77". Throws std::invalid_argument.
+int preflop_class(const std::string& name);
+
+/// "AKs", "T9o", "77".
+std::string preflop_class_name(int cls);
+
+/// Holdings in a class: 6 (pair), 4 (suited) or 12 (offsuit).
+inline int preflop_class_combos(int cls) {
+  const int row = cls / 13, col = cls % 13;
+  return row == col ? 6 : row < col ? 4 : 12;
+}
+
+/// A weighted set of the 1326 holdings (weight 0 = not in range).
+struct HandRange {
+  std::array<double, kNumCombos> weights{};
+
+  /// Parses standard range notation, comma separated:
+  ///   "AA", "TT+", "77-TT", "AKs", "AKo", "AK", "AQs+", "K9o+", "A2s-A5s",
+  ///   "AhKh" (one combo), "random" / "any" (every holding),
+  /// each optionally followed by ":weight" (0-1). Throws std::invalid_argument.
+  static HandRange parse(const std::string& text);
+
+  /// Every holding at weight 1 (a uniformly random hand).
+  static HandRange full();
+
+  /// Number of holdings with non-zero weight.
+  int size() const;
+};
+
+/// Walker/Vose alias table over a range's holdings, skipping any that touch
+/// `dead_mask`. Draws a holding index in O(1).
+class AliasTable {
+ public:
+  AliasTable(const HandRange& range, std::uint64_t dead_mask);
+
+  bool empty() const { return combos_.empty(); }
+
+  int sample(std::mt19937& rng) const {
+    std::uint32_t col = static_cast<std::uint32_t>((static_cast<std::uint64_t>(rng()) * combos_.size()) >> 32);
+    return (rng() < threshold_[col]) ? combos_[col] : alias_[col];
+  }
+
+ private:
+  std::vector<int> combos_;
+  std::vector<std::uint64_t> threshold_;  // P(keep column) scaled to 2^32
+  std::vector<int> alias_;
+};
+
+}  // namespace poker_sim
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef POKER_SIM_RANGE_EQUITY_HPP
+#define POKER_SIM_RANGE_EQUITY_HPP
+
+#include "poker_sim/range.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace poker_sim {
+
+/// Exact equity of one holding over every runout and opposing holding.
+struct ComboEquity {
+  int combo = 0;
+  double equity = 0;  // win + tie/2
+  double weight = 0;  // own weight times the opposing weight it met
+};
+
+/// Exact range-vs-range result. Index 0 is range A, 1 is range B; every
+/// (holding A, holding B, runout) with no shared card counts once, times the
+/// two holdings' weights.
+struct RangeEquity {
+  double equity[2] = {0, 0};
+  double win[2] = {0, 0};
+  double tie = 0;
+  double matchups = 0;  // total weight of those triples
+  std::uint64_t runouts = 0;
+  std::vector<ComboEquity> combos[2];  // holdings of each range that met an opponent
+};
+
+/// Enumerates every board completion (board of 3, 4 or 5 cards) in parallel;
+/// dead_mask cards are out of both the runouts and the ranges.
+/// Per runout both ranges are ranked once and swept in strength order, with
+/// per-card weight sums subtracting blocked matchups: O(n log n) instead of
+/// O(n^2). An empty board with no dead cards is answered from the preflop
+/// matrix (preflop_range_equity); without one loaded it throws
+/// std::runtime_error. num_threads = 0 means default. Throws
+/// std::invalid_argument on bad input.
+RangeEquity range_vs_range_equity(const HandRange& a,
+                                  const HandRange& b,
+                                  const std::vector<uint8_t>& board,
+                                  std::uint64_t dead_mask = 0,
+                                  unsigned num_threads = 0);
+
+}  // namespace poker_sim
+
+#endif
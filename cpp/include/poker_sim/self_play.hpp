@@ -0,0 +1,102 @@
+#ifndef POKER_SIM_SELF_PLAY_HPP
+#define POKER_SIM_SELF_PLAY_HPP
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace poker_sim {
+
+/// Most seats at a self-play table.
+constexpr int kMaxTableSeats = 9;
+
+/// A betting decision. CALL checks when nothing is owed; FOLD with nothing
+/// owed checks too. RAISE makes the seat's total bet this street amount (a
+/// bet when nobody has bet): below a full raise it is raised to one, above
+/// the stack it is an all-in, and it is a call when the seat may not raise.
+struct BotAction {
+  enum Kind : uint8_t { FOLD, CALL, RAISE };
+  Kind kind = CALL;
+  double amount = 0;
+};
+
+/// One hand in progress, in big blinds. Plain arrays reused from hand to
+/// hand, so play allocates nothing. Policies see every seat's cards and must
+/// read only their own (hole[actor]).
+struct TableState {
+  int seats = 0;
+  int button = 0;
+  int actor = -1;    // seat to act
+  int street = 0;    // 0 preflop, 1 flop, 2 turn, 3 river
+  int raises = 0;    // bets and raises this street
+  uint8_t hole[kMaxTableSeats][2] = {};
+  uint8_t board[5] = {};  // all five dealt up front; board_cards are showing
+  int board_cards = 0;
+  double stack[kMaxTableSeats] = {};     // behind
+  double bet[kMaxTableSeats] = {};       // this street
+  double invested[kMaxTableSeats] = {};  // this hand, blinds included
+  bool folded[kMaxTableSeats] = {};
+  bool acted[kMaxTableSeats] = {};       // since the last full raise
+  bool can_raise[kMaxTableSeats] = {};   // false after an incomplete all-in raise
+  double pot = 0;          // everything invested this hand
+  double current_bet = 0;  // highest bet this street
+  double min_raise = 0;    // smallest full raise increment this street
+  uint8_t deck[52] = {};
+
+  double to_call() const { return current_bet - bet[actor]; }
+  /// Seats still in the hand.
+  int in_hand() const;
+};
+
+/// A bot: the action for state.actor. Called from several threads at once,
+/// so it must keep no mutable shared state; rng is the calling thread's.
+using BotPolicy = BotAction (*)(const TableState& state, std::mt19937& rng);
+
+/// Built-in bots: "station" (checks and calls), "maniac" (raises the pot
+/// every time), "random", "rock" (premium hands only), "tag" (tight
+/// aggressive) and "lag" (loose aggressive, with bluffs). Throws
+/// std::invalid_argument on an unknown name.
+BotPolicy bot_policy(const std::string& name);
+
+struct SelfPlayConfig {
+  std::vector<BotPolicy> bots;  // one per seat, 2-9
+  double stack = 100;           // every seat starts every hand with this (bb)...
+  std::vector<double> stacks;   // ...unless given per seat here
+  double small_blind = 0.5;
+  std::uint64_t num_hands = 100000;
+  unsigned seed = 0;
+  unsigned num_threads = 0;
+};
+
+/// Winnings of one seat's bot over the run.
+struct BotResult {
+  double bb_per_100 = 0;
+  double ci95 = 0;  // half-width of the 95% confidence interval of bb_per_100
+  double won = 0;   // bb, over all hands
+};
+
+struct SelfPlayResult {
+  std::vector<BotResult> seats;
+  std::uint64_t hands = 0;
+};
+
+/// Plays num_hands independent no-limit hands between the bots, each seat
+/// starting every hand with its stack and the button moving one seat per hand.
+/// Blinds are small_blind and 1 (heads-up the button posts the small blind).
+/// Betting follows no-limit rules: full raises reopen the action, incomplete
+/// all-in raises only have to be called. Showdowns split the pot into side
+/// pots by what each seat invested, each ranked with evaluate_hand. Hands are
+/// split into fixed chunks with their own random streams, so results do not
+/// depend on num_threads (0 = default). Throws std::invalid_argument on a bad
+/// seat count, stack (at least one big blind), blind or num_hands = 0.
+SelfPlayResult self_play(const SelfPlayConfig& config);
+
+/// Plays one hand on state from a shuffled deck with the given button,
+/// adding each seat's net result (bb) to net. Seats, stacks and blinds come
+/// from config; state needs no preparation.
+void play_hand(const SelfPlayConfig& config, int button, TableState& state, std::mt19937& rng, double* net);
+
+}  // namespace poker_sim
+
+#endif
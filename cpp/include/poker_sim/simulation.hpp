@@ -1,25 +1,105 @@
 #ifndef POKER_SIM_SIMULATION_HPP
 #define POKER_SIM_SIMULATION_HPP
 
+#include "poker_sim/range.hpp"
+#include <array>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace poker_sim {
 
+/// Fixed-point unit of SimResult::pot_share: lcm(1..9), so every k-way split
+/// of a pot among up to 9 players is a whole number of units.
+constexpr std::uint32_t kPotShareUnit = 2520;
+
 struct SimResult {
   int wins = 0;
   int ties = 0;
   int losses = 0;
   int total = 0;
+  /// Number of i.i.d. trials that would give the same variance of the equity
+  /// estimate. Equals total for plain sampling.
+  double effective_samples = 0;
+  /// Hero's pot share summed over trials, in kPotShareUnit per pot: a full
+  /// unit per win, kPotShareUnit / k per k-way split.
+  std::uint64_t pot_share = 0;
+  /// split_ways[k]: trials where the hero split the pot k ways (k = 2-9).
+  std::array<int, 10> split_ways{};
+  /// True when the counts come from the flop equity table or the preflop
+  /// matrix rather than sampling: they are num_trials deals in the exact proportions, and
+  /// effective_samples is the number of deals enumerated.
+  bool exact = false;
+
+  /// True equity: the mean fraction of the pot won, splits shared 1/k.
+  double equity() const { return total > 0 ? static_cast<double>(pot_share) / kPotShareUnit / total : 0.0; }
 };
 
+/// How run_monte_carlo draws its deals. All modes except SOBOL are unbiased;
+/// the variance-reduced ones cost the same per trial as IID.
+enum class SamplerMode {
+  IID,              // independent uniform deals
+  STRATIFIED,       // equal trials per board runout (flop/turn) or first dealt card
+  ANTITHETIC,       // pairs of mirrored deals over the rank-sorted deck
+  LATIN_HYPERCUBE,  // Latin hypercube over the per-card draws, in blocks
+  SOBOL,            // quasi-Monte Carlo: one Sobol point per deal (deterministic)
+  SOBOL_SCRAMBLED,  // Sobol with random digital shifts, in independent replicates
+};
+
+/// "iid", "stratified", "antithetic", "lhs", "sobol" or "sobol_scrambled".
+/// Throws std::invalid_argument.
+SamplerMode sampler_from_name(const std::string& name);
+const char* sampler_name(SamplerMode mode);
+
 /// Full Monte Carlo: hole_cards (2), board (0,3,4,5), num_opponents (1-8), num_trials.
-/// Returns wins, ties, losses, total.
+/// dead_mask (bit c = card c) removes folded or exposed cards from the deck;
+/// they must not overlap the hole cards or board. Returns wins, ties, losses,
+/// total. Flop spots with 1-3 opponents and no dead cards are answered from
+/// the flop equity table when one is loaded (load_flop_equity_table), and
+/// preflop spots against one opponent with no dead cards from the preflop
+/// matrix (load_preflop_matrix). Throws std::invalid_argument on bad input.
 SimResult run_monte_carlo(const std::vector<uint8_t>& hole_cards,
                           const std::vector<uint8_t>& board,
                           int num_opponents,
                           std::uint32_t num_trials,
-                          unsigned seed = 0);
+                          unsigned seed = 0,
+                          SamplerMode sampler = SamplerMode::IID,
+                          std::uint64_t dead_mask = 0);
+
+/// Monte Carlo against one weighted range per opponent (1-8 ranges). Each
+/// trial draws opponent holdings from alias tables over the live combos,
+/// redrawing the whole set when two collide, then completes the board
+/// uniformly; dead_mask cards are out of play as in run_monte_carlo. IID only.
+/// Throws std::invalid_argument if a range has no live combo or the ranges
+/// cannot be dealt together.
+SimResult run_monte_carlo_ranges(const std::vector<uint8_t>& hole_cards,
+                                 const std::vector<uint8_t>& board,
+                                 const std::vector<HandRange>& opponent_ranges,
+                                 std::uint32_t num_trials,
+                                 unsigned seed = 0,
+                                 std::uint64_t dead_mask = 0);
+
+/// Per-player result of an all-in between known hands.
+struct MultiwayResult {
+  std::vector<double> equity;  // pot share: 1 per sole win, 1/k per k-way split
+  std::vector<double> win;     // fraction of runouts won outright
+  std::vector<double> tie;     // fraction of runouts split with others
+  std::uint64_t runouts = 0;   // runouts enumerated, or deals sampled
+  bool exact = false;
+};
+
+/// Equity of 2-9 players with known hole cards on a board of 0, 3, 4 or 5
+/// cards, with dead_mask cards removed from the deck. Enumerates every
+/// runout when there are no more of them than num_trials, otherwise samples
+/// num_trials runouts over worker threads (0 = default); a given seed gives
+/// the same answer for any thread count. Throws std::invalid_argument, also
+/// for num_trials = 0.
+MultiwayResult multiway_equity(const std::vector<std::vector<uint8_t>>& hands,
+                               const std::vector<uint8_t>& board,
+                               std::uint64_t dead_mask = 0,
+                               std::uint32_t num_trials = 20000,
+                               unsigned seed = 0,
+                               unsigned num_threads = 0);
 
 }  // namespace poker_sim
 
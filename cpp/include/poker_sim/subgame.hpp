@@ -0,0 +1,92 @@
+#ifndef POKER_SIM_SUBGAME_HPP
+#define POKER_SIM_SUBGAME_HPP
+
+#include "poker_sim/range.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace poker_sim {
+
+/// Bet sizes offered in a subgame's betting tree, as fractions of the pot.
+struct BetTree {
+  std::vector<double> bets = {0.5, 1.0};  // opening bets
+  std::vector<double> raises = {1.0};     // raises: call, then this fraction of the pot
+  int max_raises = 2;                     // raises after the opening bet
+  bool all_in = true;                     // also offer the whole stack
+};
+
+/// A heads-up spot at the start of the turn or river. Player 0 is out of
+/// position and acts first on each street.
+struct SubgameSpot {
+  std::vector<uint8_t> board;  // 4 (turn) or 5 (river) cards
+  HandRange ranges[2];         // out of position, in position
+  double pot = 0;              // already in the middle, half from each player
+  double stack = 0;            // effective stack behind, for both streets
+  BetTree tree;
+};
+
+/// A node of the solved betting tree.
+struct SubgameNode {
+  enum Kind : uint8_t { ACTION, FOLD, SHOWDOWN, CHANCE };
+  Kind kind = ACTION;
+  int player = -1;            // to act (ACTION) or folding (FOLD)
+  int river = -1;             // river card dealt on the way here; -1 before it or in a river spot
+  double committed[2] = {0, 0};  // put in since the start of the spot
+  std::vector<std::string> actions;  // "check", "bet 50", "raise 150", "all-in 200", "call", "fold"; CHANCE: "river Xy"
+  std::vector<int> children;
+  /// CHANCE: the river card of each child and how many rivers it stands for;
+  /// the others are suit relabelings of it that leave the board and both
+  /// ranges unchanged.
+  std::vector<uint8_t> cards;
+  std::vector<int> counts;
+  /// Average strategy, [action * hands[player].size() + hand].
+  std::vector<float> strategy;
+};
+
+struct SubgameSolution {
+  std::vector<int> hands[2];         // live holdings (combo indices) of each range
+  std::vector<double> ev[2];         // chips each holding wins from the pot, net of its bets
+  std::vector<SubgameNode> nodes;    // nodes[0] is the root
+  std::vector<int> rivers;           // turn spots: per card, the river it is solved as (-1 on the board)
+  double value = 0;                  // out-of-position player's mean ev
+  double exploitability = 0;         // mean best-response gain of the two players, chips
+  int iterations = 0;
+};
+
+/// Solves a turn or river subgame with discounted CFR (alpha 1.5, beta 0,
+/// gamma 2) and alternating updates. Regrets, strategies and counterfactual
+/// values are per-node arrays over all of a player's holdings, updated a node
+/// at a time across hands. Showdowns are valued in O(n) per node from the
+/// holdings sorted once by strength, with per-card reach sums removing
+/// blocked matchups.
+///
+/// A turn spot deals the river at a chance node after each turn betting
+/// round that ends without a fold (straight to showdown when all in). Rivers
+/// that a suit permutation maps onto each other, leaving the board and both
+/// ranges unchanged, are solved once and their values mapped back through the
+/// permutation. The river subtrees under a chance node are walked in parallel
+/// on a pool of num_threads threads (0 = default) started once per solve;
+/// results do not depend on it. Regrets
+/// and strategy sums are stored as half floats scaled per node.
+///
+/// Stops after max_iterations or once exploitability is at most target (a
+/// fraction of the pot). Throws std::invalid_argument on a bad board, range,
+/// pot, stack or tree.
+SubgameSolution solve_subgame(const SubgameSpot& spot, int max_iterations = 1000, double target = 0.003,
+                              unsigned num_threads = 0);
+
+/// How big a solve of spot is: betting tree nodes (river subtrees counted
+/// once per river class) and live holdings of each range. An iteration costs
+/// about nodes x (hands[0] + hands[1]). Builds the tree without solving;
+/// throws like solve_subgame.
+struct SubgameSize {
+  std::size_t nodes = 0;
+  std::size_t hands[2] = {0, 0};
+};
+SubgameSize subgame_size(const SubgameSpot& spot);
+
+}  // namespace poker_sim
+
+#endif
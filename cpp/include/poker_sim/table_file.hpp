@@ -0,0 +1,130 @@
+#ifndef POKER_SIM_TABLE_FILE_HPP
+#define POKER_SIM_TABLE_FILE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace poker_sim {
+
+/// Container format shared by every precomputed table. A 4 KiB header page
+/// holds the format version, the table kind with its own layout version and
+/// parameters, the HandIndexer scheme its rows follow, and a directory of
+/// named sections, all covered by a CRC-32. Sections start on page
+/// boundaries, so an uncompressed one is used in place from a read-only
+/// mapping: opening costs a few system calls, and processes mapping the same
+/// file (e.g. several uvicorn workers) share its pages. A section may instead
+/// be stored as zlib-compressed blocks, for cold tables; it is then inflated
+/// into memory on open. Each section carries the CRC-32 of its bytes, checked
+/// by TableFile::verify(). All integers are little-endian.
+constexpr std::uint32_t kTableFormatVersion = 1;
+constexpr std::size_t kTablePageBytes = 4096;
+
+enum class TableKind : std::uint32_t {
+  BUCKETS = 1,      // hand-abstraction bucket per class (buckets.hpp)
+  FLOP_EQUITY = 2,  // multiway outcome distribution per flop class (flop_equity.hpp)
+  PREFLOP_MATRIX = 3,  // class-vs-class preflop win and tie (preflop_matrix.hpp)
+};
+
+/// "buckets", "flop_equity", "preflop_matrix", or "unknown".
+const char* table_kind_name(TableKind kind);
+
+/// Directory entry of a section.
+struct TableSection {
+  std::string name;          // at most 23 characters
+  std::uint64_t offset = 0;  // in the file, page-aligned
+  std::uint64_t stored_bytes = 0;
+  std::uint64_t bytes = 0;   // after decompression
+  bool compressed = false;
+  std::uint32_t crc = 0;     // CRC-32 of the uncompressed bytes
+};
+
+/// CRC-32 (IEEE 802.3, as zlib's crc32) of data, continuing from crc.
+std::uint32_t crc32(const void* data, std::size_t bytes, std::uint32_t crc = 0);
+
+/// Builds a table file in memory order: describe it, add sections, write.
+class TableWriter {
+ public:
+  /// kind_version is the table's own layout version; params are up to four
+  /// kind-specific numbers (e.g. the bucket count); cards_per_round is the
+  /// HandIndexer scheme of its rows, empty if it has none.
+  TableWriter(TableKind kind,
+              std::uint32_t kind_version,
+              std::vector<int> cards_per_round = {},
+              std::array<std::uint64_t, 4> params = {});
+
+  /// Copies `bytes` bytes as section `name`. Compressed sections need zlib
+  /// (std::runtime_error otherwise). Throws std::invalid_argument on a long
+  /// or repeated name.
+  void add_section(const std::string& name, const void* data, std::size_t bytes, bool compress = false);
+
+  /// Writes to a temporary file beside `path` and renames it into place, so
+  /// readers never map a half-written table. Throws std::runtime_error.
+  void write(const std::string& path) const;
+
+ private:
+  TableKind kind_;
+  std::uint32_t kind_version_;
+  std::vector<int> cards_per_round_;
+  std::array<std::uint64_t, 4> params_;
+  std::vector<TableSection> sections_;
+  std::vector<std::vector<char>> payloads_;  // stored bytes of each section
+};
+
+/// Read-only view of a table file.
+class TableFile {
+ public:
+  /// Maps the file and checks its header; inflates compressed sections.
+  /// Throws std::runtime_error if the file is missing, malformed, of another
+  /// format version, or (when expected_kind is given) of another kind.
+  explicit TableFile(const std::string& path);
+  TableFile(const std::string& path, TableKind expected_kind, std::uint32_t expected_kind_version);
+  ~TableFile();
+  TableFile(const TableFile&) = delete;
+  TableFile& operator=(const TableFile&) = delete;
+
+  const std::string& path() const { return path_; }
+  TableKind kind() const { return kind_; }
+  std::uint32_t kind_version() const { return kind_version_; }
+  const std::vector<int>& cards_per_round() const { return cards_per_round_; }
+  const std::array<std::uint64_t, 4>& params() const { return params_; }
+  const std::vector<TableSection>& sections() const { return sections_; }
+
+  bool has_section(const std::string& name) const;
+  /// Bytes of a section. Throws std::runtime_error if it is missing.
+  const void* section(const std::string& name, std::size_t* bytes = nullptr) const;
+  /// A section as `count` elements of T. Throws std::runtime_error if it is
+  /// missing or of another size.
+  template <typename T>
+  const T* array(const std::string& name, std::size_t count) const {
+    std::size_t bytes = 0;
+    const void* p = section(name, &bytes);
+    if (bytes != count * sizeof(T)) size_mismatch(name);
+    return static_cast<const T*>(p);
+  }
+
+  /// Recomputes every section's CRC. Throws std::runtime_error on a mismatch.
+  void verify() const;
+
+ private:
+  void open(const std::string& path);
+  void read_directory();
+  [[noreturn]] void size_mismatch(const std::string& name) const;
+
+  std::string path_;
+  void* mapping_ = nullptr;
+  std::size_t length_ = 0;
+  TableKind kind_{};
+  std::uint32_t kind_version_ = 0;
+  std::vector<int> cards_per_round_;
+  std::array<std::uint64_t, 4> params_{};
+  std::vector<TableSection> sections_;
+  std::vector<const char*> data_;            // per section
+  std::vector<std::vector<char>> inflated_;  // per section; empty unless compressed
+};
+
+}  // namespace poker_sim
+
+#endif
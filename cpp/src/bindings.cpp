@@ -1,9 +1,132 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <poker_sim/equity_grid.hpp>
+#include <poker_sim/flop_equity.hpp>
+#include <poker_sim/hand_eval.hpp>
+#include <poker_sim/hand_index.hpp>
+#include <poker_sim/hand_strength.hpp>
+#include <poker_sim/icm.hpp>
+#include <poker_sim/outs.hpp>
+#include <poker_sim/preflop_matrix.hpp>
+#include <poker_sim/push_fold.hpp>
+#include <poker_sim/range.hpp>
+#include <poker_sim/range_equity.hpp>
+#include <poker_sim/self_play.hpp>
 #include <poker_sim/simulation.hpp>
+#include <poker_sim/subgame.hpp>
+#include <stdexcept>
+#include <string>
 
 namespace py = pybind11;
 
+namespace {
+
+/// Converts Python card indices, rejecting anything outside 0-51.
+std::vector<uint8_t> to_cards(const std::vector<int>& cards) {
+  std::vector<uint8_t> out;
+  out.reserve(cards.size());
+  for (int c : cards) {
+    if (c < 0 || c > 51) throw std::invalid_argument("card index out of range 0-51");
+    out.push_back(static_cast<uint8_t>(c));
+  }
+  return out;
+}
+
+/// Dead-card list as a card mask (bit c = card c).
+std::uint64_t to_mask(const std::vector<int>& cards) { return poker_sim::card_mask(to_cards(cards)); }
+
+/// The loaded preflop matrix; throws std::runtime_error without one.
+std::shared_ptr<const poker_sim::PreflopMatrix> require_preflop_matrix() {
+  auto matrix = poker_sim::preflop_matrix();
+  if (!matrix) throw std::runtime_error("no preflop matrix loaded");
+  return matrix;
+}
+
+/// jam[seat] and call[caller][jammer] as 169-long lists, plus ev,
+/// exploitability and iterations.
+py::dict push_fold_dict(const poker_sim::PushFoldSolution& s) {
+  py::list jam, call;
+  for (int p = 0; p < s.players; ++p) {
+    jam.append(s.jam[p]);
+    py::list row;
+    for (int q = 0; q < s.players; ++q) row.append(s.call_vs(p, q));
+    call.append(row);
+  }
+  py::dict out;
+  out["jam"] = jam;
+  out["call"] = call;
+  out["ev"] = s.ev;
+  out["exploitability"] = s.exploitability;
+  out["iterations"] = s.iterations;
+  return out;
+}
+
+/// hands (card, card, weight) per player, ev per player, nodes (kind,
+/// player, river, committed, actions, children, cards and counts of chance
+/// nodes, strategy[action][hand]), value, exploitability and iterations.
+/// Strategies are filled in before the river and on the river solved as
+/// river (none when -1).
+py::dict subgame_dict(const poker_sim::SubgameSpot& spot, const poker_sim::SubgameSolution& s, int river) {
+  static const char* const kKinds[] = {"action", "fold", "showdown", "chance"};
+  if (river >= 0 && river < static_cast<int>(s.rivers.size())) river = s.rivers[river];
+  py::list hands, nodes;
+  for (int p = 0; p < 2; ++p) {
+    py::list h;
+    for (int combo : s.hands[p]) {
+      auto cards = poker_sim::combo_cards(combo);
+      h.append(py::make_tuple(cards.second, cards.first, spot.ranges[p].weights[combo]));
+    }
+    hands.append(h);
+  }
+  for (const auto& n : s.nodes) {
+    py::dict node;
+    node["kind"] = kKinds[n.kind];
+    node["player"] = n.player;
+    node["river"] = n.river;
+    node["committed"] = py::make_tuple(n.committed[0], n.committed[1]);
+    node["actions"] = n.actions;
+    node["children"] = n.children;
+    node["cards"] = std::vector<int>(n.cards.begin(), n.cards.end());
+    node["counts"] = n.counts;
+    py::list strategy;
+    if (n.kind == poker_sim::SubgameNode::ACTION && (n.river < 0 || n.river == river)) {
+      const std::size_t m = s.hands[n.player].size();
+      for (std::size_t a = 0; a < n.children.size(); ++a)
+        strategy.append(std::vector<float>(n.strategy.begin() + a * m, n.strategy.begin() + (a + 1) * m));
+    }
+    node["strategy"] = strategy;
+    nodes.append(node);
+  }
+  py::dict out;
+  out["hands"] = hands;
+  out["ev"] = py::make_tuple(s.ev[0], s.ev[1]);
+  out["nodes"] = nodes;
+  out["rivers"] = s.rivers;
+  out["value"] = s.value;
+  out["exploitability"] = s.exploitability;
+  out["iterations"] = s.iterations;
+  return out;
+}
+
+poker_sim::SubgameSpot subgame_spot(const std::vector<int>& board, const std::string& oop_range,
+                                    const std::string& ip_range, double pot, double stack,
+                                    const std::vector<double>& bets, const std::vector<double>& raises,
+                                    int max_raises, bool all_in) {
+  poker_sim::SubgameSpot spot;
+  spot.board = to_cards(board);
+  spot.ranges[0] = poker_sim::HandRange::parse(oop_range);
+  spot.ranges[1] = poker_sim::HandRange::parse(ip_range);
+  spot.pot = pot;
+  spot.stack = stack;
+  spot.tree.bets = bets;
+  spot.tree.raises = raises;
+  spot.tree.max_raises = max_raises;
+  spot.tree.all_in = all_in;
+  return spot;
+}
+
+}  // namespace
+
 PYBIND11_MODULE(poker_sim_cpp, m) {
   m.doc() = "Texas Hold'em Monte Carlo simulation engine (C++ extension)";
 
@@ -12,6 +135,11 @@ PYBIND11_MODULE(poker_sim_cpp, m) {
     .def_readonly("ties", &poker_sim::SimResult::ties)
     .def_readonly("losses", &poker_sim::SimResult::losses)
     .def_readonly("total", &poker_sim::SimResult::total)
+    .def_readonly("effective_samples", &poker_sim::SimResult::effective_samples)
+    .def_readonly("pot_share", &poker_sim::SimResult::pot_share)
+    .def_readonly("split_ways", &poker_sim::SimResult::split_ways)
+    .def_readonly("exact", &poker_sim::SimResult::exact)
+    .def("equity", &poker_sim::SimResult::equity)
     .def("win_rate", [](const poker_sim::SimResult& r) {
       return r.total > 0 ? static_cast<double>(r.wins) / r.total : 0.0;
     })
@@ -22,20 +150,527 @@ PYBIND11_MODULE(poker_sim_cpp, m) {
       return r.total > 0 ? static_cast<double>(r.losses) / r.total : 0.0;
     });
 
+  m.attr("POT_SHARE_UNIT") = poker_sim::kPotShareUnit;
+
   m.def("run_monte_carlo",
         [](const std::vector<int>& hole_cards, const std::vector<int>& board,
-           int num_opponents, std::uint32_t num_trials, py::object seed_obj) {
-          std::vector<uint8_t> hc, b;
-          for (int c : hole_cards) hc.push_back(static_cast<uint8_t>(c));
-          for (int c : board) b.push_back(static_cast<uint8_t>(c));
+           int num_opponents, std::uint32_t num_trials, py::object seed_obj,
+           const std::string& sampler, const std::vector<int>& dead_cards) {
+          const std::vector<uint8_t> hc = to_cards(hole_cards), b = to_cards(board);
           unsigned seed = 0;
           if (!seed_obj.is_none()) seed = static_cast<unsigned>(py::cast<int>(seed_obj));
-          return poker_sim::run_monte_carlo(hc, b, num_opponents, num_trials, seed);
+          return poker_sim::run_monte_carlo(hc, b, num_opponents, num_trials, seed,
+                                            poker_sim::sampler_from_name(sampler), to_mask(dead_cards));
         },
         py::arg("hole_cards"),
         py::arg("board"),
         py::arg("num_opponents") = 1,
         py::arg("num_trials") = 10000,
         py::arg("seed") = py::none(),
-        "Run Monte Carlo simulation.");
+        py::arg("sampler") = "iid",
+        py::arg("dead_cards") = std::vector<int>{},
+        "Run Monte Carlo simulation. sampler: iid, stratified, antithetic, lhs, sobol or sobol_scrambled. "
+        "dead_cards are removed from the deck.");
+
+  m.def("load_flop_equity_table",
+        [](const std::string& path) { poker_sim::load_flop_equity_table(path); },
+        py::arg("path"),
+        "Map a flop equity file (poker_sim_flop_equity) for run_monte_carlo to answer flop spots with "
+        "1-3 opponents and no dead cards from; an empty path unloads it.");
+
+  m.def("flop_equity",
+        [](const std::vector<int>& hole_cards, const std::vector<int>& flop, int num_opponents) {
+          const auto table = poker_sim::flop_equity_table();
+          if (!table) throw std::runtime_error("no flop equity table loaded");
+          const poker_sim::FlopOutcome o = table->lookup(to_cards(hole_cards), to_cards(flop), num_opponents);
+          py::dict split_ways;
+          for (int j = 1; j <= o.opponents; ++j) split_ways[py::int_(j + 1)] = o.ways[j];
+          py::dict out;
+          out["win"] = o.win();
+          out["split_ways"] = split_ways;
+          out["equity"] = o.equity();
+          return out;
+        },
+        py::arg("hole_cards"),
+        py::arg("flop"),
+        py::arg("num_opponents") = 1,
+        "Exact win probability, split probabilities by pot size and equity from the loaded flop equity table.");
+
+  m.def("load_preflop_matrix",
+        [](const std::string& path) { poker_sim::load_preflop_matrix(path); },
+        py::arg("path"),
+        "Map a preflop matrix file (poker_sim_preflop_matrix) for run_monte_carlo (one opponent, no dead "
+        "cards) and range_vs_range_equity (empty board) to answer preflop spots from; an empty path unloads it.");
+
+  m.def("preflop_matchup",
+        [](const std::string& hand_a, const std::string& hand_b) {
+          const auto matrix = require_preflop_matrix();
+          const int a = poker_sim::preflop_class(hand_a);
+          const poker_sim::PreflopMatchup x =
+              hand_b == "random" ? matrix->versus_random(a) : matrix->matchup(a, poker_sim::preflop_class(hand_b));
+          py::dict out;
+          out["win"] = x.win;
+          out["tie"] = x.tie;
+          out["equity"] = x.equity();
+          out["matchups"] = x.matchups;
+          return out;
+        },
+        py::arg("hand_a"),
+        py::arg("hand_b"),
+        "Exact all-in win, tie and equity of starting-hand class hand_a (e.g. 'AKs') against hand_b "
+        "(a class or 'random') from the loaded preflop matrix, with the holding pairs behind it.");
+
+  m.def("preflop_equity_matrix",
+        []() {
+          const auto matrix = require_preflop_matrix();
+          py::list classes, rows;
+          for (int i = 0; i < poker_sim::kNumPreflopClasses; ++i) {
+            classes.append(poker_sim::preflop_class_name(i));
+            py::list row;
+            for (int j = 0; j < poker_sim::kNumPreflopClasses; ++j) row.append(matrix->equity(i, j));
+            rows.append(row);
+          }
+          py::dict out;
+          out["classes"] = classes;
+          out["equity"] = rows;
+          return out;
+        },
+        "The loaded preflop matrix as {'classes': 169 names in grid order, 'equity': 169 x 169 rows}.");
+
+  m.def("run_monte_carlo_ranges",
+        [](const std::vector<int>& hole_cards, const std::vector<int>& board,
+           const std::vector<std::string>& opponent_ranges, std::uint32_t num_trials,
+           py::object seed_obj, const std::vector<int>& dead_cards) {
+          std::vector<poker_sim::HandRange> ranges;
+          for (const auto& text : opponent_ranges) ranges.push_back(poker_sim::HandRange::parse(text));
+          unsigned seed = 0;
+          if (!seed_obj.is_none()) seed = static_cast<unsigned>(py::cast<int>(seed_obj));
+          std::vector<uint8_t> hc = to_cards(hole_cards), b = to_cards(board);
+          return poker_sim::run_monte_carlo_ranges(hc, b, ranges, num_trials, seed, to_mask(dead_cards));
+        },
+        py::arg("hole_cards"),
+        py::arg("board"),
+        py::arg("opponent_ranges"),
+        py::arg("num_trials") = 10000,
+        py::arg("seed") = py::none(),
+        py::arg("dead_cards") = std::vector<int>{},
+        "Run Monte Carlo against one range per opponent, e.g. [\"TT+,AQs+,KQo\", \"random\"].");
+
+  m.def("multiway_equity",
+        [](const std::vector<std::vector<int>>& hands, const std::vector<int>& board,
+           const std::vector<int>& dead_cards, std::uint32_t num_trials, py::object seed_obj,
+           unsigned num_threads) {
+          std::vector<std::vector<uint8_t>> hs;
+          for (const auto& h : hands) hs.push_back(to_cards(h));
+          unsigned seed = 0;
+          if (!seed_obj.is_none()) seed = static_cast<unsigned>(py::cast<int>(seed_obj));
+          poker_sim::MultiwayResult r =
+              poker_sim::multiway_equity(hs, to_cards(board), to_mask(dead_cards), num_trials, seed, num_threads);
+          py::dict out;
+          out["equity"] = r.equity;
+          out["win"] = r.win;
+          out["tie"] = r.tie;
+          out["runouts"] = r.runouts;
+          out["exact"] = r.exact;
+          return out;
+        },
+        py::arg("hands"),
+        py::arg("board"),
+        py::arg("dead_cards") = std::vector<int>{},
+        py::arg("num_trials") = 20000,
+        py::arg("seed") = py::none(),
+        py::arg("num_threads") = 0,
+        "All-in equity of 2-9 known hands (split pots shared 1/k). Exact when there are at most "
+        "num_trials runouts, else sampled. Returns a dict: equity, win, tie (per player), runouts, exact.");
+
+  m.def("range_size",
+        [](const std::string& text) { return poker_sim::HandRange::parse(text).size(); },
+        py::arg("range"),
+        "Number of holdings (of 1326) in a range string; raises ValueError if it does not parse.");
+
+  m.def("range_vs_range_equity",
+        [](const std::string& range_a, const std::string& range_b, const std::vector<int>& board,
+           const std::vector<int>& dead_cards, unsigned num_threads) {
+          auto a = poker_sim::HandRange::parse(range_a), b = poker_sim::HandRange::parse(range_b);
+          poker_sim::RangeEquity r =
+              poker_sim::range_vs_range_equity(a, b, to_cards(board), to_mask(dead_cards), num_threads);
+          py::dict out;
+          out["equity"] = py::make_tuple(r.equity[0], r.equity[1]);
+          out["win"] = py::make_tuple(r.win[0], r.win[1]);
+          out["tie"] = r.tie;
+          out["matchups"] = r.matchups;
+          out["runouts"] = r.runouts;
+          for (int s = 0; s < 2; ++s) {
+            py::list hands;
+            for (const auto& c : r.combos[s]) {
+              auto cards = poker_sim::combo_cards(c.combo);
+              hands.append(py::make_tuple(cards.second, cards.first, c.equity, c.weight));
+            }
+            out[s == 0 ? "hands_a" : "hands_b"] = hands;
+          }
+          return out;
+        },
+        py::arg("range_a"),
+        py::arg("range_b"),
+        py::arg("board"),
+        py::arg("dead_cards") = std::vector<int>{},
+        py::arg("num_threads") = 0,
+        "Exact range-vs-range equity over every runout of a 3-5 card board, or preflop from the loaded "
+        "preflop matrix (empty board, no dead cards; RuntimeError if none is loaded). Returns a dict with "
+        "equity/win (A, B), tie, matchups, runouts and hands_a/hands_b: (card, card, equity, weight).");
+
+  m.def("analyze_outs",
+        [](const std::vector<int>& hole_cards, const std::vector<int>& board, const std::string& opponent_range,
+           const std::vector<int>& dead_cards, unsigned num_threads) {
+          poker_sim::OutsResult r = poker_sim::analyze_outs(to_cards(hole_cards), to_cards(board),
+                                                            poker_sim::HandRange::parse(opponent_range),
+                                                            to_mask(dead_cards), num_threads);
+          // Column per field, indexed by card, for heatmaps.
+          std::vector<bool> live, improves, leads;
+          std::vector<int> category, improving_pairs;
+          std::vector<float> strength, equity;
+          for (const auto& c : r.cards) {
+            live.push_back(c.live);
+            improves.push_back(c.improves);
+            leads.push_back(c.leads);
+            category.push_back(c.category);
+            improving_pairs.push_back(c.improving_pairs);
+            strength.push_back(c.strength);
+            equity.push_back(c.equity);
+          }
+          py::dict out;
+          out["category"] = r.category;
+          out["strength"] = r.strength;
+          out["live_cards"] = r.live_cards;
+          out["improving"] = r.improving;
+          out["outs"] = r.outs;
+          out["live"] = live;
+          out["improves"] = improves;
+          out["leads"] = leads;
+          out["card_category"] = category;
+          out["improving_pairs"] = improving_pairs;
+          out["card_strength"] = strength;
+          out["card_equity"] = equity;
+          return out;
+        },
+        py::arg("hole_cards"),
+        py::arg("board"),
+        py::arg("opponent_range") = "random",
+        py::arg("dead_cards") = std::vector<int>{},
+        py::arg("num_threads") = 0,
+        "Classify every next card on a flop/turn board against a range: per-card (52-long) live, "
+        "improves, leads, card_category, card_strength, card_equity, improving_pairs; plus totals.");
+
+  m.def("classify_holdings",
+        [](const std::vector<int>& hole_cards, const std::vector<int>& board, const std::vector<int>& dead_cards) {
+          poker_sim::HoldingsBreakdown r =
+              poker_sim::classify_holdings(to_cards(hole_cards), to_cards(board), to_mask(dead_cards));
+          auto holdings = [](const std::vector<poker_sim::RankedHolding>& v) {
+            py::list out;
+            for (const auto& h : v) {
+              auto cards = poker_sim::combo_cards(h.combo);
+              out.append(py::make_tuple(cards.second, cards.first, poker_sim::hand_category(h.rank)));
+            }
+            return out;
+          };
+          py::dict out;
+          out["category"] = r.category;
+          out["percentile"] = r.percentile;
+          out["ahead"] = holdings(r.ahead);
+          out["tied"] = holdings(r.tied);
+          out["behind"] = holdings(r.behind);
+          out["ahead_by_category"] = std::vector<int>(r.ahead_by_category.begin(), r.ahead_by_category.end());
+          out["tied_by_category"] = std::vector<int>(r.tied_by_category.begin(), r.tied_by_category.end());
+          out["behind_by_category"] = std::vector<int>(r.behind_by_category.begin(), r.behind_by_category.end());
+          return out;
+        },
+        py::arg("hole_cards"),
+        py::arg("board"),
+        py::arg("dead_cards") = std::vector<int>{},
+        "Rank every live opponent holding against the hero on a 3-5 card board. Returns category, "
+        "percentile, ahead/tied/behind lists of (card_high, card_low, category), strongest first, "
+        "and per-category counts (lists of 9).");
+
+  auto strength_dict = [](const poker_sim::HandStrength& r) {
+    py::dict out;
+    out["hs"] = r.hs;
+    out["ppot"] = r.ppot;
+    out["npot"] = r.npot;
+    out["ehs"] = r.ehs;
+    out["ehs2"] = r.ehs2;
+    out["equity"] = r.equity;
+    out["runouts"] = r.runouts;
+    out["exact"] = r.exact;
+    return out;
+  };
+
+  m.def("hand_strength",
+        [strength_dict](const std::vector<int>& hole_cards, const std::vector<int>& board,
+                        const std::vector<int>& dead_cards, unsigned flop_runouts, unsigned seed) {
+          return strength_dict(poker_sim::hand_strength(to_cards(hole_cards), to_cards(board), to_mask(dead_cards),
+                                                        flop_runouts, seed));
+        },
+        py::arg("hole_cards"),
+        py::arg("board"),
+        py::arg("dead_cards") = std::vector<int>{},
+        py::arg("flop_runouts") = poker_sim::kDefaultFlopRunouts,
+        py::arg("seed") = 0,
+        "Hand strength and potential against a random hand on a 3-5 card board: dict with hs, ppot, npot, "
+        "ehs, ehs2, equity, runouts, exact. Flops sample flop_runouts runouts; results are cached by "
+        "suit-canonical spot.");
+
+  m.def("hand_strength_batch",
+        [strength_dict](const std::vector<std::pair<std::vector<int>, std::vector<int>>>& spots,
+                        const std::vector<int>& dead_cards, unsigned flop_runouts, unsigned seed,
+                        unsigned num_threads) {
+          std::vector<poker_sim::HandSpot> in;
+          for (const auto& s : spots) in.push_back({to_cards(s.first), to_cards(s.second)});
+          py::list out;
+          for (const auto& r : poker_sim::hand_strength_batch(in, to_mask(dead_cards), flop_runouts, seed, num_threads))
+            out.append(strength_dict(r));
+          return out;
+        },
+        py::arg("spots"),
+        py::arg("dead_cards") = std::vector<int>{},
+        py::arg("flop_runouts") = poker_sim::kDefaultFlopRunouts,
+        py::arg("seed") = 0,
+        py::arg("num_threads") = 0,
+        "hand_strength for a list of (hole_cards, board) pairs, spread over threads; returns a list of dicts.");
+
+  m.def("equity_histogram",
+        [](const std::vector<int>& hole_cards, const std::vector<int>& board, const std::string& opponent_range,
+           const std::vector<int>& dead_cards, unsigned bins) {
+          poker_sim::EquityHistogram r =
+              poker_sim::equity_histogram(to_cards(hole_cards), to_cards(board),
+                                          poker_sim::HandRange::parse(opponent_range), to_mask(dead_cards), bins);
+          py::dict out;
+          out["equity"] = r.equity;
+          out["next_card"] = r.next_card;
+          out["next_two_cards"] = r.next_two_cards;
+          out["runouts"] = r.runouts;
+          return out;
+        },
+        py::arg("hole_cards"),
+        py::arg("board"),
+        py::arg("opponent_range") = "random",
+        py::arg("dead_cards") = std::vector<int>{},
+        py::arg("bins") = 10,
+        "Exact histogram of the hero's equity against a range after the next card (and, on the flop, "
+        "after turn and river). Returns equity, next_card, next_two_cards (bin fractions), runouts.");
+
+  m.def("equity_grid",
+        [](const std::vector<int>& board, int num_opponents, std::uint32_t num_trials, py::object seed_obj,
+           const std::vector<int>& dead_cards, unsigned num_threads) {
+          unsigned seed = 0;
+          if (!seed_obj.is_none()) seed = static_cast<unsigned>(py::cast<int>(seed_obj));
+          const poker_sim::EquityGrid g =
+              poker_sim::equity_grid(to_cards(board), num_opponents, num_trials, seed, to_mask(dead_cards), num_threads);
+          py::list classes;
+          for (int c = 0; c < poker_sim::kNumPreflopClasses; ++c) classes.append(poker_sim::preflop_class_name(c));
+          py::dict out;
+          out["classes"] = classes;
+          out["equity"] = g.equity;
+          out["holdings"] = g.holdings;
+          out["exact"] = g.exact;
+          out["runouts"] = g.runouts;
+          return out;
+        },
+        py::arg("board"),
+        py::arg("num_opponents") = 1,
+        py::arg("num_trials") = 2000,
+        py::arg("seed") = py::none(),
+        py::arg("dead_cards") = std::vector<int>{},
+        py::arg("num_threads") = 0,
+        "Equity of all 169 starting-hand classes on a board against random opponents, in one pass over "
+        "shared runouts. Returns classes (names in 13x13 grid order), equity, holdings (live per class), "
+        "exact and runouts.");
+
+  m.def("push_fold",
+        [](const std::vector<double>& stacks, double small_blind, double ante, const std::vector<double>& payouts,
+           int max_iterations, double tolerance) {
+          poker_sim::PushFoldSpot spot;
+          spot.stacks = stacks;
+          spot.small_blind = small_blind;
+          spot.ante = ante;
+          spot.payouts = payouts;
+          return push_fold_dict(poker_sim::solve_push_fold(*require_preflop_matrix(), spot, max_iterations, tolerance));
+        },
+        py::arg("stacks"),
+        py::arg("small_blind") = 0.5,
+        py::arg("ante") = 0.0,
+        py::arg("payouts") = std::vector<double>{},
+        py::arg("max_iterations") = 2000,
+        py::arg("tolerance") = 1e-4,
+        "Push/fold equilibrium for stacks in big blinds, in action order (the last two post the blinds), "
+        "from the loaded preflop matrix; with payouts, for ICM prize equity instead of chips. Returns "
+        "jam[seat] and call[caller][jammer] as per-class probabilities in 13x13 grid order, ev per seat "
+        "(bb, or payout units), exploitability and iterations.");
+
+  m.def("push_fold_charts",
+        [](const std::vector<double>& depths, int players, double ante, const std::vector<double>& payouts,
+           int max_iterations, double tolerance, unsigned num_threads) {
+          py::list out;
+          for (const auto& s : poker_sim::push_fold_charts(*require_preflop_matrix(), depths, players, ante, payouts,
+                                                           max_iterations, tolerance, num_threads))
+            out.append(push_fold_dict(s));
+          return out;
+        },
+        py::arg("depths"),
+        py::arg("players") = 2,
+        py::arg("ante") = 0.0,
+        py::arg("payouts") = std::vector<double>{},
+        py::arg("max_iterations") = 2000,
+        py::arg("tolerance") = 1e-4,
+        py::arg("num_threads") = 0,
+        "push_fold for equal stacks at each depth (bb), depths solved in parallel. Returns one result per depth.");
+
+  m.def("icm_equity",
+        [](const std::vector<double>& stacks, const std::vector<double>& payouts, std::uint32_t num_trials,
+           py::object seed_obj, unsigned num_threads) {
+          unsigned seed = 0;
+          if (!seed_obj.is_none()) seed = static_cast<unsigned>(py::cast<int>(seed_obj));
+          const poker_sim::IcmEquity r = poker_sim::icm_equity(stacks, payouts, num_trials, seed, num_threads);
+          py::dict out;
+          out["equity"] = r.equity;
+          out["exact"] = r.exact;
+          out["trials"] = r.trials;
+          return out;
+        },
+        py::arg("stacks"),
+        py::arg("payouts"),
+        py::arg("num_trials") = 20000,
+        py::arg("seed") = py::none(),
+        py::arg("num_threads") = 0,
+        "Malmuth-Harville ICM prize equity per player. Exact by subset DP up to 20 players with chips, "
+        "sampled (num_trials finishing orders) beyond. Returns equity, exact and trials.");
+
+  m.def("solve_subgame",
+        [](const std::vector<int>& board, const std::string& oop_range, const std::string& ip_range, double pot,
+           double stack, const std::vector<double>& bets, const std::vector<double>& raises, int max_raises,
+           bool all_in, int max_iterations, double target, int river, unsigned num_threads) {
+          const poker_sim::SubgameSpot spot =
+              subgame_spot(board, oop_range, ip_range, pot, stack, bets, raises, max_raises, all_in);
+          return subgame_dict(spot, poker_sim::solve_subgame(spot, max_iterations, target, num_threads), river);
+        },
+        py::arg("board"),
+        py::arg("oop_range"),
+        py::arg("ip_range"),
+        py::arg("pot"),
+        py::arg("stack"),
+        py::arg("bets") = std::vector<double>{0.5, 1.0},
+        py::arg("raises") = std::vector<double>{1.0},
+        py::arg("max_raises") = 2,
+        py::arg("all_in") = true,
+        py::arg("max_iterations") = 1000,
+        py::arg("target") = 0.003,
+        py::arg("river") = -1,
+        py::arg("num_threads") = 0,
+        "Heads-up turn (4-card board) or river subgame solved with discounted CFR: bets and raises are pot "
+        "fractions, target the exploitability to stop at as a fraction of the pot. Turn spots deal the river "
+        "at chance nodes, suit-isomorphic rivers solved once, river subtrees in parallel. Returns a dict with "
+        "hands and ev per player (out of position first), the betting tree as nodes (root first) with average "
+        "strategies (on the river only for river, as the card it is solved as), rivers, value, "
+        "exploitability and iterations.");
+
+  m.def("subgame_size",
+        [](const std::vector<int>& board, const std::string& oop_range, const std::string& ip_range, double pot,
+           double stack, const std::vector<double>& bets, const std::vector<double>& raises, int max_raises,
+           bool all_in) {
+          const poker_sim::SubgameSize size = poker_sim::subgame_size(
+              subgame_spot(board, oop_range, ip_range, pot, stack, bets, raises, max_raises, all_in));
+          py::dict out;
+          out["nodes"] = size.nodes;
+          out["hands"] = py::make_tuple(size.hands[0], size.hands[1]);
+          return out;
+        },
+        py::arg("board"),
+        py::arg("oop_range"),
+        py::arg("ip_range"),
+        py::arg("pot"),
+        py::arg("stack"),
+        py::arg("bets") = std::vector<double>{0.5, 1.0},
+        py::arg("raises") = std::vector<double>{1.0},
+        py::arg("max_raises") = 2,
+        py::arg("all_in") = true,
+        "Size of a solve_subgame spot without solving it: nodes in the betting tree (river subtrees once per "
+        "river class) and hands, the live holdings of each range. An iteration costs about nodes x (hands[0] + "
+        "hands[1]).");
+
+  m.def("self_play",
+        [](const std::vector<std::string>& bots, std::uint64_t num_hands, double stack,
+           const std::vector<double>& stacks, double small_blind, py::object seed_obj, unsigned num_threads) {
+          poker_sim::SelfPlayConfig config;
+          for (const auto& name : bots) config.bots.push_back(poker_sim::bot_policy(name));
+          config.num_hands = num_hands;
+          config.stack = stack;
+          config.stacks = stacks;
+          config.small_blind = small_blind;
+          if (!seed_obj.is_none()) config.seed = static_cast<unsigned>(py::cast<int>(seed_obj));
+          config.num_threads = num_threads;
+          const poker_sim::SelfPlayResult r = poker_sim::self_play(config);
+          py::list seats;
+          for (std::size_t i = 0; i < r.seats.size(); ++i) {
+            py::dict seat;
+            seat["bot"] = bots[i];
+            seat["bb_per_100"] = r.seats[i].bb_per_100;
+            seat["ci95"] = r.seats[i].ci95;
+            seat["won"] = r.seats[i].won;
+            seats.append(seat);
+          }
+          py::dict out;
+          out["seats"] = seats;
+          out["hands"] = r.hands;
+          return out;
+        },
+        py::arg("bots"),
+        py::arg("num_hands") = 100000,
+        py::arg("stack") = 100.0,
+        py::arg("stacks") = std::vector<double>{},
+        py::arg("small_blind") = 0.5,
+        py::arg("seed") = py::none(),
+        py::arg("num_threads") = 0,
+        "No-limit self-play between built-in bots (station, maniac, random, rock, tag, lag), one per seat, "
+        "each hand from the starting stacks (bb) with the button moving every hand. Returns seats "
+        "(bot, bb_per_100, ci95, won) and hands.");
+
+  m.def("clear_hand_strength_cache", &poker_sim::clear_hand_strength_cache,
+        "Empty the hand_strength result cache.");
+
+  m.def("hand_index",
+        [](const std::vector<int>& hole_cards, const std::vector<int>& board) {
+          return poker_sim::street_index(to_cards(hole_cards), to_cards(board));
+        },
+        py::arg("hole_cards"),
+        py::arg("board") = std::vector<int>{},
+        "Dense suit-isomorphism class of (hole_cards, board) on its street (board of 0, 3, 4 or 5 cards).");
+
+  m.def("hand_unindex",
+        [](std::size_t board_size, std::uint64_t index) {
+          auto deal = poker_sim::street_unindex(poker_sim::street_of_board(board_size), index);
+          return py::make_tuple(std::vector<int>(deal.first.begin(), deal.first.end()),
+                                std::vector<int>(deal.second.begin(), deal.second.end()));
+        },
+        py::arg("board_size"),
+        py::arg("index"),
+        "Canonical (hole_cards, board) of a hand_index class for a board of board_size cards.");
+
+  m.def("hand_index_size",
+        [](std::size_t board_size) {
+          return poker_sim::street_indexer(poker_sim::street_of_board(board_size)).size();
+        },
+        py::arg("board_size"),
+        "Number of hand_index classes for a board of 0, 3, 4 or 5 cards.");
+
+  m.def("evaluate_hand",
+        [](const std::vector<int>& cards) {
+          if (cards.size() < 5 || cards.size() > 7)
+            throw std::invalid_argument("evaluate_hand needs 5-7 cards");
+          std::vector<uint8_t> c = to_cards(cards);
+          if (__builtin_popcountll(poker_sim::card_mask(c)) != static_cast<int>(c.size()))
+            throw std::invalid_argument("evaluate_hand cards must be distinct");
+          return poker_sim::evaluate_hand(c.data(), static_cast<int>(c.size()));
+        },
+        py::arg("cards"),
+        "Packed hand strength (category << 20 | five 4-bit tiebreak ranks) of 5-7 distinct cards; "
+        "higher is stronger.");
 }
@@ -0,0 +1,253 @@
+#include "poker_sim/buckets.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/hand_strength.hpp"
+#include "poker_sim/parallel.hpp"
+#include "poker_sim/range.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+/// Runouts behind each flop feature vector: C(47, 2).
+constexpr unsigned kFlopRunouts = 1081;
+
+/// k-means++ seeding looks at this many sampled points per bucket.
+constexpr std::size_t kSeedSamplesPerBucket = 64;
+
+/// Work units of one Lloyd step; partial sums are reduced in this order, so
+/// results do not depend on the thread count. Fewer when the per-chunk
+/// centroid sums would pass kMaxChunkSums doubles in total.
+constexpr std::size_t kChunks = 256;
+constexpr std::size_t kMaxChunkSums = std::size_t{1} << 24;
+
+/// Layout version of bucket tables (TableKind::BUCKETS).
+constexpr std::uint32_t kBucketTableVersion = 1;
+
+float squared_distance(const std::uint16_t* point, const float* centroid, unsigned dims, float scale) {
+  float d = 0;
+  for (unsigned j = 0; j < dims; ++j) {
+    const float x = point[j] * scale - centroid[j];
+    d += x * x;
+  }
+  return d;
+}
+
+}  // namespace
+
+FlopFeatures compute_flop_features(unsigned bins, unsigned num_threads) {
+  if (bins < 1 || bins > 100) throw std::invalid_argument("bins must be 1-100");
+  const HandIndexer flops({3});
+  const HandIndexer& pairs = street_indexer(Street::FLOP);
+
+  // Raw flops per canonical flop.
+  std::vector<std::uint32_t> orbit(flops.size());
+  uint8_t cards[5];
+  for (cards[0] = 0; cards[0] < 52; ++cards[0])
+    for (cards[1] = cards[0] + 1; cards[1] < 52; ++cards[1])
+      for (cards[2] = cards[1] + 1; cards[2] < 52; ++cards[2]) ++orbit[flops.index(cards)];
+
+  FlopFeatures out;
+  out.bins = bins;
+  out.cumulative.assign(pairs.size() * bins, 0);
+  out.weights.assign(pairs.size(), 0.0);
+  // Each flop class owns the pair classes built on it, so workers never
+  // write the same row.
+  parallel_for(flops.size(), num_threads, [&](std::size_t f) {
+    std::vector<uint8_t> flop(3);
+    flops.unindex(f, flop.data());
+    std::vector<std::uint16_t> hist(static_cast<std::size_t>(kNumCombos) * bins);
+    flop_strength_histograms(flop, bins, hist.data());
+    const std::uint64_t flop_mask = card_mask(flop);
+    uint8_t deal[5] = {0, 0, flop[0], flop[1], flop[2]};
+    for (int c = 0; c < kNumCombos; ++c) {
+      if (combo_mask(c) & flop_mask) continue;
+      const auto hc = combo_cards(c);
+      deal[0] = hc.first;
+      deal[1] = hc.second;
+      const std::uint64_t idx = pairs.index(deal);
+      if (out.weights[idx] == 0) {
+        std::uint16_t* row = &out.cumulative[idx * bins];
+        std::uint16_t sum = 0;
+        for (unsigned b = 0; b < bins; ++b) row[b] = sum += hist[static_cast<std::size_t>(c) * bins + b];
+      }
+      out.weights[idx] += orbit[f];
+    }
+  });
+  return out;
+}
+
+Clustering cluster_features(const FlopFeatures& features,
+                            unsigned buckets,
+                            unsigned iterations,
+                            unsigned seed,
+                            unsigned num_threads) {
+  const std::size_t n = features.size();
+  const unsigned dims = features.bins;
+  if (buckets < 1 || buckets > 65535) throw std::invalid_argument("buckets must be 1-65535");
+  if (n < buckets) throw std::invalid_argument("fewer points than buckets");
+  const float scale = 1.0f / kFlopRunouts;
+  auto point = [&](std::size_t i) { return &features.cumulative[i * dims]; };
+
+  // k-means++ on a uniform sample, each pick weighted by deal count x D^2.
+  std::mt19937_64 rng(seed);
+  std::vector<std::size_t> sample;
+  const std::size_t sample_size = std::min<std::size_t>(n, kSeedSamplesPerBucket * buckets);
+  if (sample_size == n) {
+    for (std::size_t i = 0; i < n; ++i) sample.push_back(i);
+  } else {
+    std::uniform_int_distribution<std::size_t> any(0, n - 1);
+    for (std::size_t i = 0; i < sample_size; ++i) sample.push_back(any(rng));
+  }
+  Clustering out;
+  out.centroids.assign(static_cast<std::size_t>(buckets) * dims, 0.0f);
+  std::vector<double> nearest(sample.size(), std::numeric_limits<double>::infinity());
+  std::size_t pick = sample[std::uniform_int_distribution<std::size_t>(0, sample.size() - 1)(rng)];
+  for (unsigned k = 0; k < buckets; ++k) {
+    float* c = &out.centroids[static_cast<std::size_t>(k) * dims];
+    for (unsigned j = 0; j < dims; ++j) c[j] = point(pick)[j] * scale;
+    double total = 0;
+    for (std::size_t s = 0; s < sample.size(); ++s) {
+      nearest[s] = std::min<double>(nearest[s], squared_distance(point(sample[s]), c, dims, scale));
+      total += nearest[s] * features.weights[sample[s]];
+    }
+    if (total <= 0) break;  // fewer distinct points than buckets: the rest stay at zero
+    double target = std::uniform_real_distribution<double>(0, total)(rng);
+    for (std::size_t s = 0; s < sample.size(); ++s) {
+      target -= nearest[s] * features.weights[sample[s]];
+      pick = sample[s];
+      if (target <= 0 && nearest[s] > 0) break;
+    }
+  }
+
+  // Lloyd iterations with Hamerly's bounds: each point keeps an upper bound
+  // on the distance to its centroid and a lower bound on the distance to
+  // any other, and is only rescanned when they cross. Chunk sums are
+  // reduced in chunk order.
+  out.assignment.assign(n, 0);
+  const std::size_t chunks =
+      std::max<std::size_t>(1, std::min({kChunks, n, kMaxChunkSums / (static_cast<std::size_t>(buckets) * dims)}));
+  std::vector<double> sums(chunks * buckets * dims), mass(chunks * buckets);
+  std::vector<std::size_t> moved(chunks);
+  std::vector<float> upper(n), lower(n), half_gap(buckets), drift(buckets), previous(out.centroids.size());
+  float max_drift = 0;
+  auto centroid = [&](unsigned k) { return &out.centroids[static_cast<std::size_t>(k) * dims]; };
+  for (unsigned it = 0; it < iterations; ++it) {
+    parallel_for(buckets, num_threads, [&](std::size_t k) {
+      float nearest_other = std::numeric_limits<float>::infinity();
+      for (unsigned o = 0; o < buckets; ++o) {
+        if (o == k) continue;
+        float d = 0;
+        for (unsigned j = 0; j < dims; ++j) d += (centroid(k)[j] - centroid(o)[j]) * (centroid(k)[j] - centroid(o)[j]);
+        nearest_other = std::min(nearest_other, d);
+      }
+      half_gap[k] = std::sqrt(nearest_other) / 2;
+    });
+    std::fill(sums.begin(), sums.end(), 0.0);
+    std::fill(mass.begin(), mass.end(), 0.0);
+    parallel_for(chunks, num_threads, [&](std::size_t ch) {
+      double* s = &sums[ch * buckets * dims];
+      double* m = &mass[ch * buckets];
+      std::size_t chunk_moved = 0;
+      for (std::size_t i = n * ch / chunks; i < n * (ch + 1) / chunks; ++i) {
+        const std::uint16_t* p = point(i);
+        unsigned a = out.assignment[i];
+        bool scan = it == 0;
+        if (!scan) {
+          upper[i] += drift[a];
+          lower[i] -= max_drift;
+          const float bound = std::max(half_gap[a], lower[i]);
+          if (upper[i] > bound) {
+            upper[i] = std::sqrt(squared_distance(p, centroid(a), dims, scale));
+            scan = upper[i] > bound;
+          }
+        }
+        if (scan) {
+          float best = std::numeric_limits<float>::infinity(), second = best;
+          unsigned best_k = 0;
+          for (unsigned k = 0; k < buckets; ++k) {
+            const float d = squared_distance(p, centroid(k), dims, scale);
+            if (d < best) {
+              second = best;
+              best = d;
+              best_k = k;
+            } else if (d < second) {
+              second = d;
+            }
+          }
+          if (it == 0 || best_k != a) ++chunk_moved;
+          a = best_k;
+          out.assignment[i] = static_cast<std::uint16_t>(a);
+          upper[i] = std::sqrt(best);
+          lower[i] = std::sqrt(second);
+        }
+        const double w = features.weights[i];
+        for (unsigned j = 0; j < dims; ++j) s[a * dims + j] += w * p[j];
+        m[a] += w;
+      }
+      moved[ch] = chunk_moved;
+    });
+    std::size_t total_moved = 0;
+    for (std::size_t ch = 0; ch < chunks; ++ch) total_moved += moved[ch];
+    previous = out.centroids;
+    max_drift = 0;
+    for (unsigned k = 0; k < buckets; ++k) {
+      double m = 0;
+      for (std::size_t ch = 0; ch < chunks; ++ch) m += mass[ch * buckets + k];
+      drift[k] = 0;
+      if (m <= 0) continue;  // empty bucket keeps its centroid
+      float d = 0;
+      for (unsigned j = 0; j < dims; ++j) {
+        double sum = 0;
+        for (std::size_t ch = 0; ch < chunks; ++ch) sum += sums[(ch * buckets + k) * dims + j];
+        centroid(k)[j] = static_cast<float>(sum / m * scale);
+        const float delta = centroid(k)[j] - previous[static_cast<std::size_t>(k) * dims + j];
+        d += delta * delta;
+      }
+      drift[k] = std::sqrt(d);
+      max_drift = std::max(max_drift, drift[k]);
+    }
+    out.iterations = it + 1;
+    if (total_moved == 0) break;
+  }
+
+  std::vector<double> cost(chunks), weight(chunks);
+  parallel_for(chunks, num_threads, [&](std::size_t ch) {
+    for (std::size_t i = n * ch / chunks; i < n * (ch + 1) / chunks; ++i) {
+      cost[ch] += features.weights[i] * squared_distance(point(i), centroid(out.assignment[i]), dims, scale);
+      weight[ch] += features.weights[i];
+    }
+  });
+  double total_cost = 0, total_weight = 0;
+  for (std::size_t ch = 0; ch < chunks; ++ch) {
+    total_cost += cost[ch];
+    total_weight += weight[ch];
+  }
+  out.inertia = total_weight > 0 ? total_cost / total_weight : 0;
+  return out;
+}
+
+void write_bucket_file(const std::string& path,
+                       const std::vector<int>& cards_per_round,
+                       const std::vector<std::uint16_t>& assignment,
+                       unsigned buckets,
+                       bool compress) {
+  if (cards_per_round.empty() || cards_per_round.size() > 4)
+    throw std::invalid_argument("bucket file needs 1-4 rounds");
+  TableWriter writer(TableKind::BUCKETS, kBucketTableVersion, cards_per_round, {buckets});
+  writer.add_section("buckets", assignment.data(), assignment.size() * sizeof(std::uint16_t), compress);
+  writer.write(path);
+}
+
+BucketTable::BucketTable(const std::string& path)
+    : file_(path, TableKind::BUCKETS, kBucketTableVersion), indexer_(file_.cards_per_round()) {
+  data_ = file_.array<std::uint16_t>("buckets", indexer_.size());
+  entries_ = indexer_.size();
+  buckets_ = static_cast<unsigned>(file_.params()[0]);
+}
+
+}  // namespace poker_sim
@@ -0,0 +1,270 @@
+#include "poker_sim/equity_grid.hpp"
+#include "poker_sim/flop_equity.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/parallel.hpp"
+#include "poker_sim/preflop_matrix.hpp"
+#include "poker_sim/simulation.hpp"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+/// Work units; each has its own random stream.
+constexpr std::uint32_t kChunks = 16;
+
+struct Holding {
+  uint8_t a, b;
+  int cls;
+  std::uint64_t mask;
+};
+
+/// Sorts keys rank << 11 | holding by rank: three byte-wide LSD counting
+/// passes over the 24-bit rank, several times faster than std::sort on ~1000 keys.
+void sort_by_rank(std::uint64_t* keys, int n) {
+  std::uint64_t tmp[kNumCombos];
+  std::uint64_t* from = keys;
+  std::uint64_t* to = tmp;
+  for (int shift = 11; shift < 35; shift += 8) {
+    int count[257] = {};
+    for (int i = 0; i < n; ++i) ++count[(from[i] >> shift & 0xFF) + 1];
+    for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+    for (int i = 0; i < n; ++i) to[count[from[i] >> shift & 0xFF]++] = from[i];
+    std::swap(from, to);
+  }
+  std::copy(from, from + n, keys);
+}
+
+/// Pot shares (kPotShareUnit per pot) and opponent deals per live holding.
+struct Tally {
+  std::vector<std::uint64_t> share, deals;
+  explicit Tally(std::size_t n) : share(n), deals(n) {}
+};
+
+class GridSolver {
+ public:
+  GridSolver(const std::vector<uint8_t>& board, std::uint64_t known, int num_opponents)
+      : board_(board), opponents_(num_opponents), need_(5 - static_cast<int>(board.size())) {
+    for (int c = 0; c < 52; ++c)
+      if (!(known >> c & 1)) deck_.push_back(static_cast<uint8_t>(c));
+    for (int i = 0; i < kNumCombos; ++i) {
+      if (combo_mask(i) & known) continue;
+      const auto hc = combo_cards(i);
+      holdings_.push_back({hc.first, hc.second, preflop_class(hc.first, hc.second), combo_mask(i)});
+    }
+  }
+
+  const std::vector<uint8_t>& deck() const { return deck_; }
+  const std::vector<Holding>& holdings() const { return holdings_; }
+  int need() const { return need_; }
+
+  /// Scores every holding not blocked by the runout (need() cards).
+  void score(const uint8_t* runout, std::mt19937& rng, Tally& t) const {
+    // The full board is added once; each holding adds its two cards to a copy.
+    HandState full;
+    for (uint8_t c : board_) full.add(c);
+    std::uint64_t dealt = 0;
+    for (int k = 0; k < need_; ++k) {
+      full.add(runout[k]);
+      dealt |= 1ull << runout[k];
+    }
+    std::uint64_t order[kNumCombos];  // rank << 11 | holding
+    int n = 0;
+    for (std::size_t h = 0; h < holdings_.size(); ++h) {
+      if (holdings_[h].mask & dealt) continue;
+      HandState hand = full;
+      hand.add(holdings_[h].a);
+      hand.add(holdings_[h].b);
+      order[n++] = static_cast<std::uint64_t>(hand.rank()) << 11 | h;
+    }
+    if (opponents_ == 1) sweep(order, n, t);
+    else deal(order, n, full, dealt, rng, t);
+  }
+
+ private:
+  /// Heads-up: every opponent holding, via the strength-ordered sweep.
+  void sweep(std::uint64_t* order, int n, Tally& t) const {
+    sort_by_rank(order, n);
+    const std::uint64_t left = deck_.size() - need_ - 2;
+    const std::uint64_t opponents = left * (left - 1) / 2;
+    int below = 0, below_card[52] = {}, group_card[52] = {};
+    for (int g = 0; g < n;) {
+      int e = g;
+      while (e < n && (order[e] >> 11) == (order[g] >> 11)) ++e;
+      for (int i = g; i < e; ++i) {
+        const Holding& h = holdings_[order[i] & 0x7FF];
+        ++group_card[h.a];
+        ++group_card[h.b];
+      }
+      // A holding counts itself once in the group and once per card.
+      for (int i = g; i < e; ++i) {
+        const std::size_t idx = order[i] & 0x7FF;
+        const Holding& h = holdings_[idx];
+        const int wins = below - below_card[h.a] - below_card[h.b];
+        const int ties = (e - g) - group_card[h.a] - group_card[h.b] + 1;
+        t.share[idx] += static_cast<std::uint64_t>(wins) * kPotShareUnit + static_cast<std::uint64_t>(ties) * (kPotShareUnit / 2);
+        t.deals[idx] += opponents;
+      }
+      for (int i = g; i < e; ++i) {
+        const Holding& h = holdings_[order[i] & 0x7FF];
+        group_card[h.a] = group_card[h.b] = 0;
+        ++below_card[h.a];
+        ++below_card[h.b];
+      }
+      below += e - g;
+      g = e;
+    }
+  }
+
+  /// Multiway: random opponent deals shared by every unblocked holding.
+  void deal(const std::uint64_t* order, int n, const HandState& full, std::uint64_t dealt, std::mt19937& rng,
+            Tally& t) const {
+    uint8_t rest[52];
+    int m = 0;
+    for (uint8_t c : deck_)
+      if (!(dealt >> c & 1)) rest[m++] = c;
+    for (int d = 0; d < kGridOpponentDeals; ++d) {
+      HandRank best = 0;
+      int tied = 0;
+      std::uint64_t blocked = 0;
+      for (int o = 0; o < opponents_; ++o) {
+        for (int k = 2 * o; k < 2 * o + 2; ++k) {
+          std::swap(rest[k], rest[k + std::uniform_int_distribution<int>(0, m - k - 1)(rng)]);
+          blocked |= 1ull << rest[k];
+        }
+        HandState hand = full;
+        hand.add(rest[2 * o]);
+        hand.add(rest[2 * o + 1]);
+        const HandRank r = hand.rank();
+        if (r > best) {
+          best = r;
+          tied = 1;
+        } else if (r == best) {
+          ++tied;
+        }
+      }
+      for (int i = 0; i < n; ++i) {
+        const std::size_t idx = order[i] & 0x7FF;
+        if (holdings_[idx].mask & blocked) continue;
+        const HandRank r = static_cast<HandRank>(order[i] >> 11);
+        t.share[idx] += r > best ? kPotShareUnit : r == best ? kPotShareUnit / (tied + 1) : 0;
+        ++t.deals[idx];
+      }
+    }
+  }
+
+  std::vector<uint8_t> board_;
+  int opponents_;
+  int need_;
+  std::vector<uint8_t> deck_;
+  std::vector<Holding> holdings_;
+};
+
+/// Averages per-holding equities into their classes.
+void average(EquityGrid& grid, const std::vector<Holding>& holdings, const std::vector<double>& equity) {
+  for (std::size_t h = 0; h < holdings.size(); ++h) {
+    grid.equity[holdings[h].cls] += equity[h];
+    ++grid.holdings[holdings[h].cls];
+  }
+  for (int c = 0; c < kNumPreflopClasses; ++c)
+    if (grid.holdings[c]) grid.equity[c] /= grid.holdings[c];
+}
+
+}  // namespace
+
+EquityGrid equity_grid(const std::vector<uint8_t>& board,
+                       int num_opponents,
+                       std::uint32_t num_trials,
+                       unsigned seed,
+                       std::uint64_t dead_mask,
+                       unsigned num_threads) {
+  if (board.size() != 0 && board.size() != 3 && board.size() != 4 && board.size() != 5)
+    throw std::invalid_argument("board must have 0, 3, 4, or 5 cards");
+  if (num_opponents < 1 || num_opponents > 8) throw std::invalid_argument("num_opponents must be 1-8");
+  if (num_trials == 0) throw std::invalid_argument("num_trials must be positive");
+  std::uint64_t known = 0;
+  for (uint8_t c : board) {
+    if (c > 51) throw std::invalid_argument("card index out of range 0-51");
+    if (known >> c & 1) throw std::invalid_argument("board cards must be distinct");
+    known |= 1ull << c;
+  }
+  if (dead_mask >> 52) throw std::invalid_argument("dead card index out of range 0-51");
+  if (dead_mask & known) throw std::invalid_argument("dead cards must not overlap the board");
+  known |= dead_mask;
+
+  const GridSolver solver(board, known, num_opponents);
+  const std::vector<Holding>& holdings = solver.holdings();
+  const int d = static_cast<int>(solver.deck().size());
+  const int need = solver.need();
+  if (need + 2 + 2 * num_opponents > d) throw std::invalid_argument("not enough cards in deck for this configuration");
+
+  EquityGrid grid;
+  std::vector<double> equity(holdings.size());
+  if (dead_mask == 0 && board.empty() && num_opponents == 1) {
+    if (const auto matrix = preflop_matrix()) {
+      for (std::size_t h = 0; h < holdings.size(); ++h) equity[h] = matrix->versus_random(holdings[h].cls).equity();
+      average(grid, holdings, equity);
+      grid.exact = true;
+      grid.runouts = kPreflopBoards;
+      return grid;
+    }
+  }
+  if (dead_mask == 0 && board.size() == 3 && num_opponents <= kFlopEquityMaxOpponents) {
+    if (const auto table = flop_equity_table()) {
+      for (std::size_t h = 0; h < holdings.size(); ++h)
+        equity[h] = table->lookup({holdings[h].a, holdings[h].b}, board, num_opponents).equity();
+      average(grid, holdings, equity);
+      grid.exact = true;
+      grid.runouts = static_cast<std::uint64_t>(d - 2) * (d - 3) / 2;
+      return grid;
+    }
+  }
+
+  double runouts = 1;
+  for (int k = 0; k < need; ++k) runouts = runouts * (d - k) / (k + 1);
+  const bool enumerate = need <= 2 && runouts <= num_trials;
+  std::vector<std::array<uint8_t, 2>> listed;
+  if (enumerate) {
+    const auto& deck = solver.deck();
+    if (need == 0) listed.push_back({0, 0});
+    for (int i = 0; i < d && need >= 1; ++i) {
+      if (need == 1) listed.push_back({deck[i], 0});
+      else
+        for (int j = i + 1; j < d; ++j) listed.push_back({deck[i], deck[j]});
+    }
+  }
+  const std::uint64_t total = enumerate ? listed.size() : num_trials;
+
+  std::vector<Tally> parts(kChunks, Tally(holdings.size()));
+  parallel_for(kChunks, num_threads, [&](std::size_t chunk) {
+    std::mt19937 rng((seed != 0 ? seed : 12345u) + static_cast<unsigned>(chunk) * 0x9E3779B9u);
+    if (enumerate) {
+      for (std::size_t i = chunk; i < listed.size(); i += kChunks) solver.score(listed[i].data(), rng, parts[chunk]);
+      return;
+    }
+    // Partial Fisher-Yates draws a uniform runout from any deck order.
+    uint8_t buf[52];
+    std::copy(solver.deck().begin(), solver.deck().end(), buf);
+    for (std::uint64_t i = chunk; i < total; i += kChunks) {
+      for (int k = 0; k < need; ++k) std::swap(buf[k], buf[k + std::uniform_int_distribution<int>(0, d - k - 1)(rng)]);
+      solver.score(buf, rng, parts[chunk]);
+    }
+  });
+
+  std::vector<std::uint64_t> share(holdings.size()), deals(holdings.size());
+  for (const Tally& t : parts)
+    for (std::size_t h = 0; h < holdings.size(); ++h) {
+      share[h] += t.share[h];
+      deals[h] += t.deals[h];
+    }
+  for (std::size_t h = 0; h < holdings.size(); ++h)
+    equity[h] = deals[h] ? static_cast<double>(share[h]) / (static_cast<double>(deals[h]) * kPotShareUnit) : 0.0;
+  average(grid, holdings, equity);
+  grid.exact = enumerate && num_opponents == 1;
+  grid.runouts = total;
+  return grid;
+}
+
+}  // namespace poker_sim
@@ -0,0 +1,347 @@
+#include "poker_sim/flop_equity.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/hand_index.hpp"
+#include "poker_sim/parallel.hpp"
+#include "poker_sim/range.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+/// Layout version of flop equity tables (TableKind::FLOP_EQUITY).
+constexpr std::uint32_t kFlopEquityTableVersion = 1;
+constexpr double kScale = 65535.0;
+
+/// Cards left beside a river board, and the holdings they form.
+constexpr int kLive = 47;
+constexpr int kPairs = kLive * (kLive - 1) / 2;  // also the runouts of a flop
+
+/// Unordered sets of k disjoint opponent holdings from the 45 cards left
+/// beside a river board and the hero: 990, 990*903/2, 990*903*820/6.
+constexpr double kDeals[kFlopEquityMaxOpponents + 1] = {1, 990, 446985, 122175900};
+
+/// Offset of the distribution for `opponents` within a class's values.
+constexpr int value_offset(int opponents) { return opponents * (opponents + 1) / 2 - 1; }
+
+/// Boards swept per work unit.
+constexpr std::size_t kBoardsPerChunk = 64;
+
+/// Weighted graph on the live cards of a river board, one edge per holding,
+/// with running sums that give the weighted number of 1-, 2- and 3-edge
+/// matchings (sets of disjoint holdings) once any two vertices, the hero's
+/// cards, are deleted. Matchings of 3 follow by inclusion-exclusion over
+/// pairs of edges sharing a card: stars, paths and triangles.
+class MatchingCounter {
+ public:
+  void clear() { std::memset(this, 0, sizeof *this); }
+
+  /// Sets the weight of edge (p, q).
+  void set(int p, int q, double weight) {
+    const double old = w_[p][q], delta = weight - old;
+    // Triangles through (p, q); the old sq_[p][q] never involves w_[p][q].
+    const double through = sq_[p][q];
+    for (int r = 0; r < kLive; ++r) tri_[r] += delta * w_[p][r] * w_[q][r];
+    tri_[p] += delta * through;
+    tri_[q] += delta * through;
+    triangles_ += delta * through;
+    // (W + delta E)^2 = W^2 + delta (W E + E W) + delta^2 E^2, E = e_p e_q' + e_q e_p'.
+    for (int u = 0; u < kLive; ++u) {
+      sq_[u][q] += delta * w_[u][p];
+      sq_[u][p] += delta * w_[u][q];
+      sq_[p][u] += delta * w_[q][u];
+      sq_[q][u] += delta * w_[p][u];
+      nd_[u] += delta * (w_[u][p] + w_[u][q]);
+    }
+    sq_[p][p] += delta * delta;
+    sq_[q][q] += delta * delta;
+    nd_[p] += delta * (d_[q] + delta);
+    nd_[q] += delta * (d_[p] + delta);
+    d_[p] += delta;
+    d_[q] += delta;
+    q_[p] += weight * weight - old * old;
+    q_[q] += weight * weight - old * old;
+    c_[p] += weight * weight * weight - old * old * old;
+    c_[q] += weight * weight * weight - old * old * old;
+    w_[p][q] = w_[q][p] = weight;
+  }
+
+  /// Weighted matchings of 1, 2 and 3 edges avoiding vertices a and b.
+  void count(int a, int b, double out[3]) const {
+    const double* wa = w_[a];
+    const double* wb = w_[b];
+    const double* sa = sq_[a];
+    const double* sb = sq_[b];
+    const double da = d_[a], db = d_[b], wab = wa[b];
+    // Degree moments and sum over edges of w_uv d_u d_v, after the deletion.
+    double sd = 0, sq = 0, sc = 0, sdd = 0, sdq = 0, sddd = 0, path = 0;
+    for (int v = 0; v < kLive; ++v) {
+      if (v == a || v == b) continue;
+      const double dv = d_[v] - wa[v] - wb[v];
+      const double qv = q_[v] - wa[v] * wa[v] - wb[v] * wb[v];
+      const double cv = c_[v] - wa[v] * wa[v] * wa[v] - wb[v] * wb[v] * wb[v];
+      const double nd = nd_[v] - wa[v] * da - wb[v] * db - (sa[v] - wb[v] * wab) - (sb[v] - wa[v] * wab);
+      sd += dv;
+      sq += qv;
+      sc += cv;
+      sdd += dv * dv;
+      sdq += dv * qv;
+      sddd += dv * dv * dv;
+      path += dv * nd;
+    }
+    const double s1 = sd / 2, s2 = sq / 2, s3 = sc / 2, p = path / 2;
+    const double triangles = triangles_ - tri_[a] - tri_[b] + wab * sa[b];
+    out[0] = s1;
+    out[1] = (s1 * s1 - s2) / 2 - (sdd - sq) / 2;
+    const double all = (s1 * s1 * s1 - 3 * s1 * s2 + 2 * s3) / 6;
+    const double one_shared = s1 * (sdd - sq) / 2 - (sdq - sc);
+    const double two_shared = (sddd + 2 * p - 5 * sdq + 6 * s3) / 2;
+    const double three_shared = (sddd - 3 * sdq + 2 * sc) / 6 + triangles;
+    out[2] = all - one_shared + two_shared - three_shared;
+  }
+
+ private:
+  double w_[kLive][kLive];   // edge weights
+  double sq_[kLive][kLive];  // W^2
+  double d_[kLive], q_[kLive], c_[kLive];  // sums of w, w^2, w^3 at each vertex
+  double nd_[kLive];   // sum over neighbours of w_uv d_v
+  double tri_[kLive];  // weighted triangles at each vertex
+  double triangles_;
+};
+
+/// Outcome counts of every hero holding on one river board.
+struct BoardSweep {
+  MatchingCounter below;  // holdings weaker than the hero's group, then with it
+  MatchingCounter third, two_thirds;  // the hero's group weighted 1/3, 2/3
+  std::uint64_t order[kPairs];  // rank << 11 | pair
+  uint8_t first[kPairs], second[kPairs];  // live-card positions of each pair
+  std::uint32_t counts[kPairs][kFlopEquityValues];
+
+  BoardSweep() {
+    for (int j = 0, p = 0; j < kLive; ++j)
+      for (int i = 0; i < j; ++i, ++p) {
+        first[p] = static_cast<uint8_t>(i);
+        second[p] = static_cast<uint8_t>(j);
+      }
+  }
+
+  /// Fills counts[pair][value_offset(k) + j]: opponent sets of size k with
+  /// none ahead of the pair and j tied. Weighting tied holdings by x makes
+  /// the matching count a polynomial in x whose x^j coefficient is exactly
+  /// that; four weights 0, 1/3, 2/3, 1 pin down the cubic.
+  void run(const uint8_t* board, const uint8_t* live) {
+    uint8_t cards[7];
+    std::copy(board, board + 5, cards);
+    for (int p = 0; p < kPairs; ++p) {
+      cards[5] = live[first[p]];
+      cards[6] = live[second[p]];
+      order[p] = static_cast<std::uint64_t>(evaluate_hand(cards, 7)) << 11 | p;
+    }
+    std::sort(order, order + kPairs);
+    below.clear();
+    third.clear();
+    two_thirds.clear();
+
+    double at[4][3];  // matchings of 1-3 holdings at each weight
+    for (int g = 0; g < kPairs;) {
+      int e = g;
+      while (e < kPairs && (order[e] >> 11) == (order[g] >> 11)) ++e;
+      for (int i = g; i < e; ++i) {
+        const int p = order[i] & 0x7FF;
+        below.count(first[p], second[p], untied_[p]);
+      }
+      for (int i = g; i < e; ++i) {
+        const int p = order[i] & 0x7FF;
+        below.set(first[p], second[p], 1.0);
+        third.set(first[p], second[p], 1.0 / 3);
+        two_thirds.set(first[p], second[p], 2.0 / 3);
+      }
+      for (int i = g; i < e; ++i) {
+        const int p = order[i] & 0x7FF;
+        std::copy(untied_[p], untied_[p] + 3, at[0]);
+        third.count(first[p], second[p], at[1]);
+        two_thirds.count(first[p], second[p], at[2]);
+        below.count(first[p], second[p], at[3]);
+        for (int k = 1; k <= kFlopEquityMaxOpponents; ++k) {
+          // Newton forward differences at t = 0..3, x = t / 3.
+          const double f0 = at[0][k - 1], f1 = at[1][k - 1], f2 = at[2][k - 1], f3 = at[3][k - 1];
+          const double d1 = f1 - f0, d2 = f2 - 2 * f1 + f0, d3 = f3 - 3 * f2 + 3 * f1 - f0;
+          const double coef[4] = {f0, 3 * (d1 - d2 / 2 + d3 / 3), 9 * (d2 - d3) / 2, 27 * d3 / 6};
+          for (int j = 0; j <= k; ++j)
+            counts[p][value_offset(k) + j] = static_cast<std::uint32_t>(std::max(0.0, std::round(coef[j])));
+        }
+      }
+      for (int i = g; i < e; ++i) {
+        const int p = order[i] & 0x7FF;
+        third.set(first[p], second[p], 1.0);
+        two_thirds.set(first[p], second[p], 1.0);
+      }
+      g = e;
+    }
+  }
+
+ private:
+  double untied_[kPairs][3];  // counts with the hero's group still out
+};
+
+/// The 24 relabellings of the suits.
+struct SuitPermutations {
+  std::array<std::array<uint8_t, 4>, 24> perm;
+  SuitPermutations() {
+    std::array<uint8_t, 4> p = {0, 1, 2, 3};
+    int i = 0;
+    do perm[i++] = p;
+    while (std::next_permutation(p.begin(), p.end()));
+  }
+};
+
+const SuitPermutations kSuitPermutations;
+
+inline uint8_t relabel(uint8_t card, const std::array<uint8_t, 4>& perm) {
+  return static_cast<uint8_t>(perm[card_suit(card)] * 13 + card_rank(card));
+}
+
+std::mutex g_table_mutex;
+std::shared_ptr<const FlopEquityTable> g_table;
+
+}  // namespace
+
+std::vector<std::uint16_t> compute_flop_equity(unsigned num_threads) {
+  const HandIndexer boards({5}), flops({3});
+  const HandIndexer& pairs = street_indexer(Street::FLOP);
+
+  // Raw boards per canonical river board.
+  std::vector<std::uint32_t> orbit(boards.size());
+  uint8_t raw[5];
+  for (raw[0] = 0; raw[0] < 52; ++raw[0])
+    for (raw[1] = raw[0] + 1; raw[1] < 52; ++raw[1])
+      for (raw[2] = raw[1] + 1; raw[2] < 52; ++raw[2])
+        for (raw[3] = raw[2] + 1; raw[3] < 52; ++raw[3])
+          for (raw[4] = raw[3] + 1; raw[4] < 52; ++raw[4]) ++orbit[boards.index(raw)];
+
+  // Class of each hole holding on each canonical flop.
+  std::vector<std::uint32_t> class_of(flops.size() * kNumCombos);
+  std::vector<std::uint64_t> flop_masks(flops.size());
+  parallel_for(flops.size(), num_threads, [&](std::size_t f) {
+    uint8_t deal[5];
+    flops.unindex(f, deal + 2);
+    flop_masks[f] = (1ull << deal[2]) | (1ull << deal[3]) | (1ull << deal[4]);
+    for (int c = 0; c < kNumCombos; ++c) {
+      if (combo_mask(c) & flop_masks[f]) continue;
+      const auto hc = combo_cards(c);
+      deal[0] = hc.first;
+      deal[1] = hc.second;
+      class_of[f * kNumCombos + c] = static_cast<std::uint32_t>(pairs.index(deal));
+    }
+  });
+
+  // A canonical board stands for its whole orbit: relabelling suits maps
+  // each (hole, flop, runout) deal of one orbit member onto another's with
+  // the same class and outcome. Sums are integers, so the result does not
+  // depend on the order boards finish in.
+  std::vector<std::uint64_t> sums(pairs.size() * kFlopEquityValues);
+  std::vector<std::uint64_t> weights(pairs.size());
+  std::vector<std::mutex> locks(flops.size());
+  const std::size_t chunks = (boards.size() + kBoardsPerChunk - 1) / kBoardsPerChunk;
+  parallel_for(chunks, num_threads, [&](std::size_t chunk) {
+    auto sweep = std::make_unique<BoardSweep>();
+    const std::size_t end = std::min<std::size_t>(boards.size(), (chunk + 1) * kBoardsPerChunk);
+    for (std::size_t b = chunk * kBoardsPerChunk; b < end; ++b) {
+      uint8_t board[5], live[kLive];
+      boards.unindex(b, board);
+      std::uint64_t board_mask = 0;
+      for (uint8_t c : board) board_mask |= 1ull << c;
+      for (int c = 0, n = 0; c < 52; ++c)
+        if (!(board_mask >> c & 1)) live[n++] = static_cast<uint8_t>(c);
+      sweep->run(board, live);
+
+      // Every 3-card subset is a flop whose runout is the other two cards.
+      for (int x = 0; x < 5; ++x)
+        for (int y = x + 1; y < 5; ++y)
+          for (int z = y + 1; z < 5; ++z) {
+            const uint8_t flop[3] = {board[x], board[y], board[z]};
+            const std::size_t f = flops.index(flop);
+            const std::array<uint8_t, 4>* perm = nullptr;
+            for (const auto& p : kSuitPermutations.perm) {
+              const std::uint64_t m =
+                  (1ull << relabel(flop[0], p)) | (1ull << relabel(flop[1], p)) | (1ull << relabel(flop[2], p));
+              if (m == flop_masks[f]) {
+                perm = &p;
+                break;
+              }
+            }
+            const std::uint32_t* row = &class_of[f * kNumCombos];
+            std::lock_guard<std::mutex> lock(locks[f]);
+            for (int p = 0; p < kPairs; ++p) {
+              const std::uint32_t cls =
+                  row[combo_index(relabel(live[sweep->first[p]], *perm), relabel(live[sweep->second[p]], *perm))];
+              std::uint64_t* sum = &sums[static_cast<std::size_t>(cls) * kFlopEquityValues];
+              for (int v = 0; v < kFlopEquityValues; ++v) sum[v] += std::uint64_t{orbit[b]} * sweep->counts[p][v];
+              weights[cls] += orbit[b];
+            }
+          }
+    }
+  });
+
+  std::vector<std::uint16_t> values(sums.size());
+  for (std::size_t cls = 0; cls < weights.size(); ++cls)
+    for (int k = 1; k <= kFlopEquityMaxOpponents; ++k)
+      for (int j = 0; j <= k; ++j) {
+        const std::size_t v = cls * kFlopEquityValues + value_offset(k) + j;
+        const double prob = static_cast<double>(sums[v]) / (static_cast<double>(weights[cls]) * kDeals[k]);
+        values[v] = static_cast<std::uint16_t>(std::lround(std::min(1.0, prob) * kScale));
+      }
+  return values;
+}
+
+void write_flop_equity_file(const std::string& path, const std::vector<std::uint16_t>& values, bool compress) {
+  const std::uint64_t entries = street_indexer(Street::FLOP).size();
+  if (values.size() != entries * kFlopEquityValues)
+    throw std::invalid_argument("flop equity values must have one row per flop class");
+  TableWriter writer(TableKind::FLOP_EQUITY, kFlopEquityTableVersion, {2, 3},
+                     {kFlopEquityMaxOpponents, kFlopEquityValues});
+  writer.add_section("outcomes", values.data(), values.size() * sizeof(std::uint16_t), compress);
+  writer.write(path);
+}
+
+FlopEquityTable::FlopEquityTable(const std::string& path)
+    : file_(path, TableKind::FLOP_EQUITY, kFlopEquityTableVersion) {
+  if (file_.cards_per_round() != std::vector<int>{2, 3} || file_.params()[0] != kFlopEquityMaxOpponents ||
+      file_.params()[1] != kFlopEquityValues)
+    throw std::runtime_error(path + " does not match the flop index scheme");
+  data_ = file_.array<std::uint16_t>("outcomes", street_indexer(Street::FLOP).size() * kFlopEquityValues);
+}
+
+FlopOutcome FlopEquityTable::lookup(const std::vector<uint8_t>& hole_cards,
+                                    const std::vector<uint8_t>& flop,
+                                    int num_opponents) const {
+  if (flop.size() != 3) throw std::invalid_argument("flop must have 3 cards");
+  if (num_opponents < 1 || num_opponents > kFlopEquityMaxOpponents)
+    throw std::invalid_argument("flop equity table covers 1-3 opponents");
+  const std::uint16_t* row = data_ + street_index(hole_cards, flop) * kFlopEquityValues + value_offset(num_opponents);
+  FlopOutcome out;
+  out.opponents = num_opponents;
+  for (int j = 0; j <= num_opponents; ++j) out.ways[j] = row[j] / kScale;
+  out.deals = kPairs * kDeals[num_opponents];
+  return out;
+}
+
+void load_flop_equity_table(const std::string& path) {
+  std::shared_ptr<const FlopEquityTable> table;
+  if (!path.empty()) table = std::make_shared<const FlopEquityTable>(path);
+  std::lock_guard<std::mutex> lock(g_table_mutex);
+  g_table = std::move(table);
+}
+
+std::shared_ptr<const FlopEquityTable> flop_equity_table() {
+  std::lock_guard<std::mutex> lock(g_table_mutex);
+  return g_table;
+}
+
+}  // namespace poker_sim
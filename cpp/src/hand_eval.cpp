@@ -133,11 +133,111 @@ HandKey evaluate7(const std::vector<uint8_t>& cards) {
   return best;
 }
 
+HandRank pack(int type, int t0, int t1 = 0, int t2 = 0, int t3 = 0, int t4 = 0) {
+  return (static_cast<HandRank>(type) << 20) | (static_cast<HandRank>(t0) << 16) |
+         (static_cast<HandRank>(t1) << 12) | (static_cast<HandRank>(t2) << 8) |
+         (static_cast<HandRank>(t3) << 4) | static_cast<HandRank>(t4);
+}
+
+inline int high_bit(std::uint32_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz(m);
+#else
+  int b = -1;
+  while (m) { m >>= 1; ++b; }
+  return b;
+#endif
+}
+
+inline int bit_count(std::uint32_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcount(m);
+#else
+  int n = 0;
+  for (; m; m &= m - 1) ++n;
+  return n;
+#endif
+}
+
+/// Highest straight rank in a 13-bit rank mask, or -1. The ace is mirrored
+/// below the deuce so the wheel reports 3 (five-high).
+inline int mask_straight_high(std::uint32_t mask) {
+  std::uint32_t ext = (mask << 1) | ((mask >> 12) & 1u);
+  std::uint32_t run = ext & (ext << 1) & (ext << 2) & (ext << 3) & (ext << 4);
+  return run ? high_bit(run) - 1 : -1;
+}
+
+/// Pops the top `n` ranks of `mask` into t[], highest first.
+inline void top_ranks(std::uint32_t mask, int n, int* t) {
+  for (int i = 0; i < n; ++i) {
+    int r = high_bit(mask);
+    t[i] = r;
+    mask &= ~(1u << r);
+  }
+}
+
 }  // namespace
 
+HandRank HandState::rank() const {
+  int flush_suit = -1;
+  for (int s = 0; s < 4; ++s)
+    if (bit_count(suit_mask_[s]) >= 5) flush_suit = s;
+  if (flush_suit >= 0) {
+    int sf = mask_straight_high(suit_mask_[flush_suit]);
+    if (sf >= 0) return pack(STRAIGHT_FLUSH, sf);
+  }
+
+  const std::uint32_t ranks = by_count_[0];
+  if (by_count_[3]) {
+    int quad = high_bit(by_count_[3]);
+    return pack(FOUR_KIND, quad, high_bit(ranks & ~(1u << quad)));
+  }
+  const std::uint32_t trips = by_count_[2], pairs = by_count_[1] & ~trips;
+  int trip = trips ? high_bit(trips) : -1;
+  if (trip >= 0) {
+    std::uint32_t rest = (trips & ~(1u << trip)) | pairs;
+    if (rest) return pack(FULL_HOUSE, trip, high_bit(rest));
+  }
+
+  int t[5];
+  if (flush_suit >= 0) {
+    top_ranks(suit_mask_[flush_suit], 5, t);
+    return pack(FLUSH, t[0], t[1], t[2], t[3], t[4]);
+  }
+  int st = mask_straight_high(ranks);
+  if (st >= 0) return pack(STRAIGHT, st);
+  if (trip >= 0) {
+    top_ranks(ranks & ~(1u << trip), 2, t);
+    return pack(THREE_KIND, trip, t[0], t[1]);
+  }
+  if (pairs) {
+    int p0 = high_bit(pairs);
+    std::uint32_t lower = pairs & ~(1u << p0);
+    if (lower) {
+      int p1 = high_bit(lower);
+      return pack(TWO_PAIR, p0, p1, high_bit(ranks & ~(1u << p0) & ~(1u << p1)));
+    }
+    top_ranks(ranks & ~(1u << p0), 3, t);
+    return pack(ONE_PAIR, p0, t[0], t[1], t[2]);
+  }
+  top_ranks(ranks, 5, t);
+  return pack(HIGH_CARD, t[0], t[1], t[2], t[3], t[4]);
+}
+
+HandRank evaluate_hand(const uint8_t* cards, int n) {
+  HandState state;
+  for (int i = 0; i < n; ++i) state.add(cards[i]);
+  return state.rank();
+}
+
+HandRank evaluate_hand_reference(const uint8_t* cards, int n) {
+  HandKey k = evaluate7(std::vector<uint8_t>(cards, cards + n));
+  return pack(k.type, k.tb[0], k.tb[1], k.tb[2], k.tb[3], k.tb[4]);
+}
+
 int compare_hands(const std::vector<uint8_t>& h1, const std::vector<uint8_t>& h2) {
-  HandKey k1 = evaluate7(h1);
-  HandKey k2 = evaluate7(h2);
+  HandRank k1 = evaluate_hand(h1.data(), static_cast<int>(h1.size()));
+  HandRank k2 = evaluate_hand(h2.data(), static_cast<int>(h2.size()));
   if (k1 > k2) return 1;
   if (k2 > k1) return -1;
   return 0;
@@ -0,0 +1,294 @@
+#include "poker_sim/hand_index.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+constexpr int kRanks = 13;
+
+std::uint64_t choose(std::uint64_t n, int k) {
+  if (k < 0 || n < static_cast<std::uint64_t>(k)) return 0;
+  std::uint64_t r = 1;
+  for (int i = 1; i <= k; ++i) r = r * (n - k + i) / i;  // r = C(n - k + i, i), exact at each step
+  return r;
+}
+
+/// C(n, k) for n, k <= 13, and the colex rank of every 13-bit rank set
+/// among sets of its size.
+struct ColexTable {
+  std::uint32_t binomial[kRanks + 1][kRanks + 1];
+  std::uint32_t index[1 << kRanks];
+  ColexTable() {
+    for (int n = 0; n <= kRanks; ++n)
+      for (int k = 0; k <= kRanks; ++k) binomial[n][k] = static_cast<std::uint32_t>(choose(n, k));
+    for (std::uint32_t set = 0; set < (1u << kRanks); ++set) {
+      std::uint32_t idx = 0;
+      int i = 0;
+      for (int r = 0; r < kRanks; ++r)
+        if (set >> r & 1) idx += static_cast<std::uint32_t>(choose(r, ++i));
+      index[set] = idx;
+    }
+  }
+};
+
+const ColexTable kColex;
+
+/// Renumbers the ranks in `set` as positions among the ranks not in `used`.
+std::uint32_t compress(std::uint32_t set, std::uint32_t used) {
+  std::uint32_t out = 0;
+  for (; set; set &= set - 1) {
+    const int r = __builtin_ctz(set);
+    out |= 1u << (r - __builtin_popcount(used & ((1u << r) - 1)));
+  }
+  return out;
+}
+
+/// Largest y in [lo, hi] with C(y, k) <= value.
+std::uint64_t largest_below(std::uint64_t value, int k, std::uint64_t lo, std::uint64_t hi) {
+  while (lo < hi) {
+    const std::uint64_t mid = lo + (hi - lo + 1) / 2;
+    if (choose(mid, k) <= value)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  return lo;
+}
+
+}  // namespace
+
+HandIndexer::HandIndexer(std::vector<int> cards_per_round) : cards_per_round_(std::move(cards_per_round)) {
+  const int rounds = static_cast<int>(cards_per_round_.size());
+  if (rounds < 1 || rounds > 4) throw std::invalid_argument("hand indexer needs 1-4 rounds");
+  for (int n : cards_per_round_) {
+    if (n < 1 || n > 7) throw std::invalid_argument("hand indexer rounds must have 1-7 cards");
+    total_cards_ += n;
+  }
+  if (total_cards_ > kRanks) throw std::invalid_argument("hand indexer supports at most 13 cards");
+
+  std::size_t keys = 1;
+  for (int n : cards_per_round_) keys *= static_cast<std::size_t>((n + 1) * (n + 1) * (n + 1));
+  by_counts_.resize(keys);
+
+  // Walk every split of each round's cards over the four suits.
+  std::map<int, int> shape_ids;
+  std::map<std::array<int, 4>, int> configuration_ids;
+  int counts[4][4] = {};
+  auto visit = [&]() {
+    std::array<int, 4> code{};
+    for (int s = 0; s < 4; ++s)
+      for (int r = rounds - 1; r >= 0; --r) code[s] = code[s] * 14 + counts[r][s];
+    CountEntry& entry = by_counts_[count_key(counts)];
+    std::array<uint8_t, 4> order = {0, 1, 2, 3};
+    std::stable_sort(order.begin(), order.end(), [&](uint8_t a, uint8_t b) { return code[a] > code[b]; });
+    std::array<int, 4> shapes{};
+    for (int i = 0; i < 4; ++i) {
+      const int c = code[order[i]];
+      auto it = shape_ids.find(c);
+      if (it == shape_ids.end()) {
+        Shape shape{c, 1};
+        int used = 0;
+        for (int r = 0; r < rounds; ++r) {
+          shape.size *= choose(kRanks - used, counts[r][order[i]]);
+          used += counts[r][order[i]];
+        }
+        it = shape_ids.emplace(c, static_cast<int>(shapes_.size())).first;
+        shapes_.push_back(shape);
+      }
+      shapes[i] = it->second;
+    }
+    auto it = configuration_ids.find(shapes);
+    if (it == configuration_ids.end()) {
+      std::uint64_t size = 1;
+      for (int i = 0; i < 4;) {
+        int k = 1;
+        while (i + k < 4 && shapes[i + k] == shapes[i]) ++k;
+        size *= choose(shapes_[shapes[i]].size + k - 1, k);
+        i += k;
+      }
+      it = configuration_ids.emplace(shapes, static_cast<int>(configurations_.size())).first;
+      configurations_.push_back({shapes, size_});
+      size_ += size;
+    }
+    entry.configuration = it->second;
+    entry.order = order;
+  };
+  auto split = [&](auto&& self, int round, int suit, int left) -> void {
+    if (suit == 3) {
+      counts[round][3] = left;
+      if (round + 1 < rounds)
+        self(self, round + 1, 0, cards_per_round_[round + 1]);
+      else
+        visit();
+      return;
+    }
+    for (int c = 0; c <= left; ++c) {
+      counts[round][suit] = c;
+      self(self, round, suit + 1, left - c);
+    }
+  };
+  split(split, 0, 0, cards_per_round_[0]);
+}
+
+std::size_t HandIndexer::count_key(const int counts[][4]) const {
+  std::size_t key = 0, mult = 1;
+  for (std::size_t r = 0; r < cards_per_round_.size(); ++r)
+    for (int s = 0; s < 3; ++s) {
+      key += counts[r][s] * mult;
+      mult *= cards_per_round_[r] + 1;
+    }
+  return key;
+}
+
+std::uint64_t HandIndexer::index(const uint8_t* cards) const {
+  const int rounds = this->rounds();
+  std::uint32_t ranks[4][4] = {};
+  int counts[4][4] = {};
+  for (int r = 0, i = 0; r < rounds; ++r)
+    for (int j = 0; j < cards_per_round_[r]; ++j, ++i) {
+      const uint8_t c = cards[i];
+      ranks[r][card_suit(c)] |= 1u << card_rank(c);
+      ++counts[r][card_suit(c)];
+    }
+  const CountEntry& entry = by_counts_[count_key(counts)];
+  const Configuration& config = configurations_[entry.configuration];
+
+  // Each suit's rank sets, round by round, as one mixed-radix number.
+  std::uint64_t suit_index[4];
+  for (int s = 0; s < 4; ++s) {
+    std::uint32_t used = 0;
+    std::uint64_t idx = 0, mult = 1;
+    for (int r = 0; r < rounds; ++r) {
+      idx += mult * kColex.index[compress(ranks[r][s], used)];
+      mult *= kColex.binomial[kRanks - __builtin_popcount(used)][counts[r][s]];
+      used |= ranks[r][s];
+    }
+    suit_index[s] = idx;
+  }
+
+  // Suits of equal shape are interchangeable: index their multiset.
+  std::uint64_t index = config.offset, mult = 1;
+  for (int i = 0; i < 4;) {
+    int k = 1;
+    while (i + k < 4 && config.shapes[i + k] == config.shapes[i]) ++k;
+    std::uint64_t group[4];
+    for (int j = 0; j < k; ++j) group[j] = suit_index[entry.order[i + j]];
+    std::sort(group, group + k);
+    std::uint64_t part = 0;
+    for (int j = 0; j < k; ++j) part += choose(group[j] + j, j + 1);
+    index += mult * part;
+    mult *= choose(shapes_[config.shapes[i]].size + k - 1, k);
+    i += k;
+  }
+  return index;
+}
+
+void HandIndexer::unindex(std::uint64_t index, uint8_t* cards) const {
+  if (index >= size_) throw std::invalid_argument("hand index out of range");
+  const auto it = std::upper_bound(configurations_.begin(), configurations_.end(), index,
+                                   [](std::uint64_t v, const Configuration& c) { return v < c.offset; });
+  const Configuration& config = *(it - 1);
+  std::uint64_t rem = index - config.offset;
+
+  // The configuration lists shapes largest first; suit i takes position i.
+  std::uint64_t suit_index[4];
+  for (int i = 0; i < 4;) {
+    int k = 1;
+    while (i + k < 4 && config.shapes[i + k] == config.shapes[i]) ++k;
+    const std::uint64_t n = shapes_[config.shapes[i]].size;
+    const std::uint64_t size = choose(n + k - 1, k);
+    std::uint64_t part = rem % size;
+    rem /= size;
+    for (int j = k - 1; j >= 0; --j) {
+      const std::uint64_t y = j == 0 ? part : largest_below(part, j + 1, j, n + j - 1);
+      part -= choose(y, j + 1);
+      suit_index[i + j] = y - j;
+    }
+    i += k;
+  }
+
+  const int rounds = this->rounds();
+  int pos[4];
+  for (int r = 0, p = 0; r < rounds; ++r) {
+    pos[r] = p;
+    p += cards_per_round_[r];
+  }
+  for (int s = 0; s < 4; ++s) {
+    int code = shapes_[config.shapes[s]].code;
+    std::uint64_t idx = suit_index[s];
+    std::uint32_t used = 0;
+    for (int r = 0; r < rounds; ++r) {
+      const int count = code % 14;
+      code /= 14;
+      const int avail = kRanks - __builtin_popcount(used);
+      const std::uint64_t size = kColex.binomial[avail][count];
+      std::uint64_t local = idx % size;
+      idx /= size;
+      std::uint32_t set = 0;
+      for (int j = count; j >= 1; --j) {
+        int p = avail - 1;
+        while (kColex.binomial[p][j] > local) --p;
+        local -= kColex.binomial[p][j];
+        // p-th rank (from zero) not used in earlier rounds
+        int rank = -1;
+        for (int left = p + 1; left; --left)
+          do ++rank;
+          while (used >> rank & 1);
+        set |= 1u << rank;
+      }
+      for (std::uint32_t b = set; b; b &= b - 1)
+        cards[pos[r]++] = static_cast<uint8_t>(s * kRanks + __builtin_ctz(b));
+      used |= set;
+    }
+  }
+}
+
+const HandIndexer& street_indexer(Street street) {
+  static const HandIndexer preflop({2}), flop({2, 3}), turn({2, 4}), river({2, 5});
+  switch (street) {
+    case Street::PREFLOP: return preflop;
+    case Street::FLOP: return flop;
+    case Street::TURN: return turn;
+    case Street::RIVER: break;
+  }
+  return river;
+}
+
+Street street_of_board(std::size_t board_size) {
+  switch (board_size) {
+    case 0: return Street::PREFLOP;
+    case 3: return Street::FLOP;
+    case 4: return Street::TURN;
+    case 5: return Street::RIVER;
+    default: throw std::invalid_argument("board must have 0, 3, 4, or 5 cards");
+  }
+}
+
+std::uint64_t street_index(const std::vector<uint8_t>& hole_cards, const std::vector<uint8_t>& board) {
+  if (hole_cards.size() != 2) throw std::invalid_argument("hole_cards must have exactly 2 cards");
+  const HandIndexer& indexer = street_indexer(street_of_board(board.size()));
+  uint8_t cards[7];
+  std::uint64_t seen = 0;
+  int n = 0;
+  for (const auto* v : {&hole_cards, &board})
+    for (uint8_t c : *v) {
+      if (c > 51) throw std::invalid_argument("card index out of range 0-51");
+      if (seen >> c & 1) throw std::invalid_argument("hole_cards and board must not overlap");
+      seen |= 1ull << c;
+      cards[n++] = c;
+    }
+  return indexer.index(cards);
+}
+
+std::pair<std::vector<uint8_t>, std::vector<uint8_t>> street_unindex(Street street, std::uint64_t index) {
+  const HandIndexer& indexer = street_indexer(street);
+  uint8_t cards[7];
+  indexer.unindex(index, cards);
+  return {std::vector<uint8_t>(cards, cards + 2), std::vector<uint8_t>(cards + 2, cards + indexer.total_cards())};
+}
+
+}  // namespace poker_sim
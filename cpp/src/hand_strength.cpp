@@ -0,0 +1,448 @@
+#include "poker_sim/hand_strength.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace poker_sim {
+
+namespace {
+
+/// The cache is emptied when it reaches this many entries (about 20 MB).
+constexpr std::size_t kMaxCacheEntries = 1u << 18;
+
+constexpr HandRank kNoHand = ~HandRank{0};
+
+struct Holding {
+  uint8_t c1, c2;
+  uint8_t s1, s2;     // suits
+  uint8_t rank_pair;  // low rank * 13 + high rank
+  std::uint64_t mask;
+};
+
+Holding make_holding(int combo) {
+  const auto hc = combo_cards(combo);
+  const int r1 = card_rank(hc.first), r2 = card_rank(hc.second);
+  return {hc.first, hc.second, static_cast<uint8_t>(card_suit(hc.first)), static_cast<uint8_t>(card_suit(hc.second)),
+          static_cast<uint8_t>(std::min(r1, r2) * 13 + std::max(r1, r2)), combo_mask(combo)};
+}
+
+/// Ranks every holding on cards[0..n) into out[]; holdings touching
+/// `excluded` get kNoHand. Holdings that cannot complete a flush are ranked
+/// once per rank pair, as in analyze_outs.
+void rank_holdings(uint8_t* cards, int n, const std::vector<Holding>& holdings, std::uint64_t excluded,
+                   HandRank* out) {
+  int suited[4] = {};
+  for (int i = 0; i < n; ++i) ++suited[card_suit(cards[i])];
+  HandRank by_ranks[13 * 13];
+  std::fill(std::begin(by_ranks), std::end(by_ranks), kNoHand);
+  for (std::size_t i = 0; i < holdings.size(); ++i) {
+    const Holding& h = holdings[i];
+    if (h.mask & excluded) {
+      out[i] = kNoHand;
+      continue;
+    }
+    const int same = h.s1 == h.s2;
+    const bool flush_draw = suited[h.s1] + 1 + same >= 5 || suited[h.s2] + 1 + same >= 5;
+    HandRank* slot = flush_draw ? nullptr : &by_ranks[h.rank_pair];
+    if (slot && *slot != kNoHand) {
+      out[i] = *slot;
+      continue;
+    }
+    cards[n] = h.c1;
+    cards[n + 1] = h.c2;
+    out[i] = evaluate_hand(cards, n + 2);
+    if (slot) *slot = out[i];
+  }
+}
+
+constexpr int choose_two(int n) { return n * (n - 1) / 2; }
+
+/// 0 = hero ahead, 1 = tied, 2 = behind.
+inline int standing(HandRank hero, HandRank opp) { return hero > opp ? 0 : hero == opp ? 1 : 2; }
+
+HandStrength compute(const uint8_t* hole, const std::vector<uint8_t>& board, std::uint64_t dead_mask,
+                     unsigned flop_runouts, unsigned seed) {
+  const std::uint64_t known = (1ull << hole[0]) | (1ull << hole[1]) | card_mask(board) | dead_mask;
+  std::vector<Holding> holdings;
+  for (int i = 0; i < kNumCombos; ++i) {
+    const std::uint64_t m = combo_mask(i);
+    if (m & known) continue;
+    holdings.push_back(make_holding(i));
+  }
+  HandStrength out;
+  if (holdings.empty()) return out;
+
+  const int n = static_cast<int>(board.size());
+  uint8_t cards[7];
+  std::copy(board.begin(), board.end(), cards);
+  cards[n] = hole[0];
+  cards[n + 1] = hole[1];
+  const HandRank hero_now = evaluate_hand(cards, n + 2);
+  std::vector<HandRank> ranks(holdings.size());
+  rank_holdings(cards, n, holdings, 0, ranks.data());
+  std::vector<uint8_t> now(holdings.size());
+  double count_now[3] = {};
+  for (std::size_t i = 0; i < holdings.size(); ++i) {
+    now[i] = static_cast<uint8_t>(standing(hero_now, ranks[i]));
+    ++count_now[now[i]];
+  }
+  out.hs = (count_now[0] + 0.5 * count_now[1]) / holdings.size();
+  if (n == 5) {
+    out.ehs = out.equity = out.hs;
+    out.ehs2 = out.hs * out.hs;
+    out.exact = true;
+    return out;
+  }
+
+  std::vector<uint8_t> deck;
+  for (int c = 0; c < 52; ++c)
+    if (!(known >> c & 1)) deck.push_back(static_cast<uint8_t>(c));
+  std::vector<std::array<uint8_t, 2>> runouts;
+  if (n == 4) {
+    for (uint8_t c : deck) runouts.push_back({c, 0});
+  } else {
+    for (std::size_t i = 0; i < deck.size(); ++i)
+      for (std::size_t j = i + 1; j < deck.size(); ++j) runouts.push_back({deck[i], deck[j]});
+  }
+  out.exact = n == 4 || flop_runouts >= runouts.size();
+  if (!out.exact) {
+    // Partial Fisher-Yates: the first flop_runouts entries are a uniform sample without replacement.
+    std::mt19937 rng(seed);
+    for (unsigned i = 0; i < flop_runouts; ++i) {
+      std::uniform_int_distribution<std::size_t> pick(i, runouts.size() - 1);
+      std::swap(runouts[i], runouts[pick(rng)]);
+    }
+    runouts.resize(flop_runouts);
+  }
+
+  double hp[3][3] = {};
+  double sum_hs = 0, sum_hs2 = 0;
+  for (const auto& r : runouts) {
+    std::uint64_t excluded = 1ull << r[0];
+    cards[n] = r[0];
+    if (n == 3) {
+      cards[4] = r[1];
+      excluded |= 1ull << r[1];
+    }
+    cards[5] = hole[0];
+    cards[6] = hole[1];
+    const HandRank hero = evaluate_hand(cards, 7);
+    rank_holdings(cards, 5, holdings, excluded, ranks.data());
+    double count[3] = {};
+    for (std::size_t i = 0; i < holdings.size(); ++i) {
+      if (ranks[i] == kNoHand) continue;
+      const int s = standing(hero, ranks[i]);
+      ++count[s];
+      ++hp[now[i]][s];
+    }
+    const double river_hs = (count[0] + 0.5 * count[1]) / (count[0] + count[1] + count[2]);
+    sum_hs += river_hs;
+    sum_hs2 += river_hs * river_hs;
+  }
+
+  const double total[3] = {hp[0][0] + hp[0][1] + hp[0][2], hp[1][0] + hp[1][1] + hp[1][2],
+                           hp[2][0] + hp[2][1] + hp[2][2]};
+  const double ppot_den = total[2] + 0.5 * total[1];
+  const double npot_den = total[0] + 0.5 * total[1];
+  if (ppot_den > 0) out.ppot = (hp[2][0] + 0.5 * hp[2][1] + 0.5 * hp[1][0]) / ppot_den;
+  if (npot_den > 0) out.npot = (hp[0][2] + 0.5 * hp[0][1] + 0.5 * hp[1][2]) / npot_den;
+  out.ehs = out.hs * (1 - out.npot) + (1 - out.hs) * out.ppot;
+  out.runouts = static_cast<std::uint32_t>(runouts.size());
+  out.equity = sum_hs / out.runouts;
+  out.ehs2 = sum_hs2 / out.runouts;
+  return out;
+}
+
+/// Card masks of a spot under its canonical suit relabelling, plus the
+/// sampling parameters (zeroed where they cannot change the result).
+struct SpotKey {
+  std::uint64_t hole, board, dead;
+  unsigned runouts, seed;
+  bool operator==(const SpotKey& o) const {
+    return hole == o.hole && board == o.board && dead == o.dead && runouts == o.runouts && seed == o.seed;
+  }
+};
+
+struct SpotKeyHash {
+  std::size_t operator()(const SpotKey& k) const {
+    std::uint64_t h = k.hole * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 29) ^ k.board) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 31) ^ k.dead) * 0x94D049BB133111EBull;
+    h ^= (static_cast<std::uint64_t>(k.runouts) << 32 | k.seed) + (h >> 27);
+    return static_cast<std::size_t>(h);
+  }
+};
+
+/// Moves each 13-card suit block s of the mask to block perm[s].
+std::uint64_t permute_suits(std::uint64_t mask, const std::array<int, 4>& perm) {
+  std::uint64_t out = 0;
+  for (int s = 0; s < 4; ++s) out |= ((mask >> (13 * s)) & 0x1FFF) << (13 * perm[s]);
+  return out;
+}
+
+/// Picks the suit relabelling giving the smallest (hole, board, dead) masks,
+/// so every suit-isomorphic spot maps to the same key.
+SpotKey canonical_key(std::uint64_t hole, std::uint64_t board, std::uint64_t dead) {
+  std::array<int, 4> perm = {0, 1, 2, 3};
+  SpotKey best{hole, board, dead, 0, 0};
+  do {
+    SpotKey k{permute_suits(hole, perm), permute_suits(board, perm), permute_suits(dead, perm), 0, 0};
+    if (std::tie(k.hole, k.board, k.dead) < std::tie(best.hole, best.board, best.dead)) best = k;
+  } while (std::next_permutation(perm.begin(), perm.end()));
+  return best;
+}
+
+std::vector<uint8_t> mask_cards(std::uint64_t mask) {
+  std::vector<uint8_t> cards;
+  for (int c = 0; c < 52; ++c)
+    if (mask >> c & 1) cards.push_back(static_cast<uint8_t>(c));
+  return cards;
+}
+
+void validate(const std::vector<uint8_t>& hole_cards, const std::vector<uint8_t>& board,
+              std::uint64_t dead_mask, unsigned flop_runouts) {
+  if (hole_cards.size() != 2) throw std::invalid_argument("hole_cards must have exactly 2 cards");
+  if (board.size() < 3 || board.size() > 5) throw std::invalid_argument("board must have 3 to 5 cards");
+  std::uint64_t known = 0;
+  for (const auto* v : {&hole_cards, &board})
+    for (uint8_t c : *v) {
+      if (c > 51) throw std::invalid_argument("card index out of range 0-51");
+      if (known >> c & 1) throw std::invalid_argument("hole_cards and board must not overlap");
+      known |= 1ull << c;
+    }
+  if (dead_mask >> 52) throw std::invalid_argument("dead card index out of range 0-51");
+  if (dead_mask & known) throw std::invalid_argument("dead cards must not overlap hole_cards or board");
+  if (board.size() == 3 && flop_runouts == 0) throw std::invalid_argument("flop_runouts must be positive");
+}
+
+std::mutex cache_mutex;
+std::unordered_map<SpotKey, HandStrength, SpotKeyHash> cache;
+
+}  // namespace
+
+HandStrength hand_strength(const std::vector<uint8_t>& hole_cards,
+                           const std::vector<uint8_t>& board,
+                           std::uint64_t dead_mask,
+                           unsigned flop_runouts,
+                           unsigned seed) {
+  validate(hole_cards, board, dead_mask, flop_runouts);
+  SpotKey key = canonical_key(card_mask(hole_cards), card_mask(board), dead_mask);
+  if (board.size() == 3) {
+    key.runouts = flop_runouts;
+    key.seed = seed;
+  }
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+  }
+  // Computed on the canonical cards, so a sampled flop gives the same
+  // answer for every member of its isomorphism class.
+  const std::vector<uint8_t> hole = mask_cards(key.hole);
+  const HandStrength result = compute(hole.data(), mask_cards(key.board), key.dead, flop_runouts, seed);
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (cache.size() >= kMaxCacheEntries) cache.clear();
+  cache.emplace(key, result);
+  return result;
+}
+
+std::vector<HandStrength> hand_strength_batch(const std::vector<HandSpot>& spots,
+                                              std::uint64_t dead_mask,
+                                              unsigned flop_runouts,
+                                              unsigned seed,
+                                              unsigned num_threads) {
+  // Validated up front: worker threads must not throw.
+  for (const HandSpot& s : spots) validate(s.hole_cards, s.board, dead_mask, flop_runouts);
+  std::vector<HandStrength> out(spots.size());
+  parallel_for(spots.size(), num_threads, [&](std::size_t i) {
+    out[i] = hand_strength(spots[i].hole_cards, spots[i].board, dead_mask, flop_runouts, seed);
+  });
+  return out;
+}
+
+std::size_t hand_strength_cache_size() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache.size();
+}
+
+void clear_hand_strength_cache() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache.clear();
+}
+
+EquityHistogram equity_histogram(const std::vector<uint8_t>& hole_cards,
+                                 const std::vector<uint8_t>& board,
+                                 const HandRange& opponent_range,
+                                 std::uint64_t dead_mask,
+                                 unsigned bins) {
+  if (board.size() != 3 && board.size() != 4) throw std::invalid_argument("board must have 3 or 4 cards");
+  if (bins < 1 || bins > 100) throw std::invalid_argument("bins must be 1-100");
+  validate(hole_cards, board, dead_mask, 1);
+  const std::uint64_t known = card_mask(hole_cards) | card_mask(board) | dead_mask;
+  std::vector<Holding> holdings;
+  std::vector<double> weights;
+  for (int i = 0; i < kNumCombos; ++i) {
+    const std::uint64_t m = combo_mask(i);
+    if (opponent_range.weights[i] <= 0 || (m & known)) continue;
+    holdings.push_back(make_holding(i));
+    weights.push_back(opponent_range.weights[i]);
+  }
+  if (holdings.empty()) throw std::invalid_argument("opponent range has no combos left after card removal");
+
+  std::vector<uint8_t> deck;
+  for (int c = 0; c < 52; ++c)
+    if (!(known >> c & 1)) deck.push_back(static_cast<uint8_t>(c));
+  const int n = static_cast<int>(board.size());
+  uint8_t cards[7];
+  std::copy(board.begin(), board.end(), cards);
+  std::vector<HandRank> ranks(holdings.size());
+
+  // Weighted pot share won and range weight in play on one complete board.
+  struct Showdown {
+    double won = 0, total = 0;
+  };
+  auto showdown = [&](std::uint64_t runout) {
+    cards[5] = hole_cards[0];
+    cards[6] = hole_cards[1];
+    const HandRank hero = evaluate_hand(cards, 7);
+    rank_holdings(cards, 5, holdings, runout, ranks.data());
+    Showdown sd;
+    for (std::size_t i = 0; i < holdings.size(); ++i) {
+      if (ranks[i] == kNoHand) continue;
+      sd.won += weights[i] * (hero > ranks[i] ? 1.0 : hero == ranks[i] ? 0.5 : 0.0);
+      sd.total += weights[i];
+    }
+    return sd;
+  };
+  auto bin_of = [bins](double equity) {
+    return std::min(bins - 1, static_cast<unsigned>(equity * bins));
+  };
+
+  EquityHistogram out;
+  out.next_card.assign(bins, 0.0);
+  const std::size_t m = deck.size();
+  double won = 0, total = 0;
+  std::uint32_t next_cards = 0;
+  if (n == 4) {
+    for (uint8_t r : deck) {
+      cards[4] = r;
+      const Showdown sd = showdown(1ull << r);
+      if (sd.total <= 0) continue;
+      out.next_card[bin_of(sd.won / sd.total)] += 1;
+      won += sd.won;
+      total += sd.total;
+      ++next_cards;
+      ++out.runouts;
+    }
+  } else {
+    // Inner level: each unordered (turn, river) board is scored once and
+    // shared by both turn cards it contains.
+    out.next_two_cards.assign(bins, 0.0);
+    std::vector<Showdown> pair(m * m);
+    for (std::size_t i = 0; i < m; ++i)
+      for (std::size_t j = i + 1; j < m; ++j) {
+        cards[3] = deck[i];
+        cards[4] = deck[j];
+        const Showdown sd = showdown((1ull << deck[i]) | (1ull << deck[j]));
+        pair[i * m + j] = pair[j * m + i] = sd;
+        if (sd.total <= 0) continue;
+        out.next_two_cards[bin_of(sd.won / sd.total)] += 1;
+        won += sd.won;
+        total += sd.total;
+        ++out.runouts;
+      }
+    for (std::size_t i = 0; i < m; ++i) {
+      double turn_won = 0, turn_total = 0;
+      for (std::size_t j = 0; j < m; ++j) {
+        if (j == i) continue;
+        turn_won += pair[i * m + j].won;
+        turn_total += pair[i * m + j].total;
+      }
+      if (turn_total <= 0) continue;
+      out.next_card[bin_of(turn_won / turn_total)] += 1;
+      ++next_cards;
+    }
+    for (double& b : out.next_two_cards) b /= out.runouts;
+  }
+  for (double& b : out.next_card) b /= next_cards;
+  out.equity = total > 0 ? won / total : 0.0;
+  return out;
+}
+
+void flop_strength_histograms(const std::vector<uint8_t>& flop, unsigned bins, std::uint16_t* out) {
+  if (flop.size() != 3) throw std::invalid_argument("flop must have 3 cards");
+  if (bins < 1 || bins > 100) throw std::invalid_argument("bins must be 1-100");
+  const std::uint64_t flop_mask = card_mask(flop);
+  if (__builtin_popcountll(flop_mask) != 3 || (flop_mask >> 52)) throw std::invalid_argument("invalid flop");
+  std::fill(out, out + static_cast<std::size_t>(kNumCombos) * bins, 0);
+
+  std::vector<Holding> holdings;
+  std::vector<int> combos;
+  for (int i = 0; i < kNumCombos; ++i)
+    if (!(combo_mask(i) & flop_mask)) {
+      holdings.push_back(make_holding(i));
+      combos.push_back(i);
+    }
+  std::vector<uint8_t> deck;
+  for (int c = 0; c < 52; ++c)
+    if (!(flop_mask >> c & 1)) deck.push_back(static_cast<uint8_t>(c));
+
+  uint8_t cards[7];
+  std::copy(flop.begin(), flop.end(), cards);
+  std::vector<HandRank> ranks(holdings.size());
+  std::vector<std::uint64_t> order;  // rank << 16 | holding, live holdings only
+  order.reserve(holdings.size());
+  // Every holding live on a runout faces the same number of opponents.
+  const double opponents = static_cast<double>(choose_two(52 - 5 - 2));
+  for (std::size_t a = 0; a < deck.size(); ++a)
+    for (std::size_t b = a + 1; b < deck.size(); ++b) {
+      cards[3] = deck[a];
+      cards[4] = deck[b];
+      rank_holdings(cards, 5, holdings, (1ull << deck[a]) | (1ull << deck[b]), ranks.data());
+      order.clear();
+      for (std::size_t i = 0; i < holdings.size(); ++i)
+        if (ranks[i] != kNoHand) order.push_back(static_cast<std::uint64_t>(ranks[i]) << 16 | i);
+      std::sort(order.begin(), order.end());
+      // Sweep weakest to strongest. Opponents a holding beats are those
+      // below it minus the ones sharing one of its cards (per-card counts);
+      // ties likewise within its rank group.
+      int below = 0;
+      int card_below[52] = {}, card_group[52] = {};
+      for (std::size_t g = 0; g < order.size();) {
+        std::size_t e = g;
+        while (e < order.size() && (order[e] >> 16) == (order[g] >> 16)) {
+          const Holding& h = holdings[order[e] & 0xFFFF];
+          ++card_group[h.c1];
+          ++card_group[h.c2];
+          ++e;
+        }
+        const int group = static_cast<int>(e - g);
+        for (std::size_t j = g; j < e; ++j) {
+          const Holding& h = holdings[order[j] & 0xFFFF];
+          const int beaten = below - card_below[h.c1] - card_below[h.c2];
+          const int tied = group + 1 - card_group[h.c1] - card_group[h.c2];
+          const double strength = (beaten + 0.5 * tied) / opponents;
+          const unsigned bin = std::min(bins - 1, static_cast<unsigned>(strength * bins));
+          ++out[static_cast<std::size_t>(combos[order[j] & 0xFFFF]) * bins + bin];
+        }
+        for (std::size_t j = g; j < e; ++j) {
+          const Holding& h = holdings[order[j] & 0xFFFF];
+          ++card_below[h.c1];
+          ++card_below[h.c2];
+          card_group[h.c1] = card_group[h.c2] = 0;
+        }
+        below += group;
+        g = e;
+      }
+    }
+}
+
+}  // namespace poker_sim
@@ -0,0 +1,159 @@
+#include "poker_sim/icm.hpp"
+#include "poker_sim/parallel.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+/// Work units; each has its own random stream.
+constexpr std::uint32_t kChunks = 16;
+
+/// Place probabilities by subset DP: placed[m] is the probability that the
+/// players in m, in some order, take the first |m| places.
+void solve_exact(const std::vector<double>& stacks, const std::vector<double>& payouts, std::vector<double>& equity) {
+  const int n = static_cast<int>(stacks.size());
+  const int places = std::min<int>(n, static_cast<int>(payouts.size()));
+  const double total = std::accumulate(stacks.begin(), stacks.end(), 0.0);
+  const std::uint32_t full = 1u << n;
+  std::vector<double> chips(full), placed(full);
+  for (std::uint32_t m = 1; m < full; ++m) chips[m] = chips[m & (m - 1)] + stacks[__builtin_ctz(m)];
+  placed[0] = 1.0;
+  // Subsets come before their supersets in numeric order.
+  for (std::uint32_t m = 0; m < full; ++m) {
+    const int k = __builtin_popcount(m);
+    if (k >= places || placed[m] == 0) continue;
+    const double scale = placed[m] / (total - chips[m]);
+    for (int i = 0; i < n; ++i) {
+      if (m >> i & 1) continue;
+      const double p = scale * stacks[i];  // i takes place k + 1
+      equity[i] += payouts[k] * p;
+      if (k + 1 < places) placed[m | 1u << i] += p;
+    }
+  }
+}
+
+/// Stacks of the players not yet placed, in a Fenwick tree: drawing the
+/// next place by stack and removing its player are both O(log n).
+class StackTree {
+ public:
+  explicit StackTree(const std::vector<double>& stacks) : tree_(stacks.size() + 1), top_(1) {
+    const std::size_t n = stacks.size();
+    for (std::size_t i = 1; i <= n; ++i) {
+      tree_[i] += stacks[i - 1];
+      const std::size_t up = i + (i & (0 - i));
+      if (up <= n) tree_[up] += tree_[i];
+    }
+    while (top_ * 2 <= n) top_ *= 2;
+  }
+
+  /// Player whose stack interval holds target (0 <= target < remaining chips).
+  int find(double target) const {
+    std::size_t pos = 0;
+    for (std::size_t step = top_; step > 0; step >>= 1)
+      if (pos + step < tree_.size() && tree_[pos + step] <= target) {
+        pos += step;
+        target -= tree_[pos];
+      }
+    return static_cast<int>(std::min(pos, tree_.size() - 2));
+  }
+
+  void remove(int player, double stack) {
+    for (std::size_t i = player + 1; i < tree_.size(); i += i & (0 - i)) tree_[i] -= stack;
+  }
+
+ private:
+  std::vector<double> tree_;
+  std::size_t top_;
+};
+
+/// Mean prizes over sampled finishing orders, each paid place drawn from the
+/// players left in proportion to stack.
+std::uint64_t solve_sampled(const std::vector<double>& stacks,
+                            const std::vector<double>& payouts,
+                            std::uint32_t num_trials,
+                            unsigned seed,
+                            unsigned num_threads,
+                            std::vector<double>& equity) {
+  const int n = static_cast<int>(stacks.size());
+  const int places = std::min<int>(n, static_cast<int>(payouts.size()));
+  const double total = std::accumulate(stacks.begin(), stacks.end(), 0.0);
+  const StackTree full(stacks);
+  std::vector<std::vector<double>> parts(kChunks, std::vector<double>(n));
+  parallel_for(kChunks, num_threads, [&](std::size_t chunk) {
+    std::mt19937 rng((seed != 0 ? seed : 12345u) + static_cast<unsigned>(chunk) * 0x9E3779B9u);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<char> placed(n);
+    std::vector<int> order(places);
+    std::vector<double>& sum = parts[chunk];
+    StackTree tree = full;
+    for (std::uint32_t t = static_cast<std::uint32_t>(chunk); t < num_trials; t += kChunks) {
+      tree = full;
+      double left = total;
+      for (int k = 0; k < places; ++k) {
+        int i = tree.find(uniform(rng) * left);
+        // Rounding can leave a placed player a sliver of the tree; redraw.
+        while (placed[i]) i = tree.find(uniform(rng) * left);
+        placed[i] = 1;
+        order[k] = i;
+        tree.remove(i, stacks[i]);
+        left -= stacks[i];
+        sum[i] += payouts[k];
+      }
+      for (int k = 0; k < places; ++k) placed[order[k]] = 0;
+    }
+  });
+  for (const auto& part : parts)
+    for (int i = 0; i < n; ++i) equity[i] += part[i];
+  for (double& e : equity) e /= num_trials;
+  return num_trials;
+}
+
+}  // namespace
+
+IcmEquity icm_equity(const std::vector<double>& stacks,
+                     const std::vector<double>& payouts,
+                     std::uint32_t num_trials,
+                     unsigned seed,
+                     unsigned num_threads) {
+  if (num_trials == 0) throw std::invalid_argument("num_trials must be positive");
+  for (double s : stacks)
+    if (!(s >= 0)) throw std::invalid_argument("stacks must not be negative");
+  for (double p : payouts)
+    if (!(p >= 0)) throw std::invalid_argument("payouts must not be negative");
+
+  // Players with chips, in order; busted players split the places below them.
+  std::vector<int> live;
+  std::vector<double> chips;
+  for (std::size_t i = 0; i < stacks.size(); ++i)
+    if (stacks[i] > 0) {
+      live.push_back(static_cast<int>(i));
+      chips.push_back(stacks[i]);
+    }
+  if (live.empty()) throw std::invalid_argument("some player must have chips");
+
+  IcmEquity out;
+  out.equity.assign(stacks.size(), 0.0);
+  std::vector<double> equity(live.size(), 0.0);
+  if (live.size() <= static_cast<std::size_t>(kIcmMaxExactPlayers)) {
+    solve_exact(chips, payouts, equity);
+    out.exact = true;
+  } else {
+    out.trials = solve_sampled(chips, payouts, num_trials, seed, num_threads, equity);
+  }
+  for (std::size_t j = 0; j < live.size(); ++j) out.equity[live[j]] = equity[j];
+
+  const std::size_t busted = stacks.size() - live.size();
+  if (busted > 0) {
+    double rest = 0;
+    for (std::size_t k = live.size(); k < std::min(stacks.size(), payouts.size()); ++k) rest += payouts[k];
+    for (std::size_t i = 0; i < stacks.size(); ++i)
+      if (!(stacks[i] > 0)) out.equity[i] = rest / busted;
+  }
+  return out;
+}
+
+}  // namespace poker_sim
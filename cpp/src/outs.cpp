@@ -0,0 +1,376 @@
+#include "poker_sim/outs.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+struct Holding {
+  uint8_t c1, c2;
+  double weight;
+  std::uint64_t mask;
+};
+
+/// Category everyone holds from the board alone. Under five cards only
+/// pairs, trips and quads are possible, so rank counts are enough.
+int board_category(const uint8_t* cards, int n) {
+  if (n >= 5) return hand_category(evaluate_hand(cards, n));
+  int count[13] = {};
+  int pairs = 0, best = 0;
+  for (int i = 0; i < n; ++i) {
+    int k = ++count[card_rank(cards[i])];
+    if (k == 2) ++pairs;
+    best = std::max(best, k);
+  }
+  if (best == 4) return FOUR_KIND;
+  if (best == 3) return THREE_KIND;
+  return pairs >= 2 ? TWO_PAIR : pairs == 1 ? ONE_PAIR : HIGH_CARD;
+}
+
+/// Index of the rank pair lo <= hi among the 91.
+inline int rank_cell(int a, int b) {
+  const int lo = std::min(a, b), hi = std::max(a, b);
+  return lo * 13 - lo * (lo - 1) / 2 + (hi - lo);
+}
+constexpr int kRankCells = 91;
+
+/// Strength of every rank pair held with the given board ranks, on suits
+/// that make no flush.
+void rank_table(const int* ranks, int n, HandRank* out) {
+  HandState board;
+  for (int i = 0; i < n; ++i) board.add(static_cast<uint8_t>((i & 1) * 13 + ranks[i]));
+  for (int lo = 0; lo < 13; ++lo)
+    for (int hi = lo; hi < 13; ++hi) {
+      HandState x = board;
+      x.add(static_cast<uint8_t>(2 * 13 + lo));
+      x.add(static_cast<uint8_t>(3 * 13 + hi));
+      out[rank_cell(lo, hi)] = x.rank();
+    }
+}
+
+/// The range summed so that a board's tally needs no pass over holdings. A
+/// holding that cannot use a flush is worth what its two ranks make with the
+/// board's ranks, so it is counted by rank pair from a rank_table, with its
+/// weight from range-wide sums per rank pair net of the holdings on the
+/// board's cards outside the shared ones (summed per card by the other
+/// card's rank). Holdings that can use a flush are ranked one by one.
+class RangeSums {
+ public:
+  explicit RangeSums(const std::vector<Holding>& holdings)
+      : holdings_(holdings), on_card_(52), card_weight_(52), pair_weight_(52 * 52) {
+    for (std::size_t i = 0; i < holdings.size(); ++i) {
+      const Holding& h = holdings[i];
+      const int r1 = card_rank(h.c1), r2 = card_rank(h.c2), s1 = card_suit(h.c1), s2 = card_suit(h.c2);
+      by_cell_[rank_cell(r1, r2)] += h.weight;
+      all_ += h.weight;
+      on_card_[h.c1][r2] += h.weight;
+      on_card_[h.c2][r1] += h.weight;
+      card_weight_[h.c1] += h.weight;
+      card_weight_[h.c2] += h.weight;
+      pair_weight_[h.c1 * 52 + h.c2] = pair_weight_[h.c2 * 52 + h.c1] = h.weight;
+      touching_[s1].push_back(static_cast<int>(i));
+      if (s2 != s1) touching_[s2].push_back(static_cast<int>(i));
+      else suited_[s1].push_back(static_cast<int>(i));
+    }
+  }
+
+  /// Adds the holdings' weighted wins against `mine` (ties half) and their
+  /// total to won and total, on a board of 3-5 cards held in b with the
+  /// given suit counts. table is the rank_table of the board's ranks, unless
+  /// the board is a flush. Holdings on the extra cards (1 or 2 of the board,
+  /// live when the sums were taken) are left out.
+  void tally(const HandState& b, const int* suits, HandRank mine, const HandRank* table,
+             const uint8_t* extra, int num_extra, double& won, double& total) const {
+    auto score = [mine](HandRank opp) { return mine > opp ? 1.0 : mine == opp ? 0.5 : 0.0; };
+    HandRank own[kRankCells];
+    int flush = -1, count = 0;
+    for (int s = 0; s < 4; ++s)
+      if (suits[s] >= 3) flush = s, count = suits[s];
+    if (count == 5) {
+      // A flush on the board plays for every holding without a better one.
+      for (int lo = 0; lo < 13; ++lo)
+        for (int hi = lo; hi < 13; ++hi) {
+          HandState x = b;
+          x.add(static_cast<uint8_t>(((flush + 1) & 3) * 13 + lo));
+          x.add(static_cast<uint8_t>(((flush + 2) & 3) * 13 + hi));
+          own[rank_cell(lo, hi)] = x.rank();
+        }
+      table = own;
+    }
+    double sum = 0, weight = all_;
+    for (int cell = 0; cell < kRankCells; ++cell) sum += by_cell_[cell] * score(table[cell]);
+    std::uint64_t used = 0;
+    for (int e = 0; e < num_extra; ++e) {
+      const uint8_t c = extra[e];
+      const int rc = card_rank(c);
+      for (int x = 0; x < 13; ++x) sum -= on_card_[c][x] * score(table[rank_cell(rc, x)]);
+      weight -= card_weight_[c];
+      used |= 1ull << c;
+    }
+    if (num_extra == 2) {
+      // The holding on both extra cards was taken out twice.
+      const double both = pair_weight_[extra[0] * 52 + extra[1]];
+      sum += both * score(table[rank_cell(card_rank(extra[0]), card_rank(extra[1]))]);
+      weight += both;
+    }
+    // With three of a suit a holding needs both cards of it for a flush,
+    // with four or five one. A holding with one card of the suit is worth
+    // the same for any suit of the other, so those are ranked once per
+    // (suited rank, other rank).
+    if (flush >= 0) {
+      constexpr HandRank kUnset = ~HandRank{0};
+      HandRank one_suited[13][13];
+      if (count > 3)
+        for (auto& row : one_suited) std::fill(row, row + 13, kUnset);
+      for (int i : count == 3 ? suited_[flush] : touching_[flush]) {
+        const Holding& h = holdings_[i];
+        if (h.mask & used) continue;
+        const int r1 = card_rank(h.c1), r2 = card_rank(h.c2);
+        const bool both = card_suit(h.c1) == card_suit(h.c2);
+        HandRank* slot = both ? nullptr : card_suit(h.c1) == flush ? &one_suited[r1][r2] : &one_suited[r2][r1];
+        if (!slot || *slot == kUnset) {
+          HandState x = b;
+          x.add(h.c1);
+          x.add(h.c2);
+          if (!slot) {
+            sum += h.weight * (score(x.rank()) - score(table[rank_cell(r1, r2)]));
+            continue;
+          }
+          *slot = x.rank();
+        }
+        sum += h.weight * (score(*slot) - score(table[rank_cell(r1, r2)]));
+      }
+    }
+    won += sum;
+    total += weight;
+  }
+
+ private:
+  const std::vector<Holding>& holdings_;
+  double by_cell_[kRankCells] = {};
+  double all_ = 0;
+  std::vector<std::array<double, 13>> on_card_;  // by the other card's rank
+  std::vector<double> card_weight_, pair_weight_;
+  std::vector<int> suited_[4], touching_[4];  // holdings with both / at least one card of a suit
+};
+
+/// Weighted wins (ties half) and total of the holdings against the hero on
+/// each complete board flop + {t, r}, for every unordered live pair t < r,
+/// with the hero's and the board's own category there. The rank tables are
+/// one per rank pair of (t, r), shared by every board with those ranks.
+struct RiverPairs {
+  std::vector<double> won, total;  // [t * 52 + r], both orders
+  std::vector<int> hero, board;    // categories, both orders
+
+  RiverPairs(const std::vector<uint8_t>& flop, const uint8_t* hole, const RangeSums& sums, std::uint64_t known,
+             unsigned num_threads)
+      : won(52 * 52), total(52 * 52), hero(52 * 52), board(52 * 52) {
+    std::vector<HandRank> tables(kRankCells * kRankCells);
+    parallel_for(13, num_threads, [&](std::size_t x) {
+      for (int y = static_cast<int>(x); y < 13; ++y) {
+        const int ranks[5] = {card_rank(flop[0]), card_rank(flop[1]), card_rank(flop[2]), static_cast<int>(x), y};
+        rank_table(ranks, 5, &tables[rank_cell(static_cast<int>(x), y) * kRankCells]);
+      }
+    });
+    HandState shared;
+    int flop_suits[4] = {};
+    for (uint8_t c : flop) {
+      shared.add(c);
+      ++flop_suits[card_suit(c)];
+    }
+
+    parallel_for(52, num_threads, [&](std::size_t ti) {
+      const int t = static_cast<int>(ti);
+      if (known >> t & 1) return;
+      for (int r = t + 1; r < 52; ++r) {
+        if (known >> r & 1) continue;
+        const uint8_t five[5] = {flop[0], flop[1], flop[2], static_cast<uint8_t>(t), static_cast<uint8_t>(r)};
+        HandState b = shared;
+        b.add(five[3]);
+        b.add(five[4]);
+        HandState with_hero = b;
+        with_hero.add(hole[0]);
+        with_hero.add(hole[1]);
+        const HandRank mine = with_hero.rank();
+        hero[t * 52 + r] = hero[r * 52 + t] = hand_category(mine);
+        board[t * 52 + r] = board[r * 52 + t] = board_category(five, 5);
+        int suits[4];
+        std::copy(flop_suits, flop_suits + 4, suits);
+        ++suits[card_suit(five[3])];
+        ++suits[card_suit(five[4])];
+        double sum = 0, weight = 0;
+        sums.tally(b, suits, mine, &tables[rank_cell(card_rank(t), card_rank(r)) * kRankCells], five + 3, 2, sum,
+                   weight);
+        won[t * 52 + r] = won[r * 52 + t] = sum;
+        total[t * 52 + r] = total[r * 52 + t] = weight;
+      }
+    });
+  }
+};
+
+/// Mask of hole cards, board and dead cards; throws on bad or overlapping cards.
+std::uint64_t known_cards(const std::vector<uint8_t>& hole_cards, const std::vector<uint8_t>& board,
+                          std::uint64_t dead_mask) {
+  std::uint64_t known = 0;
+  for (const auto* v : {&hole_cards, &board})
+    for (uint8_t c : *v) {
+      if (c > 51) throw std::invalid_argument("card index out of range 0-51");
+      if (known >> c & 1) throw std::invalid_argument("hole_cards and board must not overlap");
+      known |= 1ull << c;
+    }
+  if (dead_mask >> 52) throw std::invalid_argument("dead card index out of range 0-51");
+  if (dead_mask & known) throw std::invalid_argument("dead cards must not overlap hole_cards or board");
+  return known | dead_mask;
+}
+
+}  // namespace
+
+OutsResult analyze_outs(const std::vector<uint8_t>& hole_cards,
+                        const std::vector<uint8_t>& board,
+                        const HandRange& opponent_range,
+                        std::uint64_t dead_mask,
+                        unsigned num_threads) {
+  if (hole_cards.size() != 2) throw std::invalid_argument("hole_cards must have exactly 2 cards");
+  if (board.size() != 3 && board.size() != 4) throw std::invalid_argument("board must have 3 or 4 cards");
+  const std::uint64_t known = known_cards(hole_cards, board, dead_mask);
+
+  std::vector<Holding> holdings;
+  for (int i = 0; i < kNumCombos; ++i) {
+    const std::uint64_t m = combo_mask(i);
+    if (opponent_range.weights[i] <= 0 || (m & known)) continue;
+    const auto hc = combo_cards(i);
+    holdings.push_back({hc.first, hc.second, opponent_range.weights[i], m});
+  }
+  if (holdings.empty()) throw std::invalid_argument("opponent range has no combos left after card removal");
+
+  const int n = static_cast<int>(board.size());
+  const uint8_t* hole = hole_cards.data();
+  const RangeSums sums(holdings);
+  HandState shared;
+  int ranks[5], suits[4] = {};
+  for (int i = 0; i < n; ++i) {
+    shared.add(board[i]);
+    ranks[i] = card_rank(board[i]);
+    ++suits[card_suit(board[i])];
+  }
+  // Rank tables for the board now and with each next card's rank.
+  std::vector<HandRank> tables(14 * kRankCells);
+  for (int x = 0; x <= 13; ++x) {
+    ranks[n] = x;
+    rank_table(ranks, x < 13 ? n + 1 : n, &tables[x * kRankCells]);
+  }
+
+  OutsResult result;
+  HandState now = shared;
+  now.add(hole[0]);
+  now.add(hole[1]);
+  const HandRank mine = now.rank();
+  result.category = hand_category(mine);
+  double won_now = 0, total_now = 0;
+  sums.tally(shared, suits, mine, &tables[13 * kRankCells], nullptr, 0, won_now, total_now);
+  result.strength = total_now > 0 ? static_cast<float>(won_now / total_now) : 0.0f;
+
+  // Flop: every (turn, river) board against every live holding, once per
+  // unordered pair.
+  std::unique_ptr<RiverPairs> pairs;
+  if (n == 3) pairs = std::make_unique<RiverPairs>(board, hole, sums, known, num_threads);
+
+  parallel_for(52, num_threads, [&](std::size_t ci) {
+    const uint8_t c = static_cast<uint8_t>(ci);
+    if (known >> c & 1) return;
+    CardOutcome& out = result.cards[c];
+    out.live = true;
+    uint8_t next[5];
+    std::copy(board.begin(), board.end(), next);
+    next[n] = c;
+    HandState b = shared;
+    b.add(c);
+    HandState with_hero = b;
+    with_hero.add(hole[0]);
+    with_hero.add(hole[1]);
+    const HandRank hero = with_hero.rank();
+    out.category = static_cast<std::uint8_t>(hand_category(hero));
+    out.improves = out.category > result.category && out.category > board_category(next, n + 1);
+    int next_suits[4];
+    std::copy(suits, suits + 4, next_suits);
+    ++next_suits[card_suit(c)];
+    double won_next = 0, total_next = 0;
+    sums.tally(b, next_suits, hero, &tables[card_rank(c) * kRankCells], &c, 1, won_next, total_next);
+    const double s = total_next > 0 ? won_next / total_next : 0.0;
+    out.strength = static_cast<float>(s);
+    out.leads = s > 0.5;
+    if (n == 4) {
+      out.equity = out.strength;
+      return;
+    }
+
+    double won = 0, total = 0;
+    for (int r = 0; r < 52; ++r) {
+      if (r == c || (known >> r & 1)) continue;
+      const int category = pairs->hero[c * 52 + r];
+      if (category > out.category && category > pairs->board[c * 52 + r]) ++out.improving_pairs;
+      won += pairs->won[c * 52 + r];
+      total += pairs->total[c * 52 + r];
+    }
+    out.equity = total > 0 ? static_cast<float>(won / total) : out.strength;
+  });
+
+  for (const CardOutcome& o : result.cards) {
+    if (!o.live) continue;
+    ++result.live_cards;
+    result.improving += o.improves;
+    result.outs += o.leads && result.strength < 0.5f;
+  }
+  return result;
+}
+
+HoldingsBreakdown classify_holdings(const std::vector<uint8_t>& hole_cards,
+                                    const std::vector<uint8_t>& board,
+                                    std::uint64_t dead_mask) {
+  if (hole_cards.size() != 2) throw std::invalid_argument("hole_cards must have exactly 2 cards");
+  if (board.size() < 3 || board.size() > 5) throw std::invalid_argument("board must have 3 to 5 cards");
+  const std::uint64_t known = known_cards(hole_cards, board, dead_mask);
+
+  const int n = static_cast<int>(board.size());
+  uint8_t cards[7];
+  std::copy(board.begin(), board.end(), cards);
+  cards[n] = hole_cards[0];
+  cards[n + 1] = hole_cards[1];
+  HoldingsBreakdown out;
+  out.hero_rank = evaluate_hand(cards, n + 2);
+  out.category = hand_category(out.hero_rank);
+
+  for (int i = 0; i < kNumCombos; ++i) {
+    if (combo_mask(i) & known) continue;
+    const auto hc = combo_cards(i);
+    cards[n] = hc.first;
+    cards[n + 1] = hc.second;
+    const HandRank r = evaluate_hand(cards, n + 2);
+    const int cat = hand_category(r);
+    if (r > out.hero_rank) {
+      out.ahead.push_back({i, r});
+      ++out.ahead_by_category[cat];
+    } else if (r == out.hero_rank) {
+      out.tied.push_back({i, r});
+      ++out.tied_by_category[cat];
+    } else {
+      out.behind.push_back({i, r});
+      ++out.behind_by_category[cat];
+    }
+  }
+  auto strongest_first = [](const RankedHolding& a, const RankedHolding& b) {
+    return a.rank != b.rank ? a.rank > b.rank : a.combo < b.combo;
+  };
+  std::sort(out.ahead.begin(), out.ahead.end(), strongest_first);
+  std::sort(out.behind.begin(), out.behind.end(), strongest_first);
+  const double total = static_cast<double>(out.ahead.size() + out.tied.size() + out.behind.size());
+  if (total > 0) out.percentile = (out.behind.size() + 0.5 * out.tied.size()) / total;
+  return out;
+}
+
+}  // namespace poker_sim
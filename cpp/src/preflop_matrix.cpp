@@ -0,0 +1,314 @@
+#include "poker_sim/preflop_matrix.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/hand_index.hpp"
+#include "poker_sim/parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+/// Layout version of preflop matrix tables (TableKind::PREFLOP_MATRIX).
+constexpr std::uint32_t kPreflopMatrixVersion = 1;
+
+constexpr int kClasses = kNumPreflopClasses;
+constexpr int kCells = kClasses * kClasses;
+
+/// Cards left beside a river board, and the holdings they form.
+constexpr int kLive = 47;
+constexpr int kPairs = kLive * (kLive - 1) / 2;
+
+/// Boards swept per work unit.
+constexpr std::size_t kBoardsPerChunk = 256;
+
+/// Win and tie counts of every class against every class on one river board.
+/// Holdings are swept in strength order; per-class counts of the weaker ones,
+/// overall and per card, give each holding's wins against every class in one
+/// pass over the classes, blocked holdings subtracted.
+struct BoardSweep {
+  std::uint64_t order[kPairs];  // rank << 11 | pair
+  uint8_t first[kPairs], second[kPairs];  // live-card positions of each pair
+  int cls[kPairs];
+  std::int32_t below[kClasses];
+  std::int32_t card_below[kLive][kClasses];
+  std::int32_t group[kClasses];  // the current rank group; zero between groups
+  std::int32_t card_group[kLive][kClasses];
+  std::int32_t win[kCells], tie[kCells];
+
+  BoardSweep() {
+    for (int j = 0, p = 0; j < kLive; ++j)
+      for (int i = 0; i < j; ++i, ++p) {
+        first[p] = static_cast<uint8_t>(i);
+        second[p] = static_cast<uint8_t>(j);
+      }
+    std::memset(group, 0, sizeof group);
+    std::memset(card_group, 0, sizeof card_group);
+  }
+
+  void run(const uint8_t* board, const uint8_t* live) {
+    uint8_t cards[7];
+    std::copy(board, board + 5, cards);
+    for (int p = 0; p < kPairs; ++p) {
+      cards[5] = live[first[p]];
+      cards[6] = live[second[p]];
+      order[p] = static_cast<std::uint64_t>(evaluate_hand(cards, 7)) << 11 | p;
+      cls[p] = preflop_class(cards[5], cards[6]);
+    }
+    std::sort(order, order + kPairs);
+    std::memset(below, 0, sizeof below);
+    std::memset(card_below, 0, sizeof card_below);
+    std::memset(win, 0, sizeof win);
+    std::memset(tie, 0, sizeof tie);
+
+    int present[kClasses];
+    for (int g = 0; g < kPairs;) {
+      int e = g;
+      while (e < kPairs && (order[e] >> 11) == (order[g] >> 11)) ++e;
+      for (int i = g; i < e; ++i) {
+        const int p = order[i] & 0x7FF;
+        std::int32_t* row = win + cls[p] * kClasses;
+        const std::int32_t* cx = card_below[first[p]];
+        const std::int32_t* cy = card_below[second[p]];
+        for (int j = 0; j < kClasses; ++j) row[j] += below[j] - cx[j] - cy[j];
+      }
+      if (e - g > 1) {
+        // Ties only meet classes in the group; each holding counts itself
+        // once in group and once per card, so it adds itself back.
+        int n = 0;
+        for (int i = g; i < e; ++i) {
+          const int p = order[i] & 0x7FF, c = cls[p];
+          if (!group[c]) present[n++] = c;
+          ++group[c];
+          ++card_group[first[p]][c];
+          ++card_group[second[p]][c];
+        }
+        for (int i = g; i < e; ++i) {
+          const int p = order[i] & 0x7FF;
+          std::int32_t* row = tie + cls[p] * kClasses;
+          const std::int32_t* cx = card_group[first[p]];
+          const std::int32_t* cy = card_group[second[p]];
+          for (int k = 0; k < n; ++k) row[present[k]] += group[present[k]] - cx[present[k]] - cy[present[k]];
+          ++row[cls[p]];
+        }
+        for (int i = g; i < e; ++i) {
+          const int p = order[i] & 0x7FF;
+          card_group[first[p]][cls[p]] = 0;
+          card_group[second[p]][cls[p]] = 0;
+        }
+        for (int k = 0; k < n; ++k) group[present[k]] = 0;
+      }
+      for (int i = g; i < e; ++i) {
+        const int p = order[i] & 0x7FF, c = cls[p];
+        ++below[c];
+        ++card_below[first[p]][c];
+        ++card_below[second[p]][c];
+      }
+      g = e;
+    }
+  }
+};
+
+/// preflop_matchups for every pair of classes. The holdings of a class are
+/// suit relabellings of each other, so one of them, met against every
+/// holding, stands for all.
+struct MatchupTable {
+  std::array<int, kCells> count{};
+  MatchupTable() {
+    int cls[kNumCombos];
+    for (int c = 0; c < kNumCombos; ++c) {
+      const auto hc = combo_cards(c);
+      cls[c] = preflop_class(hc.first, hc.second);
+    }
+    bool seen[kClasses] = {};
+    for (int a = 0; a < kNumCombos; ++a) {
+      if (seen[cls[a]]) continue;
+      seen[cls[a]] = true;
+      int* row = &count[cls[a] * kClasses];
+      for (int b = 0; b < kNumCombos; ++b)
+        if (!(combo_mask(a) & combo_mask(b))) row[cls[b]] += preflop_class_combos(cls[a]);
+    }
+  }
+};
+
+const MatchupTable& matchup_table() {
+  static const MatchupTable table;
+  return table;
+}
+
+void check_class(int cls) {
+  if (cls < 0 || cls >= kClasses) throw std::invalid_argument("preflop class out of range 0-168");
+}
+
+std::mutex g_matrix_mutex;
+std::shared_ptr<const PreflopMatrix> g_matrix;
+
+}  // namespace
+
+int preflop_matchups(int i, int j) {
+  check_class(i);
+  check_class(j);
+  return matchup_table().count[i * kClasses + j];
+}
+
+std::vector<float> compute_preflop_matrix(unsigned num_threads) {
+  const HandIndexer boards({5});
+
+  // Raw boards per canonical river board. A holding's class does not change
+  // under a relabelling of suits, so each canonical board's counts stand for
+  // every board in its orbit as they are.
+  std::vector<std::uint32_t> orbit(boards.size());
+  uint8_t raw[5];
+  for (raw[0] = 0; raw[0] < 52; ++raw[0])
+    for (raw[1] = raw[0] + 1; raw[1] < 52; ++raw[1])
+      for (raw[2] = raw[1] + 1; raw[2] < 52; ++raw[2])
+        for (raw[3] = raw[2] + 1; raw[3] < 52; ++raw[3])
+          for (raw[4] = raw[3] + 1; raw[4] < 52; ++raw[4]) ++orbit[boards.index(raw)];
+
+  // Sums are integers well inside a double's exact range, so the result does
+  // not depend on the order chunks finish in.
+  std::vector<double> wins(kCells), ties(kCells);
+  std::mutex sums_mutex;
+  const std::size_t chunks = (boards.size() + kBoardsPerChunk - 1) / kBoardsPerChunk;
+  parallel_for(chunks, num_threads, [&](std::size_t chunk) {
+    auto sweep = std::make_unique<BoardSweep>();
+    std::vector<double> w(kCells), t(kCells);
+    const std::size_t end = std::min<std::size_t>(boards.size(), (chunk + 1) * kBoardsPerChunk);
+    for (std::size_t b = chunk * kBoardsPerChunk; b < end; ++b) {
+      uint8_t board[5], live[kLive];
+      boards.unindex(b, board);
+      std::uint64_t board_mask = 0;
+      for (uint8_t c : board) board_mask |= 1ull << c;
+      for (int c = 0, n = 0; c < 52; ++c)
+        if (!(board_mask >> c & 1)) live[n++] = static_cast<uint8_t>(c);
+      sweep->run(board, live);
+      const double weight = orbit[b];
+      for (int v = 0; v < kCells; ++v) {
+        w[v] += weight * sweep->win[v];
+        t[v] += weight * sweep->tie[v];
+      }
+    }
+    std::lock_guard<std::mutex> lock(sums_mutex);
+    for (int v = 0; v < kCells; ++v) {
+      wins[v] += w[v];
+      ties[v] += t[v];
+    }
+  });
+
+  std::vector<float> values(2 * kCells);
+  const MatchupTable& n = matchup_table();
+  for (int v = 0; v < kCells; ++v) {
+    const double deals = static_cast<double>(n.count[v]) * kPreflopBoards;
+    values[v] = static_cast<float>(wins[v] / deals);
+    values[kCells + v] = static_cast<float>(ties[v] / deals);
+  }
+  return values;
+}
+
+void write_preflop_matrix_file(const std::string& path, const std::vector<float>& values, bool compress) {
+  if (values.size() != 2 * static_cast<std::size_t>(kCells))
+    throw std::invalid_argument("preflop matrix values must have 2 x 169 x 169 entries");
+  TableWriter writer(TableKind::PREFLOP_MATRIX, kPreflopMatrixVersion, {}, {kClasses});
+  writer.add_section("win", values.data(), kCells * sizeof(float), compress);
+  writer.add_section("tie", values.data() + kCells, kCells * sizeof(float), compress);
+  writer.write(path);
+}
+
+PreflopMatrix::PreflopMatrix(const std::string& path)
+    : file_(path, TableKind::PREFLOP_MATRIX, kPreflopMatrixVersion) {
+  if (file_.params()[0] != kClasses) throw std::runtime_error(path + " does not have 169 classes");
+  win_ = file_.array<float>("win", kCells);
+  tie_ = file_.array<float>("tie", kCells);
+}
+
+PreflopMatchup PreflopMatrix::matchup(int i, int j) const {
+  check_class(i);
+  check_class(j);
+  return {win_[i * kClasses + j], tie_[i * kClasses + j], static_cast<double>(matchup_table().count[i * kClasses + j])};
+}
+
+PreflopMatchup PreflopMatrix::versus_random(int i) const {
+  check_class(i);
+  const int* n = &matchup_table().count[i * kClasses];
+  PreflopMatchup out;
+  for (int j = 0; j < kClasses; ++j) {
+    out.win += n[j] * static_cast<double>(win_[i * kClasses + j]);
+    out.tie += n[j] * static_cast<double>(tie_[i * kClasses + j]);
+    out.matchups += n[j];
+  }
+  out.win /= out.matchups;
+  out.tie /= out.matchups;
+  return out;
+}
+
+RangeEquity preflop_range_equity(const PreflopMatrix& matrix, const HandRange& a, const HandRange& b) {
+  // Mean holding weight of each class in each range.
+  double w[2][kClasses] = {};
+  for (int c = 0; c < kNumCombos; ++c) {
+    const auto hc = combo_cards(c);
+    const int cls = preflop_class(hc.first, hc.second);
+    w[0][cls] += a.weights[c];
+    w[1][cls] += b.weights[c];
+  }
+  for (int s = 0; s < 2; ++s)
+    for (int i = 0; i < kClasses; ++i) w[s][i] /= preflop_class_combos(i);
+
+  // num[s][i]: class i of side s against the other range, weighted by the
+  // holding pairs it meets (den); the row and column sums of N o E.
+  const int* n = matchup_table().count.data();
+  const float* win = matrix.wins();
+  const float* tie = matrix.ties();
+  double num[2][kClasses] = {}, den[2][kClasses] = {};
+  RangeEquity result;
+  for (int i = 0; i < kClasses; ++i)
+    for (int j = 0; j < kClasses; ++j) {
+      const int v = i * kClasses + j;
+      const double eq = win[v] + tie[v] / 2.0;
+      const double ab = n[v] * w[1][j];
+      const double ba = n[v] * w[0][i];
+      num[0][i] += ab * eq;
+      den[0][i] += ab;
+      num[1][j] += ba * (1.0 - eq);
+      den[1][j] += ba;
+      const double m = w[0][i] * ab;
+      result.win[0] += m * win[v];
+      result.tie += m * tie[v];
+      result.matchups += m;
+    }
+  if (result.matchups <= 0) throw std::invalid_argument("ranges have no holdings that can meet");
+  result.win[0] /= result.matchups;
+  result.tie /= result.matchups;
+  result.win[1] = std::max(0.0, 1.0 - result.win[0] - result.tie);
+  for (int s = 0; s < 2; ++s) result.equity[s] = result.win[s] + result.tie / 2;
+  result.runouts = kPreflopBoards;
+
+  const HandRange* r[2] = {&a, &b};
+  for (int s = 0; s < 2; ++s)
+    for (int c = 0; c < kNumCombos; ++c) {
+      const double weight = r[s]->weights[c];
+      const auto hc = combo_cards(c);
+      const int cls = preflop_class(hc.first, hc.second);
+      if (weight <= 0 || den[s][cls] <= 0) continue;
+      const double met = den[s][cls] / preflop_class_combos(cls) * kPreflopBoards;
+      result.combos[s].push_back({c, num[s][cls] / den[s][cls], weight * met});
+    }
+  result.matchups *= kPreflopBoards;
+  return result;
+}
+
+void load_preflop_matrix(const std::string& path) {
+  std::shared_ptr<const PreflopMatrix> matrix;
+  if (!path.empty()) matrix = std::make_shared<const PreflopMatrix>(path);
+  std::lock_guard<std::mutex> lock(g_matrix_mutex);
+  g_matrix = std::move(matrix);
+}
+
+std::shared_ptr<const PreflopMatrix> preflop_matrix() {
+  std::lock_guard<std::mutex> lock(g_matrix_mutex);
+  return g_matrix;
+}
+
+}  // namespace poker_sim
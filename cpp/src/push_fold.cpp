@@ -0,0 +1,351 @@
+#include "poker_sim/push_fold.hpp"
+#include "poker_sim/icm.hpp"
+#include "poker_sim/parallel.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+constexpr int kClasses = kNumPreflopClasses;
+constexpr int kCells = kClasses * kClasses;
+
+/// Ordered pairs of disjoint holdings: 1326 * 1225.
+constexpr double kHoldingPairs = 1624350.0;
+
+/// Iterations between exploitability checks.
+constexpr int kCheckEvery = 50;
+
+/// Matchup counts N and N o E (E = hero equity) of every pair of classes.
+struct Matchups {
+  std::vector<double> n, ne, ne_t;  // row-major; ne_t = transpose of ne
+  ClassStrategy rows{};             // row sums of n
+  ClassStrategy prior{};            // probability of being dealt each class
+
+  explicit Matchups(const PreflopMatrix& matrix) : n(kCells), ne(kCells), ne_t(kCells) {
+    for (int i = 0; i < kClasses; ++i)
+      for (int j = 0; j < kClasses; ++j) {
+        const double count = preflop_matchups(i, j);
+        n[i * kClasses + j] = count;
+        ne[i * kClasses + j] = ne_t[j * kClasses + i] = count * matrix.equity(i, j);
+        rows[i] += count;
+      }
+    for (int i = 0; i < kClasses; ++i) prior[i] = rows[i] / kHoldingPairs;
+  }
+};
+
+/// y = A x with A given column by column (at = A transposed, row-major):
+/// the inner loop is an axpy, which vectorizes.
+void multiply(const std::vector<double>& at, const ClassStrategy& x, ClassStrategy& y) {
+  y.fill(0);
+  for (int j = 0; j < kClasses; ++j) {
+    const double xj = x[j];
+    if (xj == 0) continue;
+    const double* col = at.data() + j * kClasses;
+    for (int i = 0; i < kClasses; ++i) y[i] += col[i] * xj;
+  }
+}
+
+/// Throws std::invalid_argument for a spot solve() cannot take.
+void validate(const PushFoldSpot& spot) {
+  const int n = static_cast<int>(spot.stacks.size());
+  if (n < 2 || n > kPushFoldMaxPlayers) throw std::invalid_argument("push/fold needs 2-9 players");
+  if (spot.small_blind < 0 || spot.small_blind > 1) throw std::invalid_argument("small blind must be 0-1 big blinds");
+  if (spot.ante < 0) throw std::invalid_argument("ante must not be negative");
+  for (int s = 0; s < n; ++s) {
+    const double blind = s == n - 1 ? 1.0 : s == n - 2 ? spot.small_blind : 0.0;
+    if (!(spot.stacks[s] > blind + spot.ante)) throw std::invalid_argument("every stack must cover its blind and ante");
+  }
+  for (double p : spot.payouts)
+    if (!(p >= 0)) throw std::invalid_argument("payouts must not be negative");
+  if (!spot.payouts.empty() && !(std::accumulate(spot.payouts.begin(), spot.payouts.end(), 0.0) > 0))
+    throw std::invalid_argument("payouts must not all be zero");
+}
+
+/// Payout units per solver utility unit: 1 for chips. With payouts, prize
+/// equity is valued at the table's chips per prize pool, so the tolerance
+/// means about the same in both.
+double utility_unit(const PushFoldSpot& spot) {
+  if (spot.payouts.empty()) return 1.0;
+  return std::accumulate(spot.payouts.begin(), spot.payouts.end(), 0.0) /
+         std::accumulate(spot.stacks.begin(), spot.stacks.end(), 0.0);
+}
+
+/// Utility of every seat at each terminal: its chip change, or with payouts
+/// its change in ICM equity over utility_unit.
+struct Payoffs {
+  int players;
+  std::vector<double> steal;       // [jammer][seat]: everyone folds to the jam (or to the big blind)
+  std::vector<double> win, lose;   // [(jammer * players + caller)][seat]: the jammer wins / loses
+
+  explicit Payoffs(const PushFoldSpot& spot) : players(static_cast<int>(spot.stacks.size())) {
+    const int n = players;
+    std::vector<double> posted(n, spot.ante);
+    posted[n - 2] += spot.small_blind;
+    posted[n - 1] += 1.0;
+    double dead = 0;
+    for (int s = 0; s < n; ++s) dead += posted[s];
+    steal.assign(n * n, 0);
+    win.assign(n * n * n, 0);
+    lose.assign(n * n * n, 0);
+    for (int p = 0; p < n; ++p) {
+      for (int s = 0; s < n; ++s) steal[p * n + s] = s == p ? dead - posted[p] : -posted[s];
+      for (int q = p + 1; q < n; ++q) {
+        // Both put in the smaller stack; the others' blinds and antes are dead.
+        const double risk = std::min(spot.stacks[p], spot.stacks[q]);
+        const double pot = 2 * risk + dead - posted[p] - posted[q];
+        double* w = &win[(p * n + q) * n];
+        double* l = &lose[(p * n + q) * n];
+        for (int s = 0; s < n; ++s) w[s] = l[s] = -posted[s];
+        w[p] = pot - risk;
+        w[q] = -risk;
+        l[p] = -risk;
+        l[q] = pot - risk;
+      }
+    }
+    if (!spot.payouts.empty()) {
+      const double unit = utility_unit(spot);
+      const std::vector<double> before = icm_equity(spot.stacks, spot.payouts).equity;
+      std::vector<double> after(n);
+      auto to_icm = [&](double* u) {
+        for (int s = 0; s < n; ++s) after[s] = std::max(0.0, spot.stacks[s] + u[s]);
+        const std::vector<double> e = icm_equity(after, spot.payouts).equity;
+        for (int s = 0; s < n; ++s) u[s] = (e[s] - before[s]) / unit;
+      };
+      for (int p = 0; p < n; ++p) {
+        to_icm(&steal[p * n]);
+        for (int q = p + 1; q < n; ++q) {
+          to_icm(&win[(p * n + q) * n]);
+          to_icm(&lose[(p * n + q) * n]);
+        }
+      }
+    }
+  }
+};
+
+/// Jam and call probabilities, shaped like PushFoldSolution.
+struct Strategy {
+  std::vector<ClassStrategy> jam, call;
+  explicit Strategy(int n) : jam(n), call(n * n) {}
+};
+
+/// Counterfactual values of both actions at every decision, each weighted
+/// by the probability of its class reaching it; and each seat's expected
+/// utility under the strategy.
+struct Values {
+  std::vector<ClassStrategy> jam, jam_fold, call, call_fold;
+  std::vector<double> ev;
+  explicit Values(int n) : jam(n), jam_fold(n), call(n * n), call_fold(n * n), ev(n) {}
+};
+
+class Game {
+ public:
+  Game(const Matchups& m, const PushFoldSpot& spot) : m_(m), pay_(spot), n_(pay_.players) {}
+
+  void evaluate(const Strategy& st, Values& out) const {
+    const int n = n_;
+    // Probability each seat folds when first in, ignoring card removal.
+    std::vector<double> folds(n, 1.0);
+    for (int r = 0; r < n - 1; ++r)
+      for (int i = 0; i < kClasses; ++i) folds[r] -= m_.prior[i] * st.jam[r][i];
+
+    std::vector<double> after(pay_.steal.begin() + (n - 1) * n, pay_.steal.end());  // W(n - 1)
+    std::vector<ClassStrategy> calls(n), wins(n), cont(n);
+    std::vector<std::array<double, kClasses>> z(n);  // z[seat][class] as action moves to earlier callers
+    ClassStrategy tmp, reach, w, nw, held;
+    for (int p = n - 2; p >= 0; --p) {
+      double enter = 1.0;
+      for (int r = 0; r < p; ++r) enter *= folds[r];
+
+      // Per jamming class: probability each later seat calls, and calls and loses.
+      for (int q = p + 1; q < n; ++q) {
+        const ClassStrategy& c = st.call[q * n + p];
+        multiply(m_.n, c, calls[q]);
+        multiply(m_.ne_t, c, wins[q]);
+        for (int i = 0; i < kClasses; ++i) {
+          calls[q][i] /= m_.rows[i];
+          wins[q][i] /= m_.rows[i];
+        }
+      }
+      // Back from the last seat: expected utility of every seat once the jam
+      // reaches seat q, given the jamming class.
+      const double* steal = &pay_.steal[p * n];
+      for (int s = 0; s < n; ++s) z[s].fill(steal[s]);
+      for (int q = n - 1; q > p; --q) {
+        const double* uw = &pay_.win[(p * n + q) * n];
+        const double* ul = &pay_.lose[(p * n + q) * n];
+        cont[q] = z[q];
+        for (int s = 0; s < n; ++s)
+          for (int i = 0; i < kClasses; ++i) {
+            const double a = calls[q][i], b = wins[q][i];
+            z[s][i] = (a - b) * ul[s] + b * uw[s] + (1 - a) * z[s][i];
+          }
+      }
+
+      // Jammer: jam against fold, with each class's reach.
+      std::vector<double> here(n, 0.0);
+      double jams = 0;
+      for (int i = 0; i < kClasses; ++i) {
+        const double weight = enter * m_.prior[i];
+        out.jam[p][i] = weight * z[p][i];
+        out.jam_fold[p][i] = weight * after[p];
+        const double pj = m_.prior[i] * st.jam[p][i];
+        jams += pj;
+        for (int s = 0; s < n; ++s) here[s] += pj * z[s][i];
+      }
+      for (int s = 0; s < n; ++s) here[s] += (1 - jams) * after[s];
+      after.swap(here);
+
+      // Callers: each holding of the caller meets the jamming classes
+      // through the matchup counts, so the pair's card removal is exact.
+      reach.fill(1.0);
+      for (int q = p + 1; q < n; ++q) {
+        const double* uw = &pay_.win[(p * n + q) * n];
+        const double* ul = &pay_.lose[(p * n + q) * n];
+        for (int i = 0; i < kClasses; ++i) w[i] = enter / kHoldingPairs * st.jam[p][i] * reach[i];
+        multiply(m_.n, w, nw);
+        multiply(m_.ne, w, tmp);  // column j: sum_i N_ij E_ij w_i, the jammer winning
+        ClassStrategy& call = out.call[q * n + p];
+        for (int j = 0; j < kClasses; ++j) call[j] = ul[q] * nw[j] + (uw[q] - ul[q]) * tmp[j];
+        for (int i = 0; i < kClasses; ++i) held[i] = w[i] * cont[q][i];
+        multiply(m_.n, held, out.call_fold[q * n + p]);
+        for (int i = 0; i < kClasses; ++i) reach[i] *= 1 - calls[q][i];
+      }
+    }
+    out.ev = after;
+  }
+
+ private:
+  const Matchups& m_;
+  Payoffs pay_;
+  int n_;
+};
+
+/// What each seat gains by best-responding at every one of its decisions.
+double exploitability(const Strategy& st, const Values& v, int n) {
+  std::vector<double> gain(n, 0.0);
+  auto add = [&](int seat, const ClassStrategy& s, const ClassStrategy& act, const ClassStrategy& fold) {
+    for (int i = 0; i < kClasses; ++i)
+      gain[seat] += std::max(act[i], fold[i]) - (s[i] * act[i] + (1 - s[i]) * fold[i]);
+  };
+  for (int p = 0; p < n - 1; ++p) {
+    add(p, st.jam[p], v.jam[p], v.jam_fold[p]);
+    for (int q = p + 1; q < n; ++q) add(q, st.call[q * n + p], v.call[q * n + p], v.call_fold[q * n + p]);
+  }
+  return *std::max_element(gain.begin(), gain.end());
+}
+
+/// One decision's CFR+ state: positive regrets of acting and folding.
+struct Regrets {
+  ClassStrategy act{}, fold{};
+
+  /// Regret-matched probability of acting, into s.
+  void match(ClassStrategy& s) const {
+    for (int i = 0; i < kClasses; ++i) {
+      const double sum = act[i] + fold[i];
+      s[i] = sum > 0 ? act[i] / sum : 0.5;
+    }
+  }
+
+  void update(const ClassStrategy& s, const ClassStrategy& va, const ClassStrategy& vf) {
+    for (int i = 0; i < kClasses; ++i) {
+      const double v = s[i] * va[i] + (1 - s[i]) * vf[i];
+      act[i] = std::max(0.0, act[i] + va[i] - v);
+      fold[i] = std::max(0.0, fold[i] + vf[i] - v);
+    }
+  }
+};
+
+PushFoldSolution solve(const Matchups& m, const PushFoldSpot& spot, int max_iterations, double tolerance) {
+  validate(spot);
+  const int n = static_cast<int>(spot.stacks.size());
+  if (max_iterations < 1) throw std::invalid_argument("max_iterations must be positive");
+  const Game game(m, spot);
+
+  // Decisions in Strategy order: jam[p] at p, call[q * n + p] at n + q * n + p.
+  std::vector<Regrets> regrets(n + n * n);
+  Strategy cur(n), avg(n);
+  Values values(n);
+  double weights = 0;
+  auto for_each = [&](auto&& fn) {
+    for (int p = 0; p < n - 1; ++p) {
+      fn(regrets[p], cur.jam[p], avg.jam[p], values.jam[p], values.jam_fold[p]);
+      for (int q = p + 1; q < n; ++q) {
+        const int k = q * n + p;
+        fn(regrets[n + k], cur.call[k], avg.call[k], values.call[k], values.call_fold[k]);
+      }
+    }
+  };
+
+  PushFoldSolution out;
+  out.players = n;
+  int t = 1;
+  for (; t <= max_iterations; ++t) {
+    for_each([](Regrets& r, ClassStrategy& s, ClassStrategy&, const ClassStrategy&, const ClassStrategy&) {
+      r.match(s);
+    });
+    game.evaluate(cur, values);
+    // Linear averaging: iteration t weighs t.
+    for_each([&](Regrets& r, ClassStrategy& s, ClassStrategy& a, const ClassStrategy& va, const ClassStrategy& vf) {
+      r.update(s, va, vf);
+      for (int i = 0; i < kClasses; ++i) a[i] += t * s[i];
+    });
+    weights += t;
+    if (t % kCheckEvery == 0 || t == max_iterations) {
+      Strategy mean = avg;
+      for (auto& s : mean.jam)
+        for (double& x : s) x /= weights;
+      for (auto& s : mean.call)
+        for (double& x : s) x /= weights;
+      Values v(n);
+      game.evaluate(mean, v);
+      out.exploitability = exploitability(mean, v, n);
+      out.jam = std::move(mean.jam);
+      out.call = std::move(mean.call);
+      out.ev = v.ev;
+      if (out.exploitability < tolerance) break;
+    }
+  }
+  out.iterations = std::min(t, max_iterations);
+  const double unit = utility_unit(spot);
+  for (double& e : out.ev) e *= unit;
+  out.exploitability *= unit;
+  return out;
+}
+
+}  // namespace
+
+PushFoldSolution solve_push_fold(const PreflopMatrix& matrix,
+                                 const PushFoldSpot& spot,
+                                 int max_iterations,
+                                 double tolerance) {
+  const Matchups m(matrix);
+  return solve(m, spot, max_iterations, tolerance);
+}
+
+std::vector<PushFoldSolution> push_fold_charts(const PreflopMatrix& matrix,
+                                               const std::vector<double>& depths,
+                                               int players,
+                                               double ante,
+                                               const std::vector<double>& payouts,
+                                               int max_iterations,
+                                               double tolerance,
+                                               unsigned num_threads) {
+  const Matchups m(matrix);
+  std::vector<PushFoldSolution> out(depths.size());
+  std::vector<PushFoldSpot> spots(depths.size());
+  for (std::size_t d = 0; d < depths.size(); ++d) {
+    spots[d].stacks.assign(std::max(players, 0), depths[d]);
+    spots[d].ante = ante;
+    spots[d].payouts = payouts;
+  }
+  // Validate up front so a bad depth throws on the calling thread.
+  for (const PushFoldSpot& spot : spots) validate(spot);
+  if (max_iterations < 1) throw std::invalid_argument("max_iterations must be positive");
+  parallel_for(depths.size(), num_threads, [&](std::size_t d) { out[d] = solve(m, spots[d], max_iterations, tolerance); });
+  return out;
+}
+
+}  // namespace poker_sim
@@ -0,0 +1,72 @@
+#include "poker_sim/qmc.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace poker_sim {
+
+namespace {
+
+/// Joe-Kuo (new-joe-kuo-6.21201) primitive polynomials for dimensions 2..21:
+/// degree s, interior coefficient bits a, and initial direction numbers m_1..m_s.
+struct Primitive {
+  int s;
+  std::uint32_t a;
+  std::uint32_t m[7];
+};
+
+const Primitive kPrimitives[SobolSequence::kMaxDims - 1] = {
+  {1, 0, {1}},
+  {2, 1, {1, 3}},
+  {3, 1, {1, 3, 1}},
+  {3, 2, {1, 1, 1}},
+  {4, 1, {1, 1, 3, 3}},
+  {4, 4, {1, 3, 5, 13}},
+  {5, 2, {1, 1, 5, 5, 17}},
+  {5, 4, {1, 1, 5, 5, 5}},
+  {5, 7, {1, 1, 7, 11, 19}},
+  {5, 11, {1, 1, 5, 1, 1}},
+  {5, 13, {1, 1, 1, 3, 11}},
+  {5, 14, {1, 3, 5, 5, 31}},
+  {6, 1, {1, 3, 3, 9, 7, 49}},
+  {6, 13, {1, 1, 1, 15, 21, 21}},
+  {6, 16, {1, 3, 1, 13, 27, 49}},
+  {6, 19, {1, 1, 1, 15, 7, 5}},
+  {6, 22, {1, 3, 1, 15, 13, 25}},
+  {6, 25, {1, 1, 5, 5, 19, 61}},
+  {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+  {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+};
+
+}  // namespace
+
+SobolSequence::SobolSequence(int dims, std::vector<std::uint32_t> shift)
+    : dims_(dims), directions_(static_cast<std::size_t>(dims) * 32), state_(std::move(shift)) {
+  if (dims < 1 || dims > kMaxDims) throw std::invalid_argument("Sobol dimension out of range");
+  state_.resize(dims, 0);
+
+  // First dimension: van der Corput, v_k = 2^(32-k).
+  for (int k = 0; k < 32; ++k) directions_[k] = 1u << (31 - k);
+  for (int d = 1; d < dims; ++d) {
+    const Primitive& p = kPrimitives[d - 1];
+    std::uint32_t* v = &directions_[static_cast<std::size_t>(d) * 32];
+    for (int k = 0; k < p.s; ++k) v[k] = p.m[k] << (31 - k);
+    for (int k = p.s; k < 32; ++k) {
+      v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+      for (int l = 1; l < p.s; ++l)
+        if ((p.a >> (p.s - 1 - l)) & 1) v[k] ^= v[k - l];
+    }
+  }
+}
+
+void SobolSequence::next(std::uint32_t* out) {
+  // Point 0 is the shift itself; point i+1 flips the direction number at the
+  // lowest zero bit of i.
+  for (int d = 0; d < dims_; ++d) out[d] = state_[d];
+  int c = 0;
+  for (std::uint32_t i = index_; i & 1; i >>= 1) ++c;
+  if (c < 32)
+    for (int d = 0; d < dims_; ++d) state_[d] ^= directions_[static_cast<std::size_t>(d) * 32 + c];
+  ++index_;
+}
+
+}  // namespace poker_sim
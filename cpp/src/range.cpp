@@ -0,0 +1,214 @@
+#include "poker_sim/range.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+const std::string kRankChars = "23456789TJQKA";
+const std::string kSuitChars = "cdhs";
+
+int parse_rank(char ch) {
+  auto pos = kRankChars.find(static_cast<char>(std::toupper(static_cast<unsigned char>(ch))));
+  return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+int parse_suit(char ch) {
+  auto pos = kSuitChars.find(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+  return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+uint8_t card(int rank, int suit) { return static_cast<uint8_t>(suit * 13 + rank); }
+
+[[noreturn]] void bad_token(const std::string& token) {
+  throw std::invalid_argument("invalid range token: '" + token + "'");
+}
+
+/// Adds every combo of ranks (hi, lo); suited: 's', 'o' or 0 for both.
+void add_class(HandRange& r, int hi, int lo, char suited, double w) {
+  for (int s1 = 0; s1 < 4; ++s1)
+    for (int s2 = 0; s2 < 4; ++s2) {
+      if (hi == lo && s2 <= s1) continue;
+      if (suited == 's' && s1 != s2) continue;
+      if (suited == 'o' && s1 == s2) continue;
+      r.weights[combo_index(card(hi, s1), card(lo, s2))] = w;
+    }
+}
+
+/// A class like "AKs" / "TT" / "AK": (high rank, low rank, suitedness).
+struct Class {
+  int hi, lo;
+  char suited;
+};
+
+bool parse_class(const std::string& t, Class& c) {
+  if (t.size() < 2 || t.size() > 3) return false;
+  c.hi = parse_rank(t[0]);
+  c.lo = parse_rank(t[1]);
+  c.suited = 0;
+  if (c.hi < 0 || c.lo < 0) return false;
+  if (c.hi < c.lo) std::swap(c.hi, c.lo);
+  if (t.size() == 3) {
+    char s = static_cast<char>(std::tolower(static_cast<unsigned char>(t[2])));
+    if ((s != 's' && s != 'o') || c.hi == c.lo) return false;
+    c.suited = s;
+  }
+  return true;
+}
+
+void add_token(HandRange& r, const std::string& token) {
+  std::string t = token;
+  double w = 1.0;
+  auto colon = t.find(':');
+  if (colon != std::string::npos) {
+    const std::string ws = t.substr(colon + 1);
+    char* end = nullptr;
+    w = std::strtod(ws.c_str(), &end);
+    if (ws.empty() || *end != '\0' || !(w >= 0.0 && w <= 1.0)) bad_token(token);
+    t = t.substr(0, colon);
+  }
+  std::string lower = t;
+  for (char& ch : lower) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+  if (lower == "random" || lower == "any" || lower == "xx") {
+    for (double& x : r.weights) x = w;
+    return;
+  }
+
+  // Single combo: "AhKd".
+  if (t.size() == 4 && parse_suit(t[1]) >= 0 && parse_suit(t[3]) >= 0) {
+    int r1 = parse_rank(t[0]), s1 = parse_suit(t[1]), r2 = parse_rank(t[2]), s2 = parse_suit(t[3]);
+    if (r1 < 0 || r2 < 0 || (r1 == r2 && s1 == s2)) bad_token(token);
+    r.weights[combo_index(card(r1, s1), card(r2, s2))] = w;
+    return;
+  }
+
+  Class a, b;
+  // Dash range: "77-TT" or "A2s-A5s" (same high card, kicker span).
+  auto dash = t.find('-');
+  if (dash != std::string::npos) {
+    if (!parse_class(t.substr(0, dash), a) || !parse_class(t.substr(dash + 1), b)) bad_token(token);
+    if (a.hi == a.lo && b.hi == b.lo) {
+      for (int p = std::min(a.hi, b.hi); p <= std::max(a.hi, b.hi); ++p) add_class(r, p, p, 0, w);
+      return;
+    }
+    if (a.hi != b.hi || a.suited != b.suited || a.hi == a.lo || b.hi == b.lo) bad_token(token);
+    for (int k = std::min(a.lo, b.lo); k <= std::max(a.lo, b.lo); ++k) add_class(r, a.hi, k, a.suited, w);
+    return;
+  }
+
+  // Plus: "TT+" (pairs up to AA) or "AQs+" (kicker up to one below the high card).
+  bool plus = !t.empty() && t.back() == '+';
+  if (plus) t.pop_back();
+  if (!parse_class(t, a)) bad_token(token);
+  if (!plus) {
+    add_class(r, a.hi, a.lo, a.suited, w);
+  } else if (a.hi == a.lo) {
+    for (int p = a.hi; p <= 12; ++p) add_class(r, p, p, 0, w);
+  } else {
+    for (int k = a.lo; k < a.hi; ++k) add_class(r, a.hi, k, a.suited, w);
+  }
+}
+
+}  // namespace
+
+std::pair<uint8_t, uint8_t> combo_cards(int index) {
+  static const auto table = [] {
+    std::array<std::pair<uint8_t, uint8_t>, kNumCombos> t{};
+    for (int b = 1; b < 52; ++b)
+      for (int a = 0; a < b; ++a)
+        t[combo_index(static_cast<uint8_t>(a), static_cast<uint8_t>(b))] = {static_cast<uint8_t>(a),
+                                                                            static_cast<uint8_t>(b)};
+    return t;
+  }();
+  return table[index];
+}
+
+std::uint64_t combo_mask(int index) {
+  auto c = combo_cards(index);
+  return (1ull << c.first) | (1ull << c.second);
+}
+
+int preflop_class(uint8_t a, uint8_t b) {
+  const int hi = 12 - std::max(card_rank(a), card_rank(b)), lo = 12 - std::min(card_rank(a), card_rank(b));
+  return card_suit(a) == card_suit(b) ? hi * 13 + lo : lo * 13 + hi;
+}
+
+int preflop_class(const std::string& name) {
+  Class c;
+  if (!parse_class(name, c) || (c.hi != c.lo && !c.suited))
+    throw std::invalid_argument("invalid starting-hand class: '" + name + "'");
+  const int hi = 12 - c.hi, lo = 12 - c.lo;
+  return c.suited == 's' || c.hi == c.lo ? hi * 13 + lo : lo * 13 + hi;
+}
+
+std::string preflop_class_name(int cls) {
+  if (cls < 0 || cls >= kNumPreflopClasses) throw std::invalid_argument("preflop class out of range 0-168");
+  const int row = cls / 13, col = cls % 13;
+  std::string name{kRankChars[12 - std::min(row, col)], kRankChars[12 - std::max(row, col)]};
+  if (row != col) name += row < col ? 's' : 'o';
+  return name;
+}
+
+HandRange HandRange::parse(const std::string& text) {
+  HandRange r;
+  std::string token;
+  auto flush = [&]() {
+    if (!token.empty()) add_token(r, token);
+    token.clear();
+  };
+  for (char ch : text) {
+    if (ch == ',') flush();
+    else if (!std::isspace(static_cast<unsigned char>(ch))) token += ch;
+  }
+  flush();
+  if (r.size() == 0) throw std::invalid_argument("range is empty: '" + text + "'");
+  return r;
+}
+
+HandRange HandRange::full() {
+  HandRange r;
+  r.weights.fill(1.0);
+  return r;
+}
+
+int HandRange::size() const {
+  return static_cast<int>(std::count_if(weights.begin(), weights.end(), [](double w) { return w > 0; }));
+}
+
+AliasTable::AliasTable(const HandRange& range, std::uint64_t dead_mask) {
+  std::vector<double> p;
+  for (int i = 0; i < kNumCombos; ++i) {
+    if (range.weights[i] <= 0 || (combo_mask(i) & dead_mask)) continue;
+    combos_.push_back(i);
+    p.push_back(range.weights[i]);
+  }
+  const std::size_t n = combos_.size();
+  if (n == 0) return;
+
+  // Vose: scale to mean 1, then pair each short column with a long one.
+  double total = 0;
+  for (double x : p) total += x;
+  for (double& x : p) x *= n / total;
+  std::vector<std::size_t> small, large;
+  for (std::size_t i = 0; i < n; ++i) (p[i] < 1.0 ? small : large).push_back(i);
+  threshold_.assign(n, 1ull << 32);
+  alias_.assign(combos_.begin(), combos_.end());
+  while (!small.empty() && !large.empty()) {
+    std::size_t s = small.back(), l = large.back();
+    small.pop_back();
+    threshold_[s] = static_cast<std::uint64_t>(p[s] * 4294967296.0);
+    alias_[s] = combos_[l];
+    p[l] -= 1.0 - p[s];
+    if (p[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // Leftovers are 1 up to rounding error: always keep their own combo.
+}
+
+}  // namespace poker_sim
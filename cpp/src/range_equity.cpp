@@ -0,0 +1,201 @@
+#include "poker_sim/range_equity.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/parallel.hpp"
+#include "poker_sim/preflop_matrix.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace poker_sim {
+
+namespace {
+
+/// Per-side totals of opposing weight, overall and per card, for a set of
+/// holdings (those weaker than the sweep position, or one rank group).
+struct CardSums {
+  double total = 0;
+  std::array<double, 52> card{};
+  void add(uint8_t c1, uint8_t c2, double w) {
+    total += w;
+    card[c1] += w;
+    card[c2] += w;
+  }
+  /// Weight of the summed holdings sharing no card with (c1, c2); `self` is
+  /// the weight of (c1, c2) itself if it is in the set (subtracted twice).
+  double disjoint(uint8_t c1, uint8_t c2, double self) const { return total - card[c1] - card[c2] + self; }
+};
+
+/// Sums over a slice of runouts; slices are reduced after the parallel pass.
+struct Accum {
+  std::array<double, kNumCombos> num[2]{};  // weighted win + tie/2 per holding
+  std::array<double, kNumCombos> den[2]{};  // weighted opposing holdings met
+  double win[2] = {0, 0}, tie = 0;
+};
+
+struct Entry {
+  HandRank rank;
+  int combo;
+};
+
+class Solver {
+ public:
+  Solver(const HandRange& a, const HandRange& b, const std::vector<uint8_t>& board, std::uint64_t dead_mask)
+      : board_(board) {
+    const HandRange* r[2] = {&a, &b};
+    const std::uint64_t known = card_mask(board) | dead_mask;
+    for (int i = 0; i < kNumCombos; ++i) {
+      if (combo_mask(i) & known) continue;
+      w_[0][i] = r[0]->weights[i];
+      w_[1][i] = r[1]->weights[i];
+      if (w_[0][i] > 0 || w_[1][i] > 0) combos_.push_back(i);
+    }
+    for (int c = 0; c < 52; ++c)
+      if (!(known >> c & 1)) deck_.push_back(static_cast<uint8_t>(c));
+    const int need = 5 - static_cast<int>(board.size());
+    const int n = static_cast<int>(deck_.size());
+    if (need == 0) runouts_.push_back({-1, -1});
+    for (int i = 0; i < n && need >= 1; ++i) {
+      if (need == 1) runouts_.push_back({i, -1});
+      else
+        for (int j = i + 1; j < n; ++j) runouts_.push_back({i, j});
+    }
+  }
+
+  std::size_t num_runouts() const { return runouts_.size(); }
+
+  void score(std::size_t index, Accum& acc) const {
+    uint8_t cards[7];
+    std::copy(board_.begin(), board_.end(), cards);
+    std::uint64_t dealt = 0;
+    const auto ro = runouts_[index];
+    int len = static_cast<int>(board_.size());
+    for (int k : {ro.first, ro.second}) {
+      if (k < 0) continue;
+      cards[len++] = deck_[k];
+      dealt |= 1ull << deck_[k];
+    }
+
+    std::vector<Entry> hands;
+    hands.reserve(combos_.size());
+    for (int i : combos_) {
+      if (combo_mask(i) & dealt) continue;
+      const auto hc = combo_cards(i);
+      cards[5] = hc.first;
+      cards[6] = hc.second;
+      hands.push_back({evaluate_hand(cards, 7), i});
+    }
+    std::sort(hands.begin(), hands.end(), [](const Entry& x, const Entry& y) { return x.rank < y.rank; });
+
+    // Sweep rank groups upward. less[s] sums side s's holdings below the
+    // group, all[s] every live holding of side s; group[s] the group itself.
+    CardSums less[2], all[2];
+    for (const Entry& e : hands) {
+      const auto hc = combo_cards(e.combo);
+      for (int s = 0; s < 2; ++s)
+        if (w_[s][e.combo] > 0) all[s].add(hc.first, hc.second, w_[s][e.combo]);
+    }
+    for (std::size_t g = 0; g < hands.size();) {
+      std::size_t end = g;
+      CardSums group[2];
+      for (; end < hands.size() && hands[end].rank == hands[g].rank; ++end) {
+        const auto hc = combo_cards(hands[end].combo);
+        for (int s = 0; s < 2; ++s)
+          if (w_[s][hands[end].combo] > 0) group[s].add(hc.first, hc.second, w_[s][hands[end].combo]);
+      }
+      for (std::size_t k = g; k < end; ++k) {
+        const int c = hands[k].combo;
+        const auto hc = combo_cards(c);
+        for (int s = 0; s < 2; ++s) {
+          const double w = w_[s][c];
+          if (w <= 0) continue;
+          const int o = 1 - s;
+          const double self = w_[o][c];
+          const double beat = less[o].disjoint(hc.first, hc.second, 0);
+          const double tied = group[o].disjoint(hc.first, hc.second, self);
+          const double met = all[o].disjoint(hc.first, hc.second, self);
+          acc.num[s][c] += beat + tied / 2;
+          acc.den[s][c] += met;
+          acc.win[s] += w * beat;
+          if (s == 0) acc.tie += w * tied;
+        }
+      }
+      for (int s = 0; s < 2; ++s) {
+        less[s].total += group[s].total;
+        for (int c = 0; c < 52; ++c) less[s].card[c] += group[s].card[c];
+      }
+      g = end;
+    }
+  }
+
+  double weight(int side, int combo) const { return w_[side][combo]; }
+  const std::vector<int>& combos() const { return combos_; }
+
+ private:
+  std::vector<uint8_t> board_;
+  std::vector<uint8_t> deck_;
+  std::vector<std::pair<int, int>> runouts_;  // deck positions (-1 = unused)
+  std::vector<int> combos_;                   // live holdings in either range
+  std::array<double, kNumCombos> w_[2]{};
+};
+
+}  // namespace
+
+RangeEquity range_vs_range_equity(const HandRange& a,
+                                  const HandRange& b,
+                                  const std::vector<uint8_t>& board,
+                                  std::uint64_t dead_mask,
+                                  unsigned num_threads) {
+  if (board.empty()) {
+    if (dead_mask) throw std::invalid_argument("preflop range equity does not take dead cards");
+    const auto matrix = preflop_matrix();
+    if (!matrix) throw std::runtime_error("no preflop matrix loaded");
+    return preflop_range_equity(*matrix, a, b);
+  }
+  if (board.size() < 3 || board.size() > 5) throw std::invalid_argument("board must have 3, 4, or 5 cards");
+  std::uint64_t seen = 0;
+  for (uint8_t c : board) {
+    if (c > 51) throw std::invalid_argument("card index out of range 0-51");
+    if (seen >> c & 1) throw std::invalid_argument("board cards must be distinct");
+    seen |= 1ull << c;
+  }
+  if (dead_mask >> 52) throw std::invalid_argument("dead card index out of range 0-51");
+  if (dead_mask & seen) throw std::invalid_argument("dead cards must not overlap the board");
+  const Solver solver(a, b, board, dead_mask);
+
+  // A few slices per thread keep the load balanced without one accumulator per runout.
+  if (num_threads == 0) num_threads = default_thread_count();
+  const std::size_t slices = std::min<std::size_t>(solver.num_runouts(), 4 * num_threads);
+  std::vector<Accum> acc(slices);
+  parallel_for(slices, num_threads, [&](std::size_t s) {
+    for (std::size_t i = s; i < solver.num_runouts(); i += slices) solver.score(i, acc[s]);
+  });
+
+  RangeEquity result;
+  result.runouts = solver.num_runouts();
+  Accum total;
+  for (const Accum& x : acc) {
+    for (int s = 0; s < 2; ++s) {
+      for (int c : solver.combos()) {
+        total.num[s][c] += x.num[s][c];
+        total.den[s][c] += x.den[s][c];
+      }
+      total.win[s] += x.win[s];
+    }
+    total.tie += x.tie;
+  }
+  for (int c : solver.combos()) result.matchups += solver.weight(0, c) * total.den[0][c];
+  if (result.matchups <= 0) throw std::invalid_argument("ranges have no holdings that can meet on this board");
+  for (int s = 0; s < 2; ++s) {
+    result.win[s] = total.win[s] / result.matchups;
+    for (int c : solver.combos()) {
+      if (solver.weight(s, c) <= 0 || total.den[s][c] <= 0) continue;
+      result.combos[s].push_back({c, total.num[s][c] / total.den[s][c], solver.weight(s, c) * total.den[s][c]});
+    }
+  }
+  result.tie = total.tie / result.matchups;
+  for (int s = 0; s < 2; ++s) result.equity[s] = result.win[s] + result.tie / 2;
+  return result;
+}
+
+}  // namespace poker_sim
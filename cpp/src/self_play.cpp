@@ -0,0 +1,351 @@
+#include "poker_sim/self_play.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace poker_sim {
+
+int TableState::in_hand() const {
+  int n = 0;
+  for (int i = 0; i < seats; ++i) n += !folded[i];
+  return n;
+}
+
+namespace {
+
+/// Hands are dealt round-robin to this many chunks, each with its own stream.
+constexpr std::uint32_t kChunks = 64;
+
+/// Smallest stack treated as chips left; below it a seat is all in.
+constexpr double kChipEpsilon = 1e-9;
+
+// ---------------------------------------------------------------------------
+// Built-in bots
+// ---------------------------------------------------------------------------
+
+/// Chen formula score of a starting hand (-1 to 20).
+double chen_score(uint8_t a, uint8_t b) {
+  static const double kHigh[13] = {1, 1.5, 2, 2.5, 3, 3.5, 4, 4.5, 5, 6, 7, 8, 10};
+  int hi = card_rank(a), lo = card_rank(b);
+  if (hi < lo) std::swap(hi, lo);
+  double score = kHigh[hi];
+  if (hi == lo) return std::max(5.0, 2 * score);
+  if (card_suit(a) == card_suit(b)) score += 2;
+  const int gap = hi - lo - 1;
+  score -= gap == 0 ? 0 : gap == 1 ? 1 : gap == 2 ? 2 : gap == 3 ? 4 : 5;
+  if (gap <= 1 && hi < 10) score += 1;  // connected, both below a queen
+  return std::ceil(score);
+}
+
+/// Postflop hand class: 0 nothing, 1 weak pair or flush draw, 2 top pair or
+/// overpair, 3 two pair or trips using a hole card, 4 straight or better.
+int made_hand(const TableState& s, int seat) {
+  const uint8_t* h = s.hole[seat];
+  HandState state;
+  int top = 0, suits[4] = {};
+  std::uint32_t board_ranks = 0;
+  for (int k = 0; k < s.board_cards; ++k) {
+    state.add(s.board[k]);
+    top = std::max(top, card_rank(s.board[k]));
+    board_ranks |= 1u << card_rank(s.board[k]);
+    ++suits[card_suit(s.board[k])];
+  }
+  state.add(h[0]);
+  state.add(h[1]);
+  const int category = hand_category(state.rank());
+  const bool pocket = card_rank(h[0]) == card_rank(h[1]);
+  const bool hit0 = board_ranks >> card_rank(h[0]) & 1, hit1 = board_ranks >> card_rank(h[1]) & 1;
+  if (category >= STRAIGHT) return 4;
+  if (category >= TWO_PAIR) return pocket || hit0 || hit1 ? 3 : 1;
+  if (category == ONE_PAIR) {
+    if (pocket) return card_rank(h[0]) > top ? 2 : 1;
+    if (hit0 || hit1) return (hit0 && card_rank(h[0]) == top) || (hit1 && card_rank(h[1]) == top) ? 2 : 1;
+    return 0;
+  }
+  ++suits[card_suit(h[0])];
+  ++suits[card_suit(h[1])];
+  return s.street < 3 && (suits[card_suit(h[0])] == 4 || suits[card_suit(h[1])] == 4) ? 1 : 0;
+}
+
+/// Total bet after raising fraction of the pot (after calling).
+double pot_raise(const TableState& s, double fraction) {
+  return s.current_bet + fraction * (s.pot + s.to_call());
+}
+
+BotAction check_call() { return {BotAction::CALL, 0}; }
+BotAction fold() { return {BotAction::FOLD, 0}; }
+BotAction raise_to(double amount) { return {BotAction::RAISE, amount}; }
+
+BotAction station(const TableState&, std::mt19937&) { return check_call(); }
+
+BotAction maniac(const TableState& s, std::mt19937&) { return raise_to(pot_raise(s, 1.0)); }
+
+BotAction random_bot(const TableState& s, std::mt19937& rng) {
+  const std::uint32_t u = static_cast<std::uint32_t>((static_cast<std::uint64_t>(rng()) * 6) >> 32);
+  if (s.to_call() > 0 && u < 2) return fold();
+  if (u < 4) return check_call();
+  return raise_to(pot_raise(s, u == 4 ? 0.5 : 1.0));
+}
+
+/// Thresholds of a fit-or-fold style: Chen scores to open, call a raise and
+/// reraise preflop; made_hand classes to bet and to call; how often it bets
+/// with nothing, and its postflop bet size (fraction of the pot).
+struct Style {
+  double open, call, reraise;
+  int bet, call_made;
+  double bluff, size;
+};
+
+constexpr Style kRock = {10, 10, 12, 3, 2, 0.0, 0.5};
+constexpr Style kTag = {7, 8, 10, 2, 1, 0.15, 0.66};
+constexpr Style kLag = {5, 6, 9, 1, 1, 0.35, 0.75};
+
+template <const Style& S>
+BotAction styled(const TableState& s, std::mt19937& rng) {
+  const uint8_t* h = s.hole[s.actor];
+  const double owe = s.to_call();
+  if (s.street == 0) {
+    const double score = chen_score(h[0], h[1]);
+    if (s.raises == 0) {
+      if (score >= S.open) return raise_to(3 * s.current_bet);
+      return owe > 0 ? fold() : check_call();
+    }
+    if (score >= S.reraise) return raise_to(3 * s.current_bet);
+    return score >= S.call ? check_call() : fold();
+  }
+  const int made = made_hand(s, s.actor);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  if (owe == 0) {
+    if (made >= S.bet || unit(rng) < S.bluff) return raise_to(pot_raise(s, S.size));
+    return check_call();
+  }
+  if (made > S.bet && made >= 3) return raise_to(pot_raise(s, 1.0));
+  if (made >= 3 || (made >= S.call_made && owe <= s.pot / 2)) return check_call();
+  return fold();
+}
+
+// ---------------------------------------------------------------------------
+// Table
+// ---------------------------------------------------------------------------
+
+/// Moves up to amount from a seat's stack into the pot.
+void put_in(TableState& s, int seat, double amount) {
+  amount = std::min(amount, s.stack[seat]);
+  s.stack[seat] -= amount;
+  if (s.stack[seat] < kChipEpsilon) s.stack[seat] = 0;
+  s.bet[seat] += amount;
+  s.invested[seat] += amount;
+  s.pot += amount;
+}
+
+/// Whether a seat other than seat is still in the hand with chips behind.
+bool others_can_act(const TableState& s, int seat) {
+  for (int j = 0; j < s.seats; ++j)
+    if (j != seat && !s.folded[j] && s.stack[j] > 0) return true;
+  return false;
+}
+
+void apply(TableState& s, int seat, BotAction a) {
+  const double owe = s.current_bet - s.bet[seat];
+  s.acted[seat] = true;
+  if (a.kind == BotAction::FOLD && owe > 0) {
+    s.folded[seat] = true;
+    return;
+  }
+  if (a.kind == BotAction::RAISE && s.can_raise[seat] && s.stack[seat] > owe && others_can_act(s, seat)) {
+    const double to = std::min(std::max(a.amount, s.current_bet + s.min_raise), s.bet[seat] + s.stack[seat]);
+    const double increase = to - s.current_bet;
+    put_in(s, seat, to - s.bet[seat]);
+    const bool full = increase >= s.min_raise - kChipEpsilon;
+    for (int j = 0; j < s.seats; ++j) {
+      if (j == seat) continue;
+      // A full raise reopens the betting; an incomplete all-in only has to be called.
+      if (full) s.can_raise[j] = true;
+      else if (s.acted[j]) s.can_raise[j] = false;
+      s.acted[j] = false;
+    }
+    if (full) s.min_raise = increase;
+    s.current_bet = std::max(s.current_bet, s.bet[seat]);
+    ++s.raises;
+    return;
+  }
+  put_in(s, seat, owe);
+}
+
+void betting_round(const SelfPlayConfig& c, TableState& s, int first, std::mt19937& rng) {
+  const int n = s.seats;
+  int idle = 0;  // seats in a row with nothing to do
+  for (int i = first; idle < n && s.in_hand() > 1; i = (i + 1) % n) {
+    if (s.folded[i] || s.stack[i] == 0 || (s.acted[i] && s.bet[i] >= s.current_bet) ||
+        (s.bet[i] >= s.current_bet && !others_can_act(s, i))) {
+      ++idle;
+      continue;
+    }
+    idle = 0;
+    s.actor = i;
+    apply(s, i, c.bots[i](s, rng));
+  }
+}
+
+/// Splits the pot into side pots by investment and awards each to the best
+/// eligible hands, evenly among ties, adding the amounts to won.
+void showdown(TableState& s, double* won) {
+  HandRank rank[kMaxTableSeats] = {};
+  uint8_t cards[7];
+  std::copy(s.board, s.board + 5, cards);
+  for (int i = 0; i < s.seats; ++i) {
+    if (s.folded[i]) continue;
+    cards[5] = s.hole[i][0];
+    cards[6] = s.hole[i][1];
+    rank[i] = evaluate_hand(cards, 7);
+  }
+  double prev = 0, paid = 0;
+  int last[kMaxTableSeats], num_last = 0;
+  for (;;) {
+    double level = -1;
+    for (int i = 0; i < s.seats; ++i)
+      if (!s.folded[i] && s.invested[i] > prev && (level < 0 || s.invested[i] < level)) level = s.invested[i];
+    if (level < 0) break;
+    double slice = 0;
+    for (int i = 0; i < s.seats; ++i) slice += std::min(s.invested[i], level) - std::min(s.invested[i], prev);
+    HandRank best = 0;
+    for (int i = 0; i < s.seats; ++i)
+      if (!s.folded[i] && s.invested[i] >= level) best = std::max(best, rank[i]);
+    num_last = 0;
+    for (int i = 0; i < s.seats; ++i)
+      if (!s.folded[i] && s.invested[i] >= level && rank[i] == best) last[num_last++] = i;
+    for (int k = 0; k < num_last; ++k) won[last[k]] += slice / num_last;
+    paid += slice;
+    prev = level;
+  }
+  // Folded money above every live seat's investment goes to the last pot's winners.
+  for (int k = 0; k < num_last; ++k) won[last[k]] += (s.pot - paid) / num_last;
+}
+
+double start_stack(const SelfPlayConfig& c, int seat) { return c.stacks.empty() ? c.stack : c.stacks[seat]; }
+
+void validate(const SelfPlayConfig& c) {
+  const int n = static_cast<int>(c.bots.size());
+  if (n < 2 || n > kMaxTableSeats) throw std::invalid_argument("self-play needs 2-9 bots");
+  for (BotPolicy bot : c.bots)
+    if (!bot) throw std::invalid_argument("bot policy must not be null");
+  if (!(c.small_blind > 0 && c.small_blind <= 1)) throw std::invalid_argument("small blind must be in (0, 1] big blinds");
+  if (!c.stacks.empty() && static_cast<int>(c.stacks.size()) != n)
+    throw std::invalid_argument("stacks must give one stack per bot");
+  for (int i = 0; i < n; ++i)
+    if (!(start_stack(c, i) >= 1)) throw std::invalid_argument("stacks must be at least one big blind");
+  if (c.num_hands == 0) throw std::invalid_argument("num_hands must be positive");
+}
+
+}  // namespace
+
+BotPolicy bot_policy(const std::string& name) {
+  if (name == "station") return station;
+  if (name == "maniac") return maniac;
+  if (name == "random") return random_bot;
+  if (name == "rock") return styled<kRock>;
+  if (name == "tag") return styled<kTag>;
+  if (name == "lag") return styled<kLag>;
+  throw std::invalid_argument("unknown bot '" + name + "' (station, maniac, random, rock, tag, lag)");
+}
+
+void play_hand(const SelfPlayConfig& c, int button, TableState& s, std::mt19937& rng, double* net) {
+  const int n = static_cast<int>(c.bots.size());
+  s.seats = n;
+  s.button = button;
+  s.pot = 0;
+  for (int i = 0; i < n; ++i) {
+    s.stack[i] = start_stack(c, i);
+    s.bet[i] = s.invested[i] = 0;
+    s.folded[i] = false;
+  }
+  // Partial Fisher-Yates: only the cards dealt are drawn.
+  for (int k = 0; k < 52; ++k) s.deck[k] = static_cast<uint8_t>(k);
+  int left = 52;
+  auto draw = [&]() {
+    const int k = static_cast<int>((static_cast<std::uint64_t>(rng()) * static_cast<std::uint32_t>(left)) >> 32);
+    const uint8_t card = s.deck[k];
+    s.deck[k] = s.deck[--left];
+    return card;
+  };
+  for (int i = 0; i < n; ++i) {
+    s.hole[i][0] = draw();
+    s.hole[i][1] = draw();
+  }
+  for (int k = 0; k < 5; ++k) s.board[k] = draw();
+
+  const int sb = n == 2 ? button : (button + 1) % n, bb = (sb + 1) % n;
+  put_in(s, sb, c.small_blind);
+  put_in(s, bb, 1.0);
+  double won[kMaxTableSeats] = {};
+  for (int street = 0; street < 4; ++street) {
+    s.street = street;
+    s.board_cards = street == 0 ? 0 : street + 2;
+    s.raises = 0;
+    s.min_raise = 1;
+    if (street == 0) {
+      s.current_bet = std::max(s.bet[sb], s.bet[bb]);
+    } else {
+      s.current_bet = 0;
+      for (int i = 0; i < n; ++i) s.bet[i] = 0;
+    }
+    for (int i = 0; i < n; ++i) {
+      s.acted[i] = false;
+      s.can_raise[i] = true;
+    }
+    betting_round(c, s, street == 0 ? (bb + 1) % n : (button + 1) % n, rng);
+    if (s.in_hand() == 1) {
+      for (int i = 0; i < n; ++i)
+        if (!s.folded[i]) won[i] = s.pot;
+      break;
+    }
+    if (street == 3) showdown(s, won);
+  }
+  s.board_cards = 5;
+  for (int i = 0; i < n; ++i) net[i] += s.stack[i] + won[i] - start_stack(c, i);
+}
+
+SelfPlayResult self_play(const SelfPlayConfig& c) {
+  validate(c);
+  const int n = static_cast<int>(c.bots.size());
+  struct Totals {
+    double sum[kMaxTableSeats] = {};
+    double squares[kMaxTableSeats] = {};
+  };
+  std::vector<Totals> parts(kChunks);
+  parallel_for(kChunks, c.num_threads, [&](std::size_t chunk) {
+    std::mt19937 rng((c.seed != 0 ? c.seed : 12345u) + static_cast<unsigned>(chunk) * 0x9E3779B9u);
+    TableState state;
+    Totals& t = parts[chunk];
+    for (std::uint64_t hand = chunk; hand < c.num_hands; hand += kChunks) {
+      double net[kMaxTableSeats] = {};
+      play_hand(c, static_cast<int>(hand % n), state, rng, net);
+      for (int i = 0; i < n; ++i) {
+        t.sum[i] += net[i];
+        t.squares[i] += net[i] * net[i];
+      }
+    }
+  });
+
+  SelfPlayResult out;
+  out.hands = c.num_hands;
+  const double hands = static_cast<double>(c.num_hands);
+  for (int i = 0; i < n; ++i) {
+    double sum = 0, squares = 0;
+    for (const Totals& t : parts) {
+      sum += t.sum[i];
+      squares += t.squares[i];
+    }
+    const double mean = sum / hands, variance = std::max(0.0, squares / hands - mean * mean);
+    BotResult r;
+    r.won = sum;
+    r.bb_per_100 = 100 * mean;
+    r.ci95 = 100 * 1.96 * std::sqrt(variance / hands);
+    out.seats.push_back(r);
+  }
+  return out;
+}
+
+}  // namespace poker_sim
@@ -1,57 +1,603 @@
 #include "poker_sim/simulation.hpp"
+#include "poker_sim/flop_equity.hpp"
 #include "poker_sim/hand_eval.hpp"
+#include "poker_sim/parallel.hpp"
+#include "poker_sim/preflop_matrix.hpp"
+#include "poker_sim/qmc.hpp"
 #include <algorithm>
+#include <cmath>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace poker_sim {
 
+namespace {
+
+/// Running sums of per-trial equity shares (1 win, 0.5 tie, 0 loss).
+struct ShareStats {
+  double sum = 0, sum_sq = 0;
+  std::uint32_t n = 0;
+  void add(double x) { sum += x; sum_sq += x * x; ++n; }
+  double mean() const { return n ? sum / n : 0; }
+  double variance() const { return n > 1 ? std::max(0.0, (sum_sq - sum * sum / n) / (n - 1)) : 0; }
+};
+
+/// One spot: known cards plus the live deck sorted by rank, so that mirrored or
+/// stratified positions map to systematically higher/lower cards.
+class Dealer {
+ public:
+  Dealer(const std::vector<uint8_t>& hole_cards, const std::vector<uint8_t>& board, int num_opponents,
+         std::uint64_t dead_mask)
+      : num_opponents_(num_opponents), board_len_(static_cast<int>(board.size())) {
+    // Dead cards never enter the live deck, so removing them costs nothing per trial.
+    const std::uint64_t known = card_mask(hole_cards) | card_mask(board) | dead_mask;
+    for (int r = 0; r < 13; ++r)
+      for (int s = 0; s < 4; ++s) {
+        int c = s * 13 + r;
+        if (!(known >> c & 1)) deck_.push_back(static_cast<uint8_t>(c));
+      }
+    std::copy(board.begin(), board.end(), cards_);
+    cards_[5] = hole_cards[0];
+    cards_[6] = hole_cards[1];
+    need_ = 5 - board_len_ + 2 * num_opponents;
+  }
+
+  int deck_size() const { return static_cast<int>(deck_.size()); }
+  /// Cards dealt per trial: the rest of the board, then two per opponent.
+  int cards_needed() const { return need_; }
+
+  /// Deals by partial Fisher-Yates over a fresh copy of the sorted deck, where
+  /// pick(k, m) returns the offset in [0, m) of the k-th card among the m left.
+  /// Returns the showdown outcome (see showdown()).
+  template <typename Pick>
+  int play(Pick&& pick) const {
+    uint8_t buf[52];
+    const int size = deck_size();
+    std::copy(deck_.begin(), deck_.end(), buf);
+    for (int k = 0; k < need_; ++k) std::swap(buf[k], buf[k + pick(k, size - k)]);
+    return showdown(buf);
+  }
+
+ private:
+  /// 0 if the hero loses, 1 on an outright win, k if the pot splits k ways.
+  int showdown(const uint8_t* dealt) const {
+    uint8_t cards[7];
+    std::copy(cards_, cards_ + 7, cards);
+    int idx = 0;
+    for (int i = board_len_; i < 5; ++i) cards[i] = dealt[idx++];
+    HandRank hero = evaluate_hand(cards, 7);
+    int split = 1;
+    for (int o = 0; o < num_opponents_; ++o) {
+      cards[5] = dealt[idx++];
+      cards[6] = dealt[idx++];
+      HandRank opp = evaluate_hand(cards, 7);
+      if (opp > hero) return 0;
+      split += opp == hero;
+    }
+    return split;
+  }
+
+  int num_opponents_;
+  int board_len_;
+  int need_ = 0;
+  uint8_t cards_[7] = {};
+  std::vector<uint8_t> deck_;
+};
+
+/// Hero's pot share for a showdown outcome (0 = loss, 1 = win, k = k-way split).
+inline double share(int outcome) { return outcome > 0 ? 1.0 / outcome : 0.0; }
+
+void tally(SimResult& r, int outcome) {
+  if (outcome == 0) {
+    ++r.losses;
+    return;
+  }
+  r.pot_share += kPotShareUnit / outcome;
+  if (outcome == 1) {
+    ++r.wins;
+  } else {
+    ++r.ties;
+    ++r.split_ways[outcome];
+  }
+}
+
+/// num_trials deals split in the proportions of a precomputed outcome. Counts
+/// round the running totals, so they add up to at most num_trials.
+SimResult from_table(const FlopOutcome& outcome, std::uint32_t num_trials) {
+  SimResult r;
+  r.total = static_cast<int>(num_trials);
+  double cumulative = 0;
+  int dealt = 0;
+  for (int j = 0; j <= outcome.opponents; ++j) {
+    cumulative += outcome.ways[j];
+    const int upto = static_cast<int>(std::lround(std::min(1.0, cumulative) * num_trials));
+    const int count = upto - dealt;
+    dealt = upto;
+    if (j == 0) {
+      r.wins = count;
+    } else {
+      r.ties += count;
+      r.split_ways[j + 1] = count;
+    }
+  }
+  r.losses = r.total - dealt;
+  r.pot_share = static_cast<std::uint64_t>(std::llround(outcome.equity() * kPotShareUnit * num_trials));
+  r.effective_samples = outcome.deals;
+  r.exact = true;
+  return r;
+}
+
+/// ESS = n * (per-trial variance) / (n * variance of the estimator).
+double effective_samples(std::uint32_t n, double trial_var, double estimator_var) {
+  if (estimator_var <= 0 || trial_var <= 0) return n;
+  return trial_var / estimator_var;
+}
+
+void validate(const std::vector<uint8_t>& hole_cards, const std::vector<uint8_t>& board, int num_opponents,
+              std::uint64_t dead_mask) {
+  if (hole_cards.size() != 2) throw std::invalid_argument("hole_cards must have exactly 2 cards");
+  if (board.size() != 0 && board.size() != 3 && board.size() != 4 && board.size() != 5)
+    throw std::invalid_argument("board must have 0, 3, 4, or 5 cards");
+  if (num_opponents < 1 || num_opponents > 8) throw std::invalid_argument("num_opponents must be 1-8");
+  std::uint64_t seen = 0;
+  for (const auto* v : {&hole_cards, &board})
+    for (uint8_t c : *v) {
+      if (c > 51) throw std::invalid_argument("card index out of range 0-51");
+      if (seen >> c & 1) throw std::invalid_argument("hole_cards and board must not overlap");
+      seen |= 1ull << c;
+    }
+  if (dead_mask >> 52) throw std::invalid_argument("dead card index out of range 0-51");
+  if (dead_mask & seen) throw std::invalid_argument("dead cards must not overlap hole_cards or board");
+}
+
+/// Pot shares of one runout between known hands; cards[0..4] is the board.
+struct MultiwayTally {
+  std::vector<double> share, win, tie;
+  explicit MultiwayTally(std::size_t n) : share(n), win(n), tie(n) {}
+
+  void add(uint8_t* cards, const std::vector<std::vector<uint8_t>>& hands) {
+    HandRank ranks[9] = {};
+    HandRank best = 0;
+    const std::size_t n = hands.size();
+    for (std::size_t p = 0; p < n; ++p) {
+      cards[5] = hands[p][0];
+      cards[6] = hands[p][1];
+      ranks[p] = evaluate_hand(cards, 7);
+      best = std::max(best, ranks[p]);
+    }
+    int k = 0;
+    for (std::size_t p = 0; p < n; ++p) k += ranks[p] == best;
+    for (std::size_t p = 0; p < n; ++p) {
+      if (ranks[p] != best) continue;
+      share[p] += 1.0 / k;
+      (k == 1 ? win : tie)[p] += 1;
+    }
+  }
+
+  void merge(const MultiwayTally& o) {
+    for (std::size_t p = 0; p < share.size(); ++p) {
+      share[p] += o.share[p];
+      win[p] += o.win[p];
+      tie[p] += o.tie[p];
+    }
+  }
+};
+
+}  // namespace
+
+SamplerMode sampler_from_name(const std::string& name) {
+  if (name == "iid") return SamplerMode::IID;
+  if (name == "stratified") return SamplerMode::STRATIFIED;
+  if (name == "antithetic") return SamplerMode::ANTITHETIC;
+  if (name == "lhs") return SamplerMode::LATIN_HYPERCUBE;
+  if (name == "sobol") return SamplerMode::SOBOL;
+  if (name == "sobol_scrambled") return SamplerMode::SOBOL_SCRAMBLED;
+  throw std::invalid_argument("unknown sampler: " + name);
+}
+
+const char* sampler_name(SamplerMode mode) {
+  switch (mode) {
+    case SamplerMode::STRATIFIED: return "stratified";
+    case SamplerMode::ANTITHETIC: return "antithetic";
+    case SamplerMode::LATIN_HYPERCUBE: return "lhs";
+    case SamplerMode::SOBOL: return "sobol";
+    case SamplerMode::SOBOL_SCRAMBLED: return "sobol_scrambled";
+    default: return "iid";
+  }
+}
+
 SimResult run_monte_carlo(const std::vector<uint8_t>& hole_cards,
                           const std::vector<uint8_t>& board,
                           int num_opponents,
                           std::uint32_t num_trials,
-                          unsigned seed) {
+                          unsigned seed,
+                          SamplerMode sampler,
+                          std::uint64_t dead_mask) {
+  validate(hole_cards, board, num_opponents, dead_mask);
+  if (board.size() == 3 && dead_mask == 0 && num_opponents <= kFlopEquityMaxOpponents) {
+    if (const auto table = flop_equity_table())
+      return from_table(table->lookup(hole_cards, board, num_opponents), num_trials);
+  }
+  if (board.empty() && dead_mask == 0 && num_opponents == 1) {
+    if (const auto matrix = preflop_matrix()) {
+      const int cls = preflop_class(hole_cards[0], hole_cards[1]);
+      const PreflopMatchup m = matrix->versus_random(cls);
+      FlopOutcome outcome;
+      outcome.opponents = 1;
+      outcome.ways = {m.win, m.tie};
+      outcome.deals = m.matchups / preflop_class_combos(cls) * kPreflopBoards;
+      return from_table(outcome, num_trials);
+    }
+  }
+  const Dealer dealer(hole_cards, board, num_opponents, dead_mask);
+  if (dealer.cards_needed() > dealer.deck_size())
+    throw std::invalid_argument("not enough cards in deck for this configuration");
+
   SimResult result;
   result.total = static_cast<int>(num_trials);
 
   std::mt19937 rng(seed != 0 ? seed : 12345u);
+  auto uniform_pick = [&rng](int, int m) { return std::uniform_int_distribution<int>(0, m - 1)(rng); };
+  ShareStats all;
 
-  for (std::uint32_t t = 0; t < num_trials; ++t) {
-    std::vector<uint8_t> used(hole_cards.begin(), hole_cards.end());
-    used.insert(used.end(), board.begin(), board.end());
-    std::vector<uint8_t> deck;
-    for (int c = 0; c < 52; ++c) {
-      if (std::find(used.begin(), used.end(), static_cast<uint8_t>(c)) == used.end())
-        deck.push_back(static_cast<uint8_t>(c));
+  switch (sampler) {
+    case SamplerMode::IID: {
+      for (std::uint32_t t = 0; t < num_trials; ++t) {
+        tally(result, dealer.play(uniform_pick));
+      }
+      result.effective_samples = num_trials;
+      break;
     }
-    std::shuffle(deck.begin(), deck.end(), rng);
 
-    std::vector<uint8_t> board_final(board.begin(), board.end());
-    size_t idx = 0;
-    while (board_final.size() < 5)
-      board_final.push_back(deck[idx++]);
+    case SamplerMode::STRATIFIED: {
+      // Strata are the board runouts when at most two board cards are missing
+      // (flop: turn+river pair, turn: river card), otherwise the first dealt
+      // card. Every stratum gets floor(n / H) trials; the remainder goes to
+      // distinct strata chosen at random, which keeps the pooled mean unbiased.
+      const int d = dealer.deck_size();
+      const int missing = 5 - static_cast<int>(board.size());
+      std::vector<std::pair<int, int>> strata;  // sorted-deck positions (second = -1 if unused)
+      if (missing == 2) {
+        for (int i = 0; i < d; ++i)
+          for (int j = i + 1; j < d; ++j) strata.push_back({i, j});
+      } else {
+        for (int i = 0; i < d; ++i) strata.push_back({i, -1});
+      }
+      const std::uint32_t h_count = static_cast<std::uint32_t>(strata.size());
+      std::vector<ShareStats> per(h_count);
+      std::vector<std::uint32_t> order(h_count);
+      for (std::uint32_t h = 0; h < h_count; ++h) order[h] = h;
+      std::shuffle(order.begin(), order.end(), rng);
+      for (std::uint32_t t = 0; t < num_trials; ++t) {
+        const std::uint32_t h = order[t % h_count];
+        const auto st = strata[h];
+        // Swapping position 0 with i leaves j (> i >= 0) in place, so the
+        // second card sits at offset j - 1 among the remaining m.
+        int outcome = dealer.play([&](int k, int m) {
+          if (k == 0) return st.first;
+          if (k == 1 && st.second >= 0) return st.second - 1;
+          return uniform_pick(k, m);
+        });
+        tally(result, outcome);
+        all.add(share(outcome));
+        per[h].add(share(outcome));
+      }
+      // Proportional allocation: Var = pooled within-stratum variance / n.
+      double within = 0;
+      std::uint32_t dof = 0;
+      for (const auto& s : per) {
+        if (s.n > 1) {
+          within += s.variance() * (s.n - 1);
+          dof += s.n - 1;
+        }
+      }
+      result.effective_samples = dof > 0 ? effective_samples(num_trials, all.variance(), within / dof / num_trials)
+                                         : num_trials;
+      break;
+    }
 
-    std::vector<std::vector<uint8_t>> opp_hands;
-    for (int o = 0; o < num_opponents; ++o) {
-      opp_hands.push_back({deck[idx], deck[idx + 1]});
-      idx += 2;
+    case SamplerMode::ANTITHETIC: {
+      // The partner deal takes the mirrored offset m-1-j at every draw, so a
+      // low card in one deal is a high card in the other.
+      ShareStats pairs;
+      std::vector<int> picks(dealer.cards_needed());
+      std::uint32_t t = 0;
+      for (; t + 1 < num_trials; t += 2) {
+        int a = dealer.play([&](int k, int m) { return picks[k] = uniform_pick(k, m); });
+        int b = dealer.play([&](int k, int m) { return m - 1 - picks[k]; });
+        tally(result, a);
+        tally(result, b);
+        all.add(share(a));
+        all.add(share(b));
+        pairs.add((share(a) + share(b)) / 2);
+      }
+      if (t < num_trials) {
+        int outcome = dealer.play(uniform_pick);
+        tally(result, outcome);
+        all.add(share(outcome));
+      }
+      result.effective_samples = pairs.n > 1
+          ? effective_samples(num_trials, all.variance(), pairs.variance() / pairs.n)
+          : num_trials;
+      break;
     }
 
-    std::vector<uint8_t> hero_hand(hole_cards.begin(), hole_cards.end());
-    hero_hand.insert(hero_hand.end(), board_final.begin(), board_final.end());
+    case SamplerMode::LATIN_HYPERCUBE: {
+      // Each block of B trials is a Latin hypercube over the per-card uniforms:
+      // along every draw k, each of the B equal slices of [0,1) is hit once.
+      // The spread of block means gives the variance estimate.
+      const int dims = dealer.cards_needed();
+      const std::uint32_t block = std::min<std::uint32_t>(4096, std::max<std::uint32_t>(64, num_trials / 16));
+      std::uniform_real_distribution<double> unit(0.0, 1.0);
+      std::vector<std::uint32_t> perm(static_cast<std::size_t>(dims) * block);
+      ShareStats blocks;
+      for (std::uint32_t start = 0; start < num_trials; start += block) {
+        const std::uint32_t b = std::min(block, num_trials - start);
+        for (int k = 0; k < dims; ++k) {
+          std::uint32_t* p = &perm[static_cast<std::size_t>(k) * block];
+          for (std::uint32_t i = 0; i < b; ++i) p[i] = i;
+          std::shuffle(p, p + b, rng);
+        }
+        ShareStats cur;
+        for (std::uint32_t i = 0; i < b; ++i) {
+          int outcome = dealer.play([&](int k, int m) {
+            double u = (perm[static_cast<std::size_t>(k) * block + i] + unit(rng)) / b;
+            return std::min(m - 1, static_cast<int>(u * m));
+          });
+          tally(result, outcome);
+          all.add(share(outcome));
+          cur.add(share(outcome));
+        }
+        if (b == block) blocks.add(cur.mean());
+      }
+      // Var(mean of n trials) ~= Var(block mean) * B / n.
+      result.effective_samples = blocks.n > 1
+          ? effective_samples(num_trials, all.variance(), blocks.variance() * block / num_trials)
+          : num_trials;
+      break;
+    }
 
-    int hero_value = 1;  // win unless we lose or tie
-    for (const auto& opp : opp_hands) {
-      std::vector<uint8_t> opp_hand = opp;
-      opp_hand.insert(opp_hand.end(), board_final.begin(), board_final.end());
-      int cmp = compare_hands(hero_hand, opp_hand);
-      if (cmp < 0) { hero_value = -1; break; }  // loss
-      if (cmp == 0) hero_value = 0;  // at least one tie
+    case SamplerMode::SOBOL:
+    case SamplerMode::SOBOL_SCRAMBLED: {
+      // Coordinate k of each point picks the k-th card: offset floor(u_k * m).
+      // Scrambled runs split the trials over independent digitally shifted
+      // replicates; the spread of replicate means gives the error estimate.
+      const int dims = dealer.cards_needed();
+      const bool scrambled = sampler == SamplerMode::SOBOL_SCRAMBLED;
+      const std::uint32_t reps = !scrambled ? 1 : num_trials >= 64 ? 8 : num_trials >= 2 ? 2 : 1;
+      std::uint32_t point[SobolSequence::kMaxDims];
+      ShareStats replicates;
+      for (std::uint32_t r = 0; r < reps; ++r) {
+        std::vector<std::uint32_t> shift;
+        if (scrambled)
+          for (int k = 0; k < dims; ++k) shift.push_back(static_cast<std::uint32_t>(rng()));
+        SobolSequence seq(dims, std::move(shift));
+        const std::uint32_t n = num_trials / reps + (r < num_trials % reps ? 1 : 0);
+        ShareStats cur;
+        for (std::uint32_t i = 0; i < n; ++i) {
+          seq.next(point);
+          int outcome = dealer.play([&](int k, int m) {
+            return static_cast<int>((static_cast<std::uint64_t>(point[k]) * m) >> 32);
+          });
+          tally(result, outcome);
+          all.add(share(outcome));
+          cur.add(share(outcome));
+        }
+        replicates.add(cur.mean());
+      }
+      // Var(mean) ~= Var(replicate mean) / reps.
+      result.effective_samples = replicates.n > 1
+          ? effective_samples(num_trials, all.variance(), replicates.variance() / replicates.n)
+          : num_trials;
+      break;
     }
+  }
+  return result;
+}
+
+SimResult run_monte_carlo_ranges(const std::vector<uint8_t>& hole_cards,
+                                 const std::vector<uint8_t>& board,
+                                 const std::vector<HandRange>& opponent_ranges,
+                                 std::uint32_t num_trials,
+                                 unsigned seed,
+                                 std::uint64_t dead_mask) {
+  const int num_opponents = static_cast<int>(opponent_ranges.size());
+  validate(hole_cards, board, num_opponents, dead_mask);
+  const std::uint64_t known = card_mask(hole_cards) | card_mask(board) | dead_mask;
+
+  // Opponents whose range is uniform over every live holding are dealt
+  // straight from the deck: given the other hands, a uniform pair of the
+  // remaining cards is exactly their conditional distribution.
+  std::vector<AliasTable> tables;
+  std::vector<int> weighted, uniform;
+  for (int o = 0; o < num_opponents; ++o) {
+    const auto& w = opponent_ranges[o].weights;
+    double first = -1;
+    bool flat = true;
+    for (int i = 0; i < kNumCombos && flat; ++i) {
+      if (combo_mask(i) & known) continue;
+      if (first < 0) first = w[i];
+      flat = w[i] > 0 && w[i] == first;
+    }
+    if (flat) {
+      uniform.push_back(o);
+      continue;
+    }
+    tables.emplace_back(opponent_ranges[o], known);
+    weighted.push_back(o);
+    if (tables.back().empty())
+      throw std::invalid_argument("opponent range " + std::to_string(o + 1) + " has no combos left after card removal");
+  }
+  std::vector<uint8_t> deck;
+  for (int c = 0; c < 52; ++c)
+    if (!(known >> c & 1)) deck.push_back(static_cast<uint8_t>(c));
+  const int board_len = static_cast<int>(board.size());
+  const int deck_size = static_cast<int>(deck.size());
+  const int num_weighted = static_cast<int>(weighted.size());
+
+  SimResult result;
+  result.total = static_cast<int>(num_trials);
+  result.effective_samples = num_trials;
+  std::mt19937 rng(seed != 0 ? seed : 12345u);
+
+  // Board and uniform opponents by rejection: under half the live cards are ever taken.
+  auto draw_card = [&](std::uint64_t& used) {
+    uint8_t c;
+    do {
+      c = deck[(static_cast<std::uint64_t>(rng()) * deck_size) >> 32];
+    } while (used >> c & 1);
+    used |= 1ull << c;
+    return c;
+  };
+
+  // Rejecting the whole set (not just the colliding hand) keeps the deal
+  // distributed as the product of the ranges conditioned on disjointness.
+  constexpr int kMaxAttempts = 10000;
+  uint8_t cards[7];
+  std::copy(board.begin(), board.end(), cards);
+  uint8_t holdings[8][2];
+  for (std::uint32_t t = 0; t < num_trials; ++t) {
+    std::uint64_t used = 0;
+    for (int attempt = 0;; ++attempt) {
+      if (attempt == kMaxAttempts)
+        throw std::invalid_argument("opponent ranges overlap too much to deal together");
+      used = known;
+      int k = 0;
+      for (; k < num_weighted; ++k) {
+        const int combo = tables[k].sample(rng);
+        const std::uint64_t m = combo_mask(combo);
+        if (used & m) break;
+        used |= m;
+        const auto hc = combo_cards(combo);
+        holdings[weighted[k]][0] = hc.first;
+        holdings[weighted[k]][1] = hc.second;
+      }
+      if (k == num_weighted) break;
+    }
+    for (int o : uniform) {
+      holdings[o][0] = draw_card(used);
+      holdings[o][1] = draw_card(used);
+    }
+    for (int i = board_len; i < 5; ++i) cards[i] = draw_card(used);
+    cards[5] = hole_cards[0];
+    cards[6] = hole_cards[1];
+    const HandRank hero = evaluate_hand(cards, 7);
+    int outcome = 1;
+    for (int o = 0; o < num_opponents; ++o) {
+      cards[5] = holdings[o][0];
+      cards[6] = holdings[o][1];
+      const HandRank opp = evaluate_hand(cards, 7);
+      if (opp > hero) {
+        outcome = 0;
+        break;
+      }
+      outcome += opp == hero;
+    }
+    tally(result, outcome);
+  }
+  return result;
+}
+
+MultiwayResult multiway_equity(const std::vector<std::vector<uint8_t>>& hands,
+                               const std::vector<uint8_t>& board,
+                               std::uint64_t dead_mask,
+                               std::uint32_t num_trials,
+                               unsigned seed,
+                               unsigned num_threads) {
+  if (hands.size() < 2 || hands.size() > 9) throw std::invalid_argument("need 2-9 players");
+  if (num_trials == 0) throw std::invalid_argument("num_trials must be positive");
+  if (board.size() != 0 && board.size() != 3 && board.size() != 4 && board.size() != 5)
+    throw std::invalid_argument("board must have 0, 3, 4, or 5 cards");
+  std::uint64_t known = 0;
+  auto take = [&known](uint8_t c) {
+    if (c > 51) throw std::invalid_argument("card index out of range 0-51");
+    if (known >> c & 1) throw std::invalid_argument("hands, board and dead cards must not overlap");
+    known |= 1ull << c;
+  };
+  for (const auto& h : hands) {
+    if (h.size() != 2) throw std::invalid_argument("every player needs exactly 2 hole cards");
+    for (uint8_t c : h) take(c);
+  }
+  for (uint8_t c : board) take(c);
+  if (dead_mask >> 52) throw std::invalid_argument("dead card index out of range 0-51");
+  if (dead_mask & known) throw std::invalid_argument("hands, board and dead cards must not overlap");
+  known |= dead_mask;
+
+  std::vector<uint8_t> deck;
+  for (int c = 0; c < 52; ++c)
+    if (!(known >> c & 1)) deck.push_back(static_cast<uint8_t>(c));
+  const int d = static_cast<int>(deck.size());
+  const int board_len = static_cast<int>(board.size());
+  const int need = 5 - board_len;
+  if (need > d) throw std::invalid_argument("not enough cards in deck for this configuration");
+
+  double runouts = 1;
+  for (int k = 0; k < need; ++k) runouts = runouts * (d - k) / (k + 1);
+
+  MultiwayResult result;
+  const std::size_t n = hands.size();
+  MultiwayTally total(n);
+  if (runouts <= num_trials) {
+    // Exact: one task per first dealt card, the rest in increasing order.
+    result.exact = true;
+    result.runouts = static_cast<std::uint64_t>(runouts + 0.5);
+    const std::size_t tasks = need == 0 ? 1 : static_cast<std::size_t>(d);
+    std::vector<MultiwayTally> parts(tasks, MultiwayTally(n));
+    parallel_for(tasks, num_threads, [&](std::size_t first) {
+      uint8_t cards[7];
+      std::copy(board.begin(), board.end(), cards);
+      MultiwayTally& part = parts[first];
+      if (need == 0) {
+        part.add(cards, hands);
+        return;
+      }
+      cards[board_len] = deck[first];
+      auto rec = [&](auto&& self, int pos, int start) -> void {
+        if (pos == 5) {
+          part.add(cards, hands);
+          return;
+        }
+        for (int i = start; i <= d - (5 - pos); ++i) {
+          cards[pos] = deck[i];
+          self(self, pos + 1, i + 1);
+        }
+      };
+      rec(rec, board_len + 1, static_cast<int>(first) + 1);
+    });
+    for (const auto& p : parts) total.merge(p);
+  } else {
+    // Sampled: fixed chunks with their own streams, so threads don't change the result.
+    constexpr std::uint32_t kChunks = 16;
+    result.runouts = num_trials;
+    std::vector<MultiwayTally> parts(kChunks, MultiwayTally(n));
+    parallel_for(kChunks, num_threads, [&](std::size_t chunk) {
+      std::mt19937 rng((seed != 0 ? seed : 12345u) + static_cast<unsigned>(chunk) * 0x9E3779B9u);
+      const std::uint32_t trials = num_trials / kChunks + (chunk < num_trials % kChunks ? 1 : 0);
+      // Partial Fisher-Yates draws a uniform runout from any deck order, so the
+      // buffer is not reset between trials.
+      uint8_t buf[52];
+      uint8_t cards[7];
+      std::copy(deck.begin(), deck.end(), buf);
+      std::copy(board.begin(), board.end(), cards);
+      for (std::uint32_t t = 0; t < trials; ++t) {
+        for (int k = 0; k < need; ++k) {
+          std::swap(buf[k], buf[k + std::uniform_int_distribution<int>(0, d - k - 1)(rng)]);
+          cards[board_len + k] = buf[k];
+        }
+        parts[chunk].add(cards, hands);
+      }
+    });
+    for (const auto& p : parts) total.merge(p);
+  }
 
-    if (hero_value > 0) ++result.wins;
-    else if (hero_value < 0) ++result.losses;
-    else ++result.ties;
+  const double count = static_cast<double>(result.runouts);
+  for (std::size_t p = 0; p < n; ++p) {
+    result.equity.push_back(total.share[p] / count);
+    result.win.push_back(total.win[p] / count);
+    result.tie.push_back(total.tie[p] / count);
   }
   return result;
 }
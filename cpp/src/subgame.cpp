@@ -0,0 +1,663 @@
+#include "poker_sim/subgame.hpp"
+#include "poker_sim/hand_eval.hpp"
+#include "poker_sim/parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace poker_sim {
+
+namespace {
+
+/// Iterations between exploitability checks.
+constexpr int kCheckEvery = 25;
+
+/// Discounted CFR: positive regrets weigh t^alpha / (t^alpha + 1), negative
+/// ones t^beta / (t^beta + 1), and the average strategy (t / (t + 1))^gamma.
+constexpr double kAlpha = 1.5, kBeta = 0.0, kGamma = 2.0;
+
+/// Largest betting tree solve_subgame builds.
+constexpr std::size_t kMaxNodes = 200000;
+
+/// Rivers each matchup of two holdings sees on a turn: 52 - 4 board - 4 hole cards.
+constexpr double kLiveRivers = 44;
+
+const char kRankChars[] = "23456789TJQKA";
+const char kSuitChars[] = "cdhs";
+
+std::string label(const char* verb, double amount) {
+  char buf[48];
+  std::snprintf(buf, sizeof buf, "%s %g", verb, amount);
+  return buf;
+}
+
+/// IEEE half float, rounded to nearest even. Values stored here are scaled
+/// into [-1, 1], so overflow never happens and tiny ones go subnormal.
+uint16_t to_half(float f) {
+  uint32_t x;
+  std::memcpy(&x, &f, sizeof x);
+  const uint16_t sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+  const uint32_t ax = x & 0x7fffffff;
+  if (ax >= 0x477ff000) return sign | 0x7c00;
+  if (ax < 0x33000000) return sign;
+  if (ax < 0x38800000) {
+    float af;
+    std::memcpy(&af, &ax, sizeof af);
+    return sign | static_cast<uint16_t>(std::lrint(af * 16777216.0f));
+  }
+  const uint32_t r = ax - 0x38000000;
+  return sign | static_cast<uint16_t>((r + 0xfff + ((r >> 13) & 1)) >> 13);
+}
+
+float from_half(uint16_t h) {
+  const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16, e = (h >> 10) & 0x1f, m = h & 0x3ff;
+  if (e == 0) return (sign ? -1.0f : 1.0f) * m * (1.0f / 16777216.0f);
+  const uint32_t x = sign | (e == 31 ? 0x7f800000u | (m << 13) : ((e + 112) << 23) | (m << 13));
+  float f;
+  std::memcpy(&f, &x, sizeof f);
+  return f;
+}
+
+/// The river cards of a turn spot grouped by suit isomorphism: permutations
+/// of the suits that map the board onto itself and leave both ranges'
+/// weights unchanged.
+struct Rivers {
+  std::vector<uint8_t> cards;     // one per class, lowest card first
+  std::vector<int> counts;        // rivers in each class
+  int class_of[52];               // -1 for board cards
+  std::array<uint8_t, 4> to_rep[52];  // suit map taking each river to its class's card
+};
+
+uint8_t relabel(uint8_t c, const std::array<uint8_t, 4>& suits) {
+  return static_cast<uint8_t>(suits[c / 13] * 13 + c % 13);
+}
+
+Rivers river_classes(const SubgameSpot& spot) {
+  std::vector<std::array<uint8_t, 4>> group;
+  std::array<uint8_t, 4> s = {0, 1, 2, 3};
+  std::uint64_t board = 0;
+  for (uint8_t c : spot.board) board |= 1ull << c;
+  do {
+    bool keeps = true;
+    for (uint8_t c : spot.board) keeps = keeps && (board >> relabel(c, s) & 1);
+    for (int p = 0; p < 2 && keeps; ++p)
+      for (int i = 0; i < kNumCombos && keeps; ++i) {
+        const auto hc = combo_cards(i);
+        keeps = spot.ranges[p].weights[i] == spot.ranges[p].weights[combo_index(relabel(hc.first, s), relabel(hc.second, s))];
+      }
+    if (keeps) group.push_back(s);
+  } while (std::next_permutation(s.begin(), s.end()));
+
+  Rivers out;
+  for (int c = 0; c < 52; ++c) {
+    out.class_of[c] = -1;
+    if (board >> c & 1) continue;
+    uint8_t rep = static_cast<uint8_t>(c);
+    for (const auto& g : group) rep = std::min(rep, relabel(static_cast<uint8_t>(c), g));
+    for (const auto& g : group)
+      if (relabel(static_cast<uint8_t>(c), g) == rep) {
+        out.to_rep[c] = g;
+        break;
+      }
+    if (rep == c) {
+      out.cards.push_back(rep);
+      out.counts.push_back(0);
+    }
+    const int k = static_cast<int>(std::find(out.cards.begin(), out.cards.end(), rep) - out.cards.begin());
+    out.class_of[c] = k;
+    ++out.counts[k];
+  }
+  return out;
+}
+
+/// Builds the betting tree depth first into nodes.
+class TreeBuilder {
+ public:
+  TreeBuilder(const SubgameSpot& spot, const Rivers& rivers, std::vector<SubgameNode>& nodes)
+      : spot_(spot), rivers_(rivers), nodes_(nodes) {}
+
+  /// player to act; c0, c1 put in so far; raises made after the opening bet
+  /// this street; last when this is the river.
+  int action(int player, double c0, double c1, int raises, bool last) {
+    const int id = add(SubgameNode::ACTION, player, c0, c1);
+    const double c[2] = {c0, c1};
+    const double me = c[player], opp = c[1 - player];
+    std::vector<std::string> actions;
+    std::vector<int> children;
+    if (me == opp) {
+      actions.push_back("check");
+      children.push_back(player == 0 ? action(1, c0, c1, raises, last) : end_round(c0, last));
+      for (double to : amounts(spot_.tree.bets, opp, spot_.pot + c0 + c1)) {
+        actions.push_back(label(to >= spot_.stack ? "all-in" : "bet", to));
+        children.push_back(player == 0 ? action(1, to, c1, raises, last) : action(0, c0, to, raises, last));
+      }
+    } else {
+      actions.push_back("fold");
+      children.push_back(add(SubgameNode::FOLD, player, c0, c1));
+      actions.push_back("call");
+      children.push_back(end_round(opp, last));
+      if (raises < spot_.tree.max_raises) {
+        // A raise calls first, then adds its fraction of the pot after the call.
+        for (double to : amounts(spot_.tree.raises, opp, spot_.pot + 2 * opp)) {
+          actions.push_back(label(to >= spot_.stack ? "all-in" : "raise", to));
+          children.push_back(player == 0 ? action(1, to, c1, raises + 1, last)
+                                         : action(0, c0, to, raises + 1, last));
+        }
+      }
+    }
+    nodes_[id].actions = std::move(actions);
+    nodes_[id].children = std::move(children);
+    return id;
+  }
+
+ private:
+  /// Both players have put in c and the street's betting is over.
+  int end_round(double c, bool last) {
+    if (last) return add(SubgameNode::SHOWDOWN, -1, c, c);
+    const int id = add(SubgameNode::CHANCE, -1, c, c);
+    std::vector<std::string> actions;
+    std::vector<int> children;
+    for (uint8_t r : rivers_.cards) {
+      river_ = r;
+      actions.push_back(std::string("river ") + kRankChars[r % 13] + kSuitChars[r / 13]);
+      children.push_back(c >= spot_.stack ? add(SubgameNode::SHOWDOWN, -1, c, c) : action(0, c, c, 0, true));
+    }
+    river_ = -1;
+    nodes_[id].actions = std::move(actions);
+    nodes_[id].children = std::move(children);
+    nodes_[id].cards = rivers_.cards;
+    nodes_[id].counts = rivers_.counts;
+    return id;
+  }
+
+  int add(SubgameNode::Kind kind, int player, double c0, double c1) {
+    if (nodes_.size() >= kMaxNodes) throw std::invalid_argument("betting tree too large; use fewer sizes or raises");
+    SubgameNode n;
+    n.kind = kind;
+    n.player = player;
+    n.river = river_;
+    n.committed[0] = c0;
+    n.committed[1] = c1;
+    nodes_.push_back(std::move(n));
+    return static_cast<int>(nodes_.size()) - 1;
+  }
+
+  /// Totals to put in: base plus each fraction of pot, capped at the stack,
+  /// and the stack itself with all_in; distinct and above base.
+  std::vector<double> amounts(const std::vector<double>& fractions, double base, double pot) const {
+    std::vector<double> out;
+    for (double f : fractions) out.push_back(std::min(spot_.stack, base + f * pot));
+    if (spot_.tree.all_in) out.push_back(spot_.stack);
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end(), [](double a, double b) { return std::fabs(a - b) < 1e-9; }),
+              out.end());
+    out.erase(std::remove_if(out.begin(), out.end(), [&](double x) { return !(x > base + 1e-9); }), out.end());
+    return out;
+  }
+
+  const SubgameSpot& spot_;
+  const Rivers& rivers_;
+  std::vector<SubgameNode>& nodes_;
+  int river_ = -1;
+};
+
+/// Regrets and strategy sums as plain floats.
+struct FloatStore {
+  using Value = float;
+  static float load(float x) { return x; }
+  static void store(const float* x, std::size_t n, float* to, float& scale) {
+    std::copy(x, x + n, to);
+    scale = 1;
+  }
+};
+
+/// Regrets and strategy sums as half floats scaled by the node's largest
+/// magnitude: half the memory, at about three significant digits.
+struct HalfStore {
+  using Value = uint16_t;
+  static float load(uint16_t x) { return from_half(x); }
+  static void store(const float* x, std::size_t n, uint16_t* to, float& scale) {
+    float most = 0;
+    for (std::size_t i = 0; i < n; ++i) most = std::max(most, std::fabs(x[i]));
+    scale = most > 0 ? most : 1.0f;
+    const float inv = 1.0f / scale;
+    for (std::size_t i = 0; i < n; ++i) to[i] = to_half(x[i] * inv);
+  }
+};
+
+enum Mode { TRAIN, BEST_RESPONSE, EVALUATE };
+
+template <typename Store>
+class Solver {
+ public:
+  using Value = typename Store::Value;
+
+  Solver(const SubgameSpot& spot, const Rivers& rivers, SubgameSolution& out, unsigned num_threads)
+      : nodes_(out.nodes), rivers_(rivers), half_(spot.pot / 2), pool_(spot.board.size() == 5 ? 1 : num_threads) {
+    std::uint64_t board_mask = 0;
+    for (uint8_t c : spot.board) board_mask |= 1ull << c;
+    for (int p = 0; p < 2; ++p) {
+      for (int i = 0; i < kNumCombos; ++i) {
+        const double w = spot.ranges[p].weights[i];
+        if (w <= 0 || (combo_mask(i) & board_mask)) continue;
+        out.hands[p].push_back(i);
+        cards_[p].push_back(combo_cards(i));
+        mask_[p].push_back(combo_mask(i));
+        weight_[p].push_back(static_cast<float>(w));
+      }
+      if (out.hands[p].empty()) throw std::invalid_argument("a range has no holdings left on this board");
+    }
+    std::vector<int> where[2];
+    for (int p = 0; p < 2; ++p) {
+      where[p].assign(kNumCombos, -1);
+      for (std::size_t h = 0; h < out.hands[p].size(); ++h) where[p][out.hands[p][h]] = static_cast<int>(h);
+    }
+    for (int p = 0; p < 2; ++p)
+      for (int combo : out.hands[p]) same_[p].push_back(where[1 - p][combo]);
+    max_hands_ = std::max(out.hands[0].size(), out.hands[1].size());
+
+    // Street 0 is the board as given; on a turn, street k + 1 is river class k.
+    HandState board;
+    for (uint8_t c : spot.board) board.add(c);
+    streets_.resize(spot.board.size() == 5 ? 1 : 1 + rivers.cards.size());
+    if (spot.board.size() == 5) rank_street(streets_[0], board, -1);
+    for (std::size_t k = 0; k + 1 < streets_.size(); ++k) {
+      HandState river = board;
+      river.add(rivers.cards[k]);
+      rank_street(streets_[k + 1], river, rivers.cards[k]);
+    }
+    // Each river's holdings as holdings on its class's card.
+    if (spot.board.size() == 4)
+      for (int c = 0; c < 52; ++c) {
+        if (rivers.class_of[c] < 0 || rivers.cards[rivers.class_of[c]] == c) continue;
+        for (int p = 0; p < 2; ++p) {
+          std::vector<int>& map = perm_[c][p];
+          for (const auto& hc : cards_[p])
+            map.push_back(where[p][combo_index(relabel(hc.first, rivers.to_rep[c]), relabel(hc.second, rivers.to_rep[c]))]);
+        }
+      }
+
+    offset_.resize(nodes_.size());
+    regret_scale_.assign(nodes_.size(), 1.0f);
+    sum_scale_.assign(nodes_.size(), 1.0f);
+    std::size_t pool = 0;
+    for (std::size_t n = 0; n < nodes_.size(); ++n) {
+      const SubgameNode& node = nodes_[n];
+      if (node.kind != SubgameNode::ACTION) continue;
+      offset_[n] = pool;
+      pool += node.children.size() * out.hands[node.player].size();
+    }
+    regret_.assign(pool, 0);
+    sum_.assign(pool, 0);
+    scratch_.resize(streets_.size());
+  }
+
+  std::size_t hands(int p) const { return weight_[p].size(); }
+  const std::vector<float>& weights(int p) const { return weight_[p]; }
+
+  /// One iteration: each player's regrets updated in turn.
+  void iterate(int t) {
+    const double tp = std::pow(t, kAlpha), tn = std::pow(t, kBeta);
+    pos_ = static_cast<float>(tp / (tp + 1));
+    neg_ = static_cast<float>(tn / (tn + 1));
+    avg_ = static_cast<float>(std::pow(t / (t + 1.0), kGamma));
+    std::vector<float> values(max_hands_);
+    for (int p = 0; p < 2; ++p) walk(0, p, weight_[p].data(), weight_[1 - p].data(), values.data(), TRAIN, 0, 0);
+  }
+
+  /// Counterfactual values at the root of every holding of p.
+  std::vector<float> root_values(int p, Mode mode) {
+    std::vector<float> out(hands(p));
+    walk(0, p, weight_[p].data(), weight_[1 - p].data(), out.data(), mode, 0, 0);
+    return out;
+  }
+
+  /// Opposing weight each holding of p can meet.
+  std::vector<float> reachable(int p) {
+    std::vector<float> out(hands(p));
+    fold(p, weight_[1 - p].data(), 1.0, 0, out.data());
+    return out;
+  }
+
+  /// Normalized average strategy of an action node into s.
+  void average(int n, float* s) const {
+    const SubgameNode& node = nodes_[n];
+    const std::size_t k = node.children.size(), m = hands(node.player);
+    const Value* sum = &sum_[offset_[n]];
+    for (std::size_t h = 0; h < m; ++h) {
+      float total = 0;
+      for (std::size_t a = 0; a < k; ++a) total += s[a * m + h] = Store::load(sum[a * m + h]);
+      for (std::size_t a = 0; a < k; ++a) s[a * m + h] = total > 0 ? s[a * m + h] / total : 1.0f / k;
+    }
+  }
+
+ private:
+  /// Holding strengths on one street's board and the live ones in strength order.
+  struct Street {
+    std::uint64_t dead = 0;  // the river card
+    std::vector<HandRank> rank[2];
+    std::vector<int> order[2];  // weakest first, without holdings on dead cards
+  };
+
+  void rank_street(Street& st, const HandState& board, int river) {
+    if (river >= 0) st.dead = 1ull << river;
+    for (int p = 0; p < 2; ++p) {
+      st.rank[p].resize(hands(p));
+      for (std::size_t h = 0; h < hands(p); ++h) {
+        if (mask_[p][h] & st.dead) continue;
+        HandState s = board;
+        s.add(cards_[p][h].first);
+        s.add(cards_[p][h].second);
+        st.rank[p][h] = s.rank();
+        st.order[p].push_back(static_cast<int>(h));
+      }
+      std::sort(st.order[p].begin(), st.order[p].end(), [&](int x, int y) { return st.rank[p][x] < st.rank[p][y]; });
+    }
+  }
+
+  /// Scratch of at least n floats for the node depth deep on a street.
+  float* scratch(int street, int depth, std::size_t n) {
+    std::vector<std::vector<float>>& s = scratch_[street];
+    if (s.size() <= static_cast<std::size_t>(depth)) s.resize(depth + 1);
+    if (s[depth].size() < n) s[depth].resize(n);
+    return s[depth].data();
+  }
+
+  /// Regret matching on the node's regrets into s, total as scratch.
+  void current(int n, float* s, float* total) const {
+    const SubgameNode& node = nodes_[n];
+    const std::size_t k = node.children.size(), m = hands(node.player);
+    const Value* r = &regret_[offset_[n]];
+    std::fill(total, total + m, 0.0f);
+    for (std::size_t a = 0; a < k; ++a)
+      for (std::size_t h = 0; h < m; ++h) total[h] += s[a * m + h] = std::max(Store::load(r[a * m + h]), 0.0f);
+    for (std::size_t a = 0; a < k; ++a)
+      for (std::size_t h = 0; h < m; ++h) s[a * m + h] = total[h] > 0 ? s[a * m + h] / total[h] : 1.0f / k;
+  }
+
+  /// Counterfactual values of p's holdings at node n into out, given p's
+  /// reach (used for the average strategy) and the opponent's.
+  void walk(int n, int p, const float* self, const float* opp, float* out, Mode mode, int street, int depth) {
+    const SubgameNode& node = nodes_[n];
+    const int o = 1 - p;
+    const std::size_t mp = hands(p);
+    if (node.kind == SubgameNode::FOLD) {
+      fold(p, opp, node.player == p ? -(half_ + node.committed[p]) : half_ + node.committed[o], street, out);
+      return;
+    }
+    if (node.kind == SubgameNode::SHOWDOWN) {
+      showdown(p, opp, half_ + node.committed[p], street, out);
+      return;
+    }
+    if (node.kind == SubgameNode::CHANCE) {
+      chance(n, p, self, opp, out, mode, depth);
+      return;
+    }
+    const std::size_t k = node.children.size(), ma = hands(node.player), stride = max_hands_;
+    float* vals = scratch(street, depth, (3 * k + 2) * stride);
+    float* s = vals + k * stride;
+    float* work = s + k * stride;  // k * stride: decoded regrets and sums
+    float* reach = work + k * stride;
+    float* total = reach + stride;
+    if (node.player == p) {
+      if (mode == TRAIN) current(n, s, total);
+      else if (mode == EVALUATE) average(n, s);
+      for (std::size_t a = 0; a < k; ++a) {
+        const float* next = self;
+        if (mode == TRAIN) {
+          for (std::size_t h = 0; h < mp; ++h) reach[h] = self[h] * s[a * mp + h];
+          next = reach;
+        }
+        walk(node.children[a], p, next, opp, vals + a * stride, mode, street, depth + 1);
+      }
+      if (mode == BEST_RESPONSE) {
+        std::copy(vals, vals + mp, out);
+        for (std::size_t a = 1; a < k; ++a)
+          for (std::size_t h = 0; h < mp; ++h) out[h] = std::max(out[h], vals[a * stride + h]);
+        return;
+      }
+      std::fill(out, out + mp, 0.0f);
+      for (std::size_t a = 0; a < k; ++a)
+        for (std::size_t h = 0; h < mp; ++h) out[h] += s[a * mp + h] * vals[a * stride + h];
+      if (mode != TRAIN) return;
+      Value* r = &regret_[offset_[n]];
+      float scale = regret_scale_[n];
+      for (std::size_t a = 0; a < k; ++a) {
+        const float* v = vals + a * stride;
+        float* x = work + a * mp;
+        const Value* ra = r + a * mp;
+        for (std::size_t h = 0; h < mp; ++h) {
+          const float old = Store::load(ra[h]) * scale;
+          x[h] = old * (old > 0 ? pos_ : neg_) + v[h] - out[h];
+        }
+      }
+      Store::store(work, k * mp, r, regret_scale_[n]);
+      Value* sum = &sum_[offset_[n]];
+      scale = sum_scale_[n] * avg_;
+      for (std::size_t a = 0; a < k; ++a)
+        for (std::size_t h = 0; h < mp; ++h) work[a * mp + h] = Store::load(sum[a * mp + h]) * scale + self[h] * s[a * mp + h];
+      Store::store(work, k * mp, sum, sum_scale_[n]);
+      return;
+    }
+    // The opponent acts: its current strategy while training, else its average.
+    if (mode == TRAIN) current(n, s, total);
+    else average(n, s);
+    std::fill(out, out + mp, 0.0f);
+    for (std::size_t a = 0; a < k; ++a) {
+      for (std::size_t h = 0; h < ma; ++h) reach[h] = opp[h] * s[a * ma + h];
+      float* v = vals + a * stride;
+      walk(node.children[a], p, self, reach, v, mode, street, depth + 1);
+      for (std::size_t h = 0; h < mp; ++h) out[h] += v[h];
+    }
+  }
+
+  /// Deals the river: each class's subtree walked once, in parallel on the
+  /// solver's pool, with holdings on its card removed; every river's values are its class's
+  /// values through the suit map, each river weighing 1 / kLiveRivers.
+  void chance(int n, int p, const float* self, const float* opp, float* out, Mode mode, int depth) {
+    const SubgameNode& node = nodes_[n];
+    const int o = 1 - p;
+    const std::size_t k = node.children.size(), stride = max_hands_;
+    float* vals = scratch(0, depth, 3 * k * stride);
+    pool_.run(k, [&](std::size_t i) {
+      const Street& st = streets_[i + 1];
+      float* v = vals + i * stride;
+      float* rs = vals + (k + i) * stride;
+      float* ro = vals + (2 * k + i) * stride;
+      for (std::size_t h = 0; h < hands(p); ++h) rs[h] = mask_[p][h] & st.dead ? 0.0f : self[h];
+      for (std::size_t h = 0; h < hands(o); ++h) ro[h] = mask_[o][h] & st.dead ? 0.0f : opp[h];
+      walk(node.children[i], p, rs, ro, v, mode, static_cast<int>(i) + 1, 0);
+    });
+    std::fill(out, out + hands(p), 0.0f);
+    for (int c = 0; c < 52; ++c) {
+      const int cls = rivers_.class_of[c];
+      if (cls < 0) continue;
+      const float* v = vals + cls * stride;
+      const std::vector<int>& map = perm_[c][p];
+      if (map.empty()) {
+        for (std::size_t h = 0; h < hands(p); ++h) out[h] += v[h];
+      } else {
+        for (std::size_t h = 0; h < hands(p); ++h) out[h] += v[map[h]];
+      }
+    }
+    const float w = static_cast<float>(1 / kLiveRivers);
+    for (std::size_t h = 0; h < hands(p); ++h) out[h] *= w;
+  }
+
+  /// payoff times the opposing reach each holding of p can meet. Holdings on
+  /// the street's dead card get 0 (the opponent's already have no reach).
+  void fold(int p, const float* opp, double payoff, int street, float* out) const {
+    const int o = 1 - p;
+    const std::uint64_t dead = streets_[street].dead;
+    double total = 0, card[52] = {};
+    for (std::size_t j = 0; j < hands(o); ++j) {
+      total += opp[j];
+      card[cards_[o][j].first] += opp[j];
+      card[cards_[o][j].second] += opp[j];
+    }
+    for (std::size_t h = 0; h < hands(p); ++h) {
+      // The same holding was subtracted once per card.
+      double live = total - card[cards_[p][h].first] - card[cards_[p][h].second];
+      if (same_[p][h] >= 0) live += opp[same_[p][h]];
+      out[h] = mask_[p][h] & dead ? 0.0f : static_cast<float>(payoff * live);
+    }
+  }
+
+  /// amount times (opposing reach beaten - opposing reach beating), for
+  /// every live holding of p: both lists in strength order, swept once each way.
+  void showdown(int p, const float* opp, double amount, int street, float* out) const {
+    const int o = 1 - p;
+    const Street& st = streets_[street];
+    const std::vector<HandRank>& rank = st.rank[p];
+    const std::vector<HandRank>& versus = st.rank[o];
+    const std::vector<int>& mine = st.order[p];
+    const std::vector<int>& theirs = st.order[o];
+    const std::size_t mo = theirs.size();
+    if (st.dead) std::fill(out, out + hands(p), 0.0f);
+    double sum = 0, card[52] = {};
+    std::size_t j = 0;
+    for (int h : mine) {
+      for (; j < mo && versus[theirs[j]] < rank[h]; ++j) {
+        const int x = theirs[j];
+        sum += opp[x];
+        card[cards_[o][x].first] += opp[x];
+        card[cards_[o][x].second] += opp[x];
+      }
+      out[h] = static_cast<float>(amount * (sum - card[cards_[p][h].first] - card[cards_[p][h].second]));
+    }
+    sum = 0;
+    std::fill(card, card + 52, 0.0);
+    j = mo;
+    for (auto it = mine.rbegin(); it != mine.rend(); ++it) {
+      const int h = *it;
+      for (; j > 0 && versus[theirs[j - 1]] > rank[h]; --j) {
+        const int x = theirs[j - 1];
+        sum += opp[x];
+        card[cards_[o][x].first] += opp[x];
+        card[cards_[o][x].second] += opp[x];
+      }
+      out[h] -= static_cast<float>(amount * (sum - card[cards_[p][h].first] - card[cards_[p][h].second]));
+    }
+  }
+
+  std::vector<SubgameNode>& nodes_;
+  const Rivers& rivers_;
+  const double half_;
+  WorkerPool pool_;  // started once per solve; every chance node visit reuses it
+  std::vector<std::pair<uint8_t, uint8_t>> cards_[2];
+  std::vector<std::uint64_t> mask_[2];
+  std::vector<float> weight_[2];
+  std::vector<int> same_[2];  // the same holding in the other range, or -1
+  std::size_t max_hands_ = 0;
+  std::vector<Street> streets_;
+  std::vector<int> perm_[52][2];  // per river outside its class's card: holding -> holding on that card
+  std::vector<std::size_t> offset_;  // action nodes' first entry in regret_ and sum_
+  std::vector<Value> regret_, sum_;
+  std::vector<float> regret_scale_, sum_scale_;  // per node
+  std::vector<std::vector<std::vector<float>>> scratch_;  // [street][depth]
+  float pos_ = 1, neg_ = 1, avg_ = 1;
+};
+
+void validate(const SubgameSpot& spot, int max_iterations) {
+  if (spot.board.size() != 4 && spot.board.size() != 5) throw std::invalid_argument("subgame board must have 4 or 5 cards");
+  std::uint64_t seen = 0;
+  for (uint8_t c : spot.board) {
+    if (c > 51) throw std::invalid_argument("card index out of range 0-51");
+    if (seen >> c & 1) throw std::invalid_argument("board cards must be distinct");
+    seen |= 1ull << c;
+  }
+  if (!(spot.pot > 0)) throw std::invalid_argument("pot must be positive");
+  if (!(spot.stack >= 0)) throw std::invalid_argument("stack must not be negative");
+  for (double f : spot.tree.bets)
+    if (!(f > 0)) throw std::invalid_argument("bet sizes must be positive");
+  for (double f : spot.tree.raises)
+    if (!(f > 0)) throw std::invalid_argument("raise sizes must be positive");
+  if (spot.tree.max_raises < 0) throw std::invalid_argument("max_raises must not be negative");
+  if (max_iterations < 1) throw std::invalid_argument("max_iterations must be positive");
+}
+
+template <typename Store>
+void solve(const SubgameSpot& spot, const Rivers& rivers, int max_iterations, double target, unsigned num_threads,
+           SubgameSolution& out) {
+  Solver<Store> solver(spot, rivers, out, num_threads);
+
+  // Weight of all compatible matchups, normalizing values to chips per hand.
+  const std::vector<float> reach0 = solver.reachable(0);
+  double matchups = 0;
+  for (std::size_t h = 0; h < reach0.size(); ++h) matchups += static_cast<double>(solver.weights(0)[h]) * reach0[h];
+  if (!(matchups > 0)) throw std::invalid_argument("the ranges have no matchups on this board");
+  auto mean = [&](int p, const std::vector<float>& v) {
+    double total = 0;
+    for (std::size_t h = 0; h < v.size(); ++h) total += static_cast<double>(solver.weights(p)[h]) * v[h];
+    return total / matchups;
+  };
+
+  int t = 1;
+  for (; t <= max_iterations; ++t) {
+    solver.iterate(t);
+    if (t % kCheckEvery == 0 || t == max_iterations) {
+      out.exploitability = (mean(0, solver.root_values(0, BEST_RESPONSE)) +
+                            mean(1, solver.root_values(1, BEST_RESPONSE))) / 2;
+      if (out.exploitability <= target * spot.pot) break;
+    }
+  }
+  out.iterations = std::min(t, max_iterations);
+
+  for (std::size_t n = 0; n < out.nodes.size(); ++n) {
+    SubgameNode& node = out.nodes[n];
+    if (node.kind != SubgameNode::ACTION) continue;
+    node.strategy.resize(node.children.size() * solver.hands(node.player));
+    solver.average(static_cast<int>(n), node.strategy.data());
+  }
+  for (int p = 0; p < 2; ++p) {
+    const std::vector<float> v = solver.root_values(p, EVALUATE);
+    const std::vector<float> meet = solver.reachable(p);
+    out.ev[p].resize(v.size());
+    for (std::size_t h = 0; h < v.size(); ++h) out.ev[p][h] = spot.pot / 2 + (meet[h] > 0 ? v[h] / meet[h] : 0.0);
+    if (p == 0) out.value = spot.pot / 2 + mean(0, v);
+  }
+}
+
+}  // namespace
+
+SubgameSolution solve_subgame(const SubgameSpot& spot, int max_iterations, double target, unsigned num_threads) {
+  validate(spot, max_iterations);
+  SubgameSolution out;
+  if (spot.board.size() == 5) {
+    TreeBuilder(spot, Rivers{}, out.nodes).action(0, 0, 0, 0, true);
+    solve<FloatStore>(spot, Rivers{}, max_iterations, target, num_threads, out);
+  } else {
+    // A turn tree holds a river tree per class under every chance node;
+    // compact regrets keep it in memory.
+    const Rivers rivers = river_classes(spot);
+    for (int c = 0; c < 52; ++c) out.rivers.push_back(rivers.class_of[c] < 0 ? -1 : rivers.cards[rivers.class_of[c]]);
+    TreeBuilder(spot, rivers, out.nodes).action(0, 0, 0, 0, false);
+    solve<HalfStore>(spot, rivers, max_iterations, target, num_threads, out);
+  }
+  return out;
+}
+
+SubgameSize subgame_size(const SubgameSpot& spot) {
+  validate(spot, 1);
+  SubgameSize out;
+  std::uint64_t board_mask = 0;
+  for (uint8_t c : spot.board) board_mask |= 1ull << c;
+  for (int p = 0; p < 2; ++p) {
+    for (int i = 0; i < kNumCombos; ++i)
+      if (spot.ranges[p].weights[i] > 0 && !(combo_mask(i) & board_mask)) ++out.hands[p];
+    if (out.hands[p] == 0) throw std::invalid_argument("a range has no holdings left on this board");
+  }
+  std::vector<SubgameNode> nodes;
+  if (spot.board.size() == 5) {
+    TreeBuilder(spot, Rivers{}, nodes).action(0, 0, 0, 0, true);
+  } else {
+    TreeBuilder(spot, river_classes(spot), nodes).action(0, 0, 0, 0, false);
+  }
+  out.nodes = nodes.size();
+  return out;
+}
+
+}  // namespace poker_sim
@@ -0,0 +1,335 @@
+#include "poker_sim/table_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef POKER_SIM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace poker_sim {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'S', 'T', 'A', 'B', 'L', 'E', '\0'};
+constexpr std::size_t kDirectoryOffset = 128;
+constexpr std::size_t kNameBytes = 24;
+constexpr std::uint32_t kStored = 0, kZlibBlocks = 1;
+/// Uncompressed bytes per zlib block.
+constexpr std::uint64_t kBlockBytes = std::uint64_t{1} << 20;
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t format_version;
+  std::uint32_t kind;
+  std::uint32_t kind_version;
+  std::uint32_t rounds;
+  std::uint32_t cards_per_round[4];
+  std::uint64_t params[4];
+  std::uint32_t section_count;
+  std::uint32_t crc;  // of this header with crc = 0, then the directory
+};
+static_assert(sizeof(FileHeader) <= kDirectoryOffset, "table header overflows its slot");
+
+struct DirectoryEntry {
+  char name[kNameBytes];
+  std::uint64_t offset;
+  std::uint64_t stored_bytes;
+  std::uint64_t bytes;
+  std::uint32_t compression;
+  std::uint32_t crc;
+  std::uint64_t reserved;
+};
+static_assert(sizeof(DirectoryEntry) == 64, "directory entries are 64 bytes");
+
+constexpr std::size_t kMaxSections = (kTablePageBytes - kDirectoryOffset) / sizeof(DirectoryEntry);
+
+struct CrcTable {
+  std::uint32_t t[256];
+  CrcTable() {
+    for (std::uint32_t i = 0; i < 256; ++i) {
+      std::uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+  }
+};
+
+const CrcTable kCrc;
+
+std::uint64_t page_align(std::uint64_t n) { return (n + kTablePageBytes - 1) / kTablePageBytes * kTablePageBytes; }
+
+std::uint32_t header_crc(FileHeader h, const DirectoryEntry* dir) {
+  h.crc = 0;
+  return crc32(dir, h.section_count * sizeof(DirectoryEntry), crc32(&h, sizeof h));
+}
+
+/// Compressed layout: u64 block size, u64 block count, u64 end offset of
+/// each block (from the first block), then the zlib streams.
+std::vector<char> deflate_blocks(const char* data, std::size_t bytes) {
+#ifdef POKER_SIM_HAVE_ZLIB
+  const std::uint64_t blocks = (bytes + kBlockBytes - 1) / kBlockBytes;
+  std::vector<char> out((2 + blocks) * sizeof(std::uint64_t));
+  std::uint64_t* index = reinterpret_cast<std::uint64_t*>(out.data());
+  index[0] = kBlockBytes;
+  index[1] = blocks;
+  std::vector<Bytef> buf(compressBound(kBlockBytes));
+  for (std::uint64_t b = 0; b < blocks; ++b) {
+    const std::size_t n = std::min<std::size_t>(kBlockBytes, bytes - b * kBlockBytes);
+    uLongf len = static_cast<uLongf>(buf.size());
+    if (compress2(buf.data(), &len, reinterpret_cast<const Bytef*>(data + b * kBlockBytes), n, 6) != Z_OK)
+      throw std::runtime_error("zlib compression failed");
+    out.insert(out.end(), buf.begin(), buf.begin() + len);
+    index = reinterpret_cast<std::uint64_t*>(out.data());
+    index[2 + b] = out.size() - (2 + blocks) * sizeof(std::uint64_t);
+  }
+  return out;
+#else
+  (void)data;
+  (void)bytes;
+  throw std::runtime_error("table compression needs zlib, which this build lacks");
+#endif
+}
+
+std::vector<char> inflate_blocks(const char* stored, std::size_t stored_bytes, std::size_t bytes,
+                                 const std::string& where) {
+#ifdef POKER_SIM_HAVE_ZLIB
+  auto corrupt = [&]() { return std::runtime_error(where + " has a corrupt compressed section"); };
+  if (stored_bytes < 2 * sizeof(std::uint64_t)) throw corrupt();
+  std::uint64_t block_bytes, blocks;
+  std::memcpy(&block_bytes, stored, sizeof block_bytes);
+  std::memcpy(&blocks, stored + sizeof block_bytes, sizeof blocks);
+  if (block_bytes == 0 || blocks != (bytes + block_bytes - 1) / block_bytes ||
+      (2 + blocks) * sizeof(std::uint64_t) > stored_bytes)
+    throw corrupt();
+  const char* streams = stored + (2 + blocks) * sizeof(std::uint64_t);
+  const std::size_t streams_bytes = stored_bytes - (2 + blocks) * sizeof(std::uint64_t);
+  std::vector<char> out(bytes);
+  std::uint64_t begin = 0;
+  for (std::uint64_t b = 0; b < blocks; ++b) {
+    std::uint64_t end;
+    std::memcpy(&end, stored + (2 + b) * sizeof(std::uint64_t), sizeof end);
+    if (end < begin || end > streams_bytes) throw corrupt();
+    const std::size_t n = std::min<std::size_t>(block_bytes, bytes - b * block_bytes);
+    uLongf len = static_cast<uLongf>(n);
+    if (uncompress(reinterpret_cast<Bytef*>(out.data() + b * block_bytes), &len,
+                   reinterpret_cast<const Bytef*>(streams + begin), static_cast<uLong>(end - begin)) != Z_OK ||
+        len != n)
+      throw corrupt();
+    begin = end;
+  }
+  return out;
+#else
+  (void)stored;
+  (void)stored_bytes;
+  (void)bytes;
+  throw std::runtime_error(where + " has a compressed section and this build lacks zlib");
+#endif
+}
+
+}  // namespace
+
+const char* table_kind_name(TableKind kind) {
+  switch (kind) {
+    case TableKind::BUCKETS: return "buckets";
+    case TableKind::FLOP_EQUITY: return "flop_equity";
+    case TableKind::PREFLOP_MATRIX: return "preflop_matrix";
+  }
+  return "unknown";
+}
+
+std::uint32_t crc32(const void* data, std::size_t bytes, std::uint32_t crc) {
+  const auto* p = static_cast<const unsigned char*>(data);
+  crc = ~crc;
+  for (std::size_t i = 0; i < bytes; ++i) crc = kCrc.t[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+TableWriter::TableWriter(TableKind kind,
+                         std::uint32_t kind_version,
+                         std::vector<int> cards_per_round,
+                         std::array<std::uint64_t, 4> params)
+    : kind_(kind), kind_version_(kind_version), cards_per_round_(std::move(cards_per_round)), params_(params) {
+  if (cards_per_round_.size() > 4) throw std::invalid_argument("table index scheme has at most 4 rounds");
+}
+
+void TableWriter::add_section(const std::string& name, const void* data, std::size_t bytes, bool compress) {
+  if (name.empty() || name.size() >= kNameBytes) throw std::invalid_argument("section name must have 1-23 characters");
+  for (const auto& s : sections_)
+    if (s.name == name) throw std::invalid_argument("duplicate table section " + name);
+  if (sections_.size() == kMaxSections) throw std::invalid_argument("too many table sections");
+  TableSection s;
+  s.name = name;
+  s.bytes = bytes;
+  s.compressed = compress;
+  s.crc = crc32(data, bytes);
+  const char* p = static_cast<const char*>(data);
+  payloads_.push_back(compress ? deflate_blocks(p, bytes) : std::vector<char>(p, p + bytes));
+  s.stored_bytes = payloads_.back().size();
+  sections_.push_back(s);
+}
+
+void TableWriter::write(const std::string& path) const {
+  FileHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof kMagic);
+  h.format_version = kTableFormatVersion;
+  h.kind = static_cast<std::uint32_t>(kind_);
+  h.kind_version = kind_version_;
+  h.rounds = static_cast<std::uint32_t>(cards_per_round_.size());
+  for (std::size_t r = 0; r < cards_per_round_.size(); ++r) h.cards_per_round[r] = cards_per_round_[r];
+  for (int i = 0; i < 4; ++i) h.params[i] = params_[i];
+  h.section_count = static_cast<std::uint32_t>(sections_.size());
+
+  std::vector<DirectoryEntry> dir(sections_.size());
+  std::uint64_t offset = kTablePageBytes;
+  for (std::size_t i = 0; i < sections_.size(); ++i) {
+    const TableSection& s = sections_[i];
+    DirectoryEntry& e = dir[i];
+    e = DirectoryEntry{};
+    std::memcpy(e.name, s.name.data(), s.name.size());
+    e.offset = offset;
+    e.stored_bytes = s.stored_bytes;
+    e.bytes = s.bytes;
+    e.compression = s.compressed ? kZlibBlocks : kStored;
+    e.crc = s.crc;
+    offset = page_align(offset + s.stored_bytes);
+  }
+  h.crc = header_crc(h, dir.data());
+
+  std::vector<char> page(kTablePageBytes, 0);
+  std::memcpy(page.data(), &h, sizeof h);
+  std::memcpy(page.data() + kDirectoryOffset, dir.data(), dir.size() * sizeof(DirectoryEntry));
+
+  const std::string tmp = path + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (!f) throw std::runtime_error("cannot write " + tmp);
+  bool ok = std::fwrite(page.data(), page.size(), 1, f) == 1;
+  const std::vector<char> zeros(kTablePageBytes, 0);
+  for (std::size_t i = 0; ok && i < sections_.size(); ++i) {
+    const std::vector<char>& p = payloads_[i];
+    ok = p.empty() || std::fwrite(p.data(), 1, p.size(), f) == p.size();
+    const std::size_t pad = page_align(p.size()) - p.size();
+    ok = ok && (pad == 0 || std::fwrite(zeros.data(), 1, pad, f) == pad);
+  }
+  ok = std::fclose(f) == 0 && ok;
+  if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("error writing " + path);
+  }
+}
+
+TableFile::TableFile(const std::string& path) { open(path); }
+
+TableFile::TableFile(const std::string& path, TableKind expected_kind, std::uint32_t expected_kind_version) {
+  open(path);
+  if (kind_ != expected_kind)
+    throw std::runtime_error(path + " is a " + table_kind_name(kind_) + " table, not " +
+                             table_kind_name(expected_kind));
+  if (kind_version_ != expected_kind_version)
+    throw std::runtime_error(path + " has unsupported " + table_kind_name(kind_) + " table version");
+}
+
+void TableFile::open(const std::string& path) {
+  path_ = path;
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("cannot open table file " + path);
+  struct stat st;
+  length_ = ::fstat(fd, &st) == 0 ? static_cast<std::size_t>(st.st_size) : 0;
+  if (length_ < kTablePageBytes) {
+    ::close(fd);
+    throw std::runtime_error(path + " is not a table file");
+  }
+  mapping_ = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw std::runtime_error("cannot map table file " + path);
+  }
+
+  try {
+    read_directory();
+  } catch (...) {
+    ::munmap(mapping_, length_);
+    mapping_ = nullptr;
+    throw;
+  }
+}
+
+void TableFile::read_directory() {
+  const std::string& path = path_;
+  const char* base = static_cast<const char*>(mapping_);
+  FileHeader h;
+  std::memcpy(&h, base, sizeof h);
+  if (std::memcmp(h.magic, kMagic, sizeof kMagic) != 0) throw std::runtime_error(path + " is not a table file");
+  if (h.format_version != kTableFormatVersion)
+    throw std::runtime_error(path + " has unsupported table format version");
+  if (h.section_count > kMaxSections || h.rounds > 4 ||
+      h.crc != header_crc(h, reinterpret_cast<const DirectoryEntry*>(base + kDirectoryOffset)))
+    throw std::runtime_error(path + " has a corrupt header");
+  kind_ = static_cast<TableKind>(h.kind);
+  kind_version_ = h.kind_version;
+  cards_per_round_.assign(h.cards_per_round, h.cards_per_round + h.rounds);
+  for (int i = 0; i < 4; ++i) params_[i] = h.params[i];
+
+  sections_.resize(h.section_count);
+  data_.resize(h.section_count);
+  inflated_.resize(h.section_count);
+  for (std::uint32_t i = 0; i < h.section_count; ++i) {
+    DirectoryEntry e;
+    std::memcpy(&e, base + kDirectoryOffset + i * sizeof e, sizeof e);
+    TableSection& s = sections_[i];
+    s.name.assign(e.name, strnlen(e.name, kNameBytes));
+    s.offset = e.offset;
+    s.stored_bytes = e.stored_bytes;
+    s.bytes = e.bytes;
+    s.compressed = e.compression == kZlibBlocks;
+    s.crc = e.crc;
+    if (e.offset % kTablePageBytes != 0 || e.offset > length_ || e.stored_bytes > length_ - e.offset ||
+        (e.compression != kStored && e.compression != kZlibBlocks) ||
+        (e.compression == kStored && e.stored_bytes != e.bytes))
+      throw std::runtime_error(path + " is truncated or has a bad section " + s.name);
+    if (s.compressed) {
+      inflated_[i] = inflate_blocks(base + e.offset, e.stored_bytes, e.bytes, path);
+      data_[i] = inflated_[i].data();
+    } else {
+      data_[i] = base + e.offset;
+    }
+  }
+}
+
+TableFile::~TableFile() {
+  if (mapping_) ::munmap(mapping_, length_);
+}
+
+bool TableFile::has_section(const std::string& name) const {
+  for (const auto& s : sections_)
+    if (s.name == name) return true;
+  return false;
+}
+
+const void* TableFile::section(const std::string& name, std::size_t* bytes) const {
+  for (std::size_t i = 0; i < sections_.size(); ++i)
+    if (sections_[i].name == name) {
+      if (bytes) *bytes = sections_[i].bytes;
+      return data_[i];
+    }
+  throw std::runtime_error(path_ + " has no section " + name);
+}
+
+void TableFile::size_mismatch(const std::string& name) const {
+  throw std::runtime_error(path_ + " section " + name + " has the wrong size");
+}
+
+void TableFile::verify() const {
+  for (std::size_t i = 0; i < sections_.size(); ++i)
+    if (crc32(data_[i], sections_[i].bytes) != sections_[i].crc)
+      throw std::runtime_error(path_ + " section " + sections_[i].name + " fails its checksum");
+}
+
+}  // namespace poker_sim
@@ -0,0 +1,86 @@
+// Flop hand-abstraction pipeline: computes the river hand-strength histogram
+// of every canonical (hole, flop) pair, clusters them with weighted k-means
+// over their CDFs (an EMD stand-in) and writes a memory-mappable bucket file
+// indexed by HandIndexer({2, 3}).
+//
+// Usage: poker_sim_buckets [--buckets K] [--bins B] [--iterations N] [--seed S]
+//                          [--threads N] [--out FILE] [--compress]
+
+#include "poker_sim/buckets.hpp"
+#include "poker_sim/parallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned buckets = 200, bins = 50, iterations = 50, seed = 0, threads = 0;
+  std::string out_path = "flop_buckets.bin";
+  bool compress = false;
+
+  for (int i = 1; i < argc; ++i) {
+    auto number = [&]() { return static_cast<unsigned>(std::atoi(argv[++i])); };
+    if (!std::strcmp(argv[i], "--buckets") && i + 1 < argc) {
+      buckets = number();
+    } else if (!std::strcmp(argv[i], "--bins") && i + 1 < argc) {
+      bins = number();
+    } else if (!std::strcmp(argv[i], "--iterations") && i + 1 < argc) {
+      iterations = number();
+    } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+      seed = number();
+    } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = number();
+    } else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) {
+      out_path = argv[++i];
+    } else if (!std::strcmp(argv[i], "--compress")) {
+      compress = true;
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--buckets K] [--bins B] [--iterations N] [--seed S] [--threads N] [--out FILE] "
+                   "[--compress]\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+
+  try {
+    std::printf("threads: %u\n", threads ? threads : poker_sim::default_thread_count());
+    auto t0 = std::chrono::steady_clock::now();
+    const poker_sim::FlopFeatures features = poker_sim::compute_flop_features(bins, threads);
+    std::printf("features: %llu (hole, flop) classes x %u bins in %.1f s\n",
+                static_cast<unsigned long long>(features.size()), bins, seconds_since(t0));
+    std::fflush(stdout);
+
+    t0 = std::chrono::steady_clock::now();
+    const poker_sim::Clustering clusters = poker_sim::cluster_features(features, buckets, iterations, seed, threads);
+    std::printf("k-means: %u buckets, %u iterations, inertia %.6f in %.1f s\n", buckets, clusters.iterations,
+                clusters.inertia, seconds_since(t0));
+
+    std::vector<double> mass(buckets);
+    for (std::size_t i = 0; i < features.size(); ++i) mass[clusters.assignment[i]] += features.weights[i];
+    double total = 0;
+    for (double m : mass) total += m;
+    const auto [lo, hi] = std::minmax_element(mass.begin(), mass.end());
+    std::printf("bucket share of deals: min %.4f%%, max %.4f%%\n", 100 * *lo / total, 100 * *hi / total);
+
+    poker_sim::write_bucket_file(out_path, {2, 3}, clusters.assignment, buckets, compress);
+    std::printf("wrote %s\n", out_path.c_str());
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "error: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
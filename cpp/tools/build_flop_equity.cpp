@@ -0,0 +1,51 @@
+// Flop equity database: exact equity of every canonical (hole, flop) class
+// against 1-3 random opponents, over all runouts and opponent deals, written
+// as a memory-mappable table indexed by street_indexer(Street::FLOP).
+//
+// Usage: poker_sim_flop_equity [--threads N] [--out FILE] [--compress]
+
+#include "poker_sim/flop_equity.hpp"
+#include "poker_sim/parallel.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+  unsigned threads = 0;
+  std::string out_path = "flop_equity.bin";
+  bool compress = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) {
+      out_path = argv[++i];
+    } else if (!std::strcmp(argv[i], "--compress")) {
+      compress = true;
+    } else {
+      std::fprintf(stderr, "usage: %s [--threads N] [--out FILE] [--compress]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  try {
+    std::printf("threads: %u\n", threads ? threads : poker_sim::default_thread_count());
+    std::fflush(stdout);
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::vector<std::uint16_t> values = poker_sim::compute_flop_equity(threads);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("flop equity: %zu (hole, flop) classes x %d values in %.1f s\n",
+                values.size() / poker_sim::kFlopEquityValues, poker_sim::kFlopEquityValues, secs);
+    poker_sim::write_flop_equity_file(out_path, values, compress);
+    std::printf("wrote %s\n", out_path.c_str());
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "error: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
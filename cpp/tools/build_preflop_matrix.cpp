@@ -0,0 +1,51 @@
+// Preflop matchup matrix: exact win and tie probability of each of the 169
+// starting-hand classes against each other, over every pair of disjoint
+// holdings and every board, written as a memory-mappable table.
+//
+// Usage: poker_sim_preflop_matrix [--threads N] [--out FILE] [--compress]
+
+#include "poker_sim/parallel.hpp"
+#include "poker_sim/preflop_matrix.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+  unsigned threads = 0;
+  std::string out_path = "preflop_matrix.bin";
+  bool compress = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) {
+      out_path = argv[++i];
+    } else if (!std::strcmp(argv[i], "--compress")) {
+      compress = true;
+    } else {
+      std::fprintf(stderr, "usage: %s [--threads N] [--out FILE] [--compress]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  try {
+    std::printf("threads: %u\n", threads ? threads : poker_sim::default_thread_count());
+    std::fflush(stdout);
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::vector<float> values = poker_sim::compute_preflop_matrix(threads);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("preflop matrix: %d x %d classes in %.1f s\n", poker_sim::kNumPreflopClasses,
+                poker_sim::kNumPreflopClasses, secs);
+    poker_sim::write_preflop_matrix_file(out_path, values, compress);
+    std::printf("wrote %s\n", out_path.c_str());
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "error: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -25,8 +25,12 @@ from pydantic import BaseModel, Field
 
 try:
     from poker_sim import run_monte_carlo, get_strategy_message, get_suggested_action
-    from poker_sim.equity import equity_at_each_street, describe_hand, possible_hands_that_beat, get_potential_draws
+    from poker_sim.monte_carlo import multiway_equity
+    from poker_sim.equity import equity_at_each_street, describe_hand, possible_hands_that_beat, beating_categories, get_potential_draws, range_vs_range_equity, outs_analysis, holdings_vs_hero, equity_histogram, equity_grid
     from poker_sim.live_analysis import live_analysis
+    from poker_sim.tournament import icm_equity, push_fold, push_fold_charts
+    from poker_sim.solver import solve_river, solve_turn, subgame_work
+    from poker_sim.self_play import self_play
 except ImportError as e:
     raise RuntimeError(
         f"Cannot import poker_sim (is the server running from the python/ directory?). {e}"
@@ -56,14 +60,20 @@ class SimulateRequest(BaseModel):
     board: list[int] = Field(default_factory=list, max_length=5, description="0, 3, 4, or 5 card indices")
     num_opponents: int = Field(default=1, ge=1, le=8)
     num_trials: int = Field(default=10000, ge=10, le=500000)
+    sampler: str = Field(default="iid", pattern="^(iid|stratified|antithetic|lhs|sobol|sobol_scrambled)$", description="Deal sampler")
+    opponent_ranges: list[str] | None = Field(default=None, max_length=8, description="Opponent ranges, e.g. 'TT+,AQs+,KQo' (one, or one per opponent)")
+    dead_cards: list[int] = Field(default_factory=list, max_length=30, description="Folded/exposed cards out of the deck")
 
 
 class SimulateResponse(BaseModel):
     win_pct: float
     tie_pct: float
     loss_pct: float
+    equity: float | None = None
     suggested_action: str
     strategy_message: str
+    effective_samples: float | None = None
+    exact: bool = False
     elapsed_ms: float | None = None
 
 
@@ -85,15 +95,210 @@ class EquityByStreetResponse(BaseModel):
     elapsed_ms: float | None = None
 
 
+class RangeEquityRequest(BaseModel):
+    range_a: str = Field(..., min_length=1, max_length=500, description="Range A, e.g. 'TT+,AQs+,KQo'")
+    range_b: str = Field(..., min_length=1, max_length=500, description="Range B")
+    board: list[int] = Field(..., max_length=5, description="3, 4, or 5 card indices; empty for preflop (needs the preflop matrix)")
+    dead_cards: list[int] = Field(default_factory=list, max_length=30, description="Cards out of play")
+
+
+class RangeEquityResponse(BaseModel):
+    equity_a: float
+    equity_b: float
+    win_a: float
+    win_b: float
+    tie: float
+    runouts: int
+    hands_a: list[dict]
+    hands_b: list[dict]
+    elapsed_ms: float | None = None
+
+
+class EquityHistogramRequest(BaseModel):
+    hole_cards: list[int] = Field(..., min_length=2, max_length=2)
+    board: list[int] = Field(..., min_length=3, max_length=4, description="Flop or turn")
+    opponent_range: str = Field(default="random", min_length=1, max_length=500)
+    dead_cards: list[int] = Field(default_factory=list, max_length=30)
+    bins: int = Field(default=10, ge=1, le=100)
+
+
+class EquityHistogramResponse(BaseModel):
+    equity: float
+    next_card: list[float]
+    next_two_cards: list[float]
+    runouts: int
+    elapsed_ms: float | None = None
+
+
+class EquityGridRequest(BaseModel):
+    board: list[int] = Field(default_factory=list, max_length=5, description="0, 3, 4, or 5 card indices")
+    num_opponents: int = Field(default=1, ge=1, le=8)
+    dead_cards: list[int] = Field(default_factory=list, max_length=30)
+    num_trials: int = Field(default=2000, ge=100, le=100000, description="Runouts sampled when there are more")
+    seed: int | None = None
+
+
+class EquityGridResponse(BaseModel):
+    ranks: str
+    grid: list[list[dict]]
+    exact: bool
+    runouts: int
+    elapsed_ms: float | None = None
+
+
+class PushFoldRequest(BaseModel):
+    stacks: list[float] = Field(..., min_length=2, max_length=9, description="Stacks in big blinds, in action order, blinds last")
+    ante: float = Field(default=0.0, ge=0, le=1)
+    small_blind: float = Field(default=0.5, ge=0, le=1)
+    payouts: list[float] = Field(default_factory=list, max_length=1000, description="Prizes by place for ICM $EV; empty for chip EV")
+
+
+class PushFoldChartsRequest(BaseModel):
+    depths: list[float] = Field(..., min_length=1, max_length=40, description="Equal stack depths in big blinds")
+    players: int = Field(default=2, ge=2, le=9)
+    ante: float = Field(default=0.0, ge=0, le=1)
+    payouts: list[float] = Field(default_factory=list, max_length=1000, description="Prizes by place for ICM $EV; empty for chip EV")
+
+
+class PushFoldResponse(BaseModel):
+    ranks: str
+    positions: list[str]
+    stacks: list[float]
+    jam: list[dict]
+    call: list[dict]
+    ev: list[float]
+    icm: list[float] | None = None
+    exploitability: float
+    iterations: int
+    elapsed_ms: float | None = None
+
+
+class PushFoldChartsResponse(BaseModel):
+    charts: list[PushFoldResponse]
+    elapsed_ms: float | None = None
+
+
+# Sampled ICM costs about one step per order per paid place (20,000 orders
+# with 100 places paid take about 0.2 s), so their product is capped too.
+ICM_MAX_SAMPLED_STEPS = 5_000_000
+
+
+class IcmRequest(BaseModel):
+    stacks: list[float] = Field(..., min_length=1, max_length=2000)
+    payouts: list[float] = Field(..., min_length=1, max_length=250, description="Prize for each place, first place first")
+    num_trials: int = Field(default=20000, ge=1000, le=200000, description="Finishing orders sampled above 20 players; num_trials x paid places at most 5,000,000")
+    seed: int | None = None
+
+
+class IcmResponse(BaseModel):
+    equity: list[float]
+    exact: bool
+    trials: int
+    elapsed_ms: float | None = None
+
+
+class SolveRiverRequest(BaseModel):
+    board: list[int] = Field(..., min_length=5, max_length=5)
+    oop_range: str = Field(..., min_length=1, max_length=500, description="Out-of-position range, acts first")
+    ip_range: str = Field(..., min_length=1, max_length=500)
+    pot: float = Field(..., gt=0)
+    stack: float = Field(..., ge=0, description="Effective stack behind")
+    bets: list[float] = Field(default_factory=lambda: [0.5, 1.0], max_length=4, description="Bet sizes, fractions of the pot")
+    raises: list[float] = Field(default_factory=lambda: [1.0], max_length=3, description="Raise sizes, fractions of the pot after calling")
+    max_raises: int = Field(default=2, ge=0, le=4)
+    all_in: bool = True
+    max_iterations: int = Field(default=1000, ge=1, le=10000)
+    target: float = Field(default=0.003, gt=0, le=0.1, description="Exploitability to stop at, fraction of the pot")
+
+
+# A turn solve iteration costs about 18 ns of one core per tree node per live
+# holding (full ranges on the default tree are 26 million, 0.5 s), so tree
+# size x holdings x max_iterations is capped: about a minute of one core, a
+# few seconds across a server's cores.
+SOLVE_TURN_MAX_WORK = 3_000_000_000
+
+
+class SolveTurnRequest(BaseModel):
+    board: list[int] = Field(..., min_length=4, max_length=4)
+    oop_range: str = Field(..., min_length=1, max_length=500, description="Out-of-position range, acts first")
+    ip_range: str = Field(..., min_length=1, max_length=500)
+    pot: float = Field(..., gt=0)
+    stack: float = Field(..., ge=0, description="Effective stack behind")
+    bets: list[float] = Field(default_factory=lambda: [0.5, 1.0], max_length=2, description="Bet sizes, fractions of the pot")
+    raises: list[float] = Field(default_factory=lambda: [1.0], max_length=1, description="Raise sizes, fractions of the pot after calling")
+    max_raises: int = Field(default=1, ge=0, le=2)
+    all_in: bool = True
+    max_iterations: int = Field(default=100, ge=1, le=1000, description="Tree nodes x live holdings x max_iterations at most 3,000,000,000")
+    target: float = Field(default=0.005, gt=0, le=0.1, description="Exploitability to stop at, fraction of the pot")
+    river: int | None = Field(default=None, ge=0, le=51, description="River card whose strategies to return")
+
+
+class SolveSubgameResponse(BaseModel):
+    players: list[str]
+    hands: list[list[dict]]
+    nodes: list[dict]
+    river: str | None = None
+    solved_as: str | None = None
+    value: float
+    exploitability: float
+    iterations: int
+    elapsed_ms: float | None = None
+
+
+class SelfPlayRequest(BaseModel):
+    bots: list[str] = Field(..., min_length=2, max_length=9, description="One bot per seat: station, maniac, random, rock, tag, lag")
+    num_hands: int = Field(default=100000, ge=100, le=20000000)
+    stack: float = Field(default=100.0, ge=1, le=10000, description="Starting stack of every seat (bb)")
+    stacks: list[float] = Field(default_factory=list, max_length=9, description="Starting stack per seat; overrides stack")
+    small_blind: float = Field(default=0.5, gt=0, le=1)
+    seed: int | None = None
+
+
+class SelfPlayResponse(BaseModel):
+    seats: list[dict]
+    hands: int
+    hands_per_second: float | None = None
+    elapsed_ms: float | None = None
+
+
+class AllInEquityRequest(BaseModel):
+    hands: list[list[int]] = Field(..., min_length=2, max_length=9, description="Each player's 2 hole cards")
+    board: list[int] = Field(default_factory=list, max_length=5, description="0, 3, 4, or 5 card indices")
+    dead_cards: list[int] = Field(default_factory=list, max_length=30, description="Folded/exposed cards out of the deck")
+    num_trials: int = Field(default=20000, ge=100, le=500000)
+
+
+class AllInEquityResponse(BaseModel):
+    equity: list[float]
+    win: list[float]
+    tie: list[float]
+    runouts: int
+    exact: bool
+    elapsed_ms: float | None = None
+
+
+class OutsRequest(BaseModel):
+    hole_cards: list[int] = Field(..., min_length=2, max_length=2)
+    board: list[int] = Field(..., min_length=3, max_length=4, description="Flop or turn")
+    opponent_range: str = Field(default="random", min_length=1, max_length=500)
+    dead_cards: list[int] = Field(default_factory=list, max_length=30)
+
+
 class AnalyzeRequest(BaseModel):
     hole_cards: list[int] = Field(..., min_length=2, max_length=2)
     board: list[int] = Field(default_factory=list, max_length=5)
+    dead_cards: list[int] = Field(default_factory=list, max_length=30)
 
 
 class AnalyzeResponse(BaseModel):
     hand_name: str
     hands_that_beat: list[str]
     potential_draws: list[str]
+    # Exact holding counts (C++ engine only)
+    combos_ahead: int | None = None
+    combos_tied: int | None = None
+    combos_behind: int | None = None
+    percentile: float | None = None
     elapsed_ms: float | None = None
 
 
@@ -558,6 +763,7 @@ class LiveAnalysisRequest(BaseModel):
     cards: list[int] = Field(..., min_length=1, max_length=7)
     num_opponents: int = Field(default=1, ge=1, le=8)
     num_trials: int = Field(default=3000, ge=500, le=50000)
+    dead_cards: list[int] = Field(default_factory=list, max_length=30, description="Folded/exposed cards out of the deck")
 
 
 @app.post("/api/live-analysis")
@@ -570,13 +776,14 @@ def api_live_analysis(req: LiveAnalysisRequest):
             cards=req.cards,
             num_opponents=req.num_opponents,
             num_trials=req.num_trials,
+            dead_cards=req.dead_cards,
         )
         elapsed = time.perf_counter() - t0
         logger.info(f"Live analysis: {len(req.cards)} cards, {req.num_trials} trials -> {elapsed:.3f}s")
         data["elapsed_ms"] = elapsed * 1000
         if "win_pct" in data and "tie_pct" in data:
-            data["suggested_action"] = get_suggested_action(data["win_pct"], data["tie_pct"])
-            data["strategy_message"] = get_strategy_message(data["win_pct"], data["tie_pct"])
+            data["suggested_action"] = get_suggested_action(data["win_pct"], data["tie_pct"], data.get("equity"))
+            data["strategy_message"] = get_strategy_message(data["win_pct"], data["tie_pct"], data.get("equity"))
         return data
     except Exception as e:
         logger.exception("Live analysis failed")
@@ -593,6 +800,7 @@ def equity_by_street(req: SimulateRequest):
             board=req.board or [],
             num_opponents=req.num_opponents,
             num_trials=min(req.num_trials, 20000),
+            dead_cards=req.dead_cards,
         )
         elapsed = time.perf_counter() - t0
         logger.info(f"Equity by street: {elapsed:.3f}s")
@@ -604,6 +812,216 @@ def equity_by_street(req: SimulateRequest):
         raise HTTPException(status_code=500, detail=str(e))
 
 
+@app.post("/api/range-equity", response_model=RangeEquityResponse)
+def range_equity(req: RangeEquityRequest):
+    """Exact range-vs-range equity over every runout of the board."""
+    t0 = time.perf_counter()
+    try:
+        data = range_vs_range_equity(req.range_a, req.range_b, req.board, req.dead_cards)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("Range equity failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"Range equity: board {len(req.board)}, {data['runouts']} runouts -> {elapsed:.3f}s")
+    return RangeEquityResponse(**data, elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/equity-histogram", response_model=EquityHistogramResponse)
+def equity_distribution(req: EquityHistogramRequest):
+    """How hero's equity is spread over the next card(s), not just its mean."""
+    t0 = time.perf_counter()
+    try:
+        data = equity_histogram(req.hole_cards, req.board, req.opponent_range, req.dead_cards, req.bins)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("Equity histogram failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"Equity histogram: board {len(req.board)}, {data['runouts']} runouts -> {elapsed:.3f}s")
+    return EquityHistogramResponse(**data, elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/equity-grid", response_model=EquityGridResponse)
+def starting_hand_grid(req: EquityGridRequest):
+    """Equity of all 169 starting hands on the board, as a 13x13 heatmap grid."""
+    t0 = time.perf_counter()
+    try:
+        data = equity_grid(req.board, req.num_opponents, req.dead_cards, req.num_trials, req.seed)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("Equity grid failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"Equity grid: board {len(req.board)}, {req.num_opponents} opponents, "
+                f"{data['runouts']} runouts -> {elapsed:.3f}s")
+    return EquityGridResponse(**data, elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/push-fold", response_model=PushFoldResponse)
+def push_fold_spot(req: PushFoldRequest):
+    """Push/fold equilibrium jam and call charts for one spot."""
+    t0 = time.perf_counter()
+    try:
+        data = push_fold(req.stacks, req.ante, req.small_blind, req.payouts)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("Push/fold failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"Push/fold: {len(req.stacks)} players, {data['iterations']} iterations -> {elapsed:.3f}s")
+    return PushFoldResponse(**data, elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/push-fold/charts", response_model=PushFoldChartsResponse)
+def push_fold_depths(req: PushFoldChartsRequest):
+    """Push/fold charts for equal stacks at each depth."""
+    t0 = time.perf_counter()
+    try:
+        charts = push_fold_charts(req.depths, req.players, req.ante, req.payouts)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("Push/fold charts failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"Push/fold charts: {len(req.depths)} depths, {req.players} players -> {elapsed:.3f}s")
+    return PushFoldChartsResponse(charts=[PushFoldResponse(**c) for c in charts], elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/icm", response_model=IcmResponse)
+def icm_prize_equity(req: IcmRequest):
+    """ICM prize equity of each stack for a payout structure."""
+    if len(req.stacks) > 20 and req.num_trials * len(req.payouts) > ICM_MAX_SAMPLED_STEPS:
+        raise HTTPException(status_code=400, detail=f"num_trials x paid places must be at most {ICM_MAX_SAMPLED_STEPS:,}")
+    t0 = time.perf_counter()
+    try:
+        data = icm_equity(req.stacks, req.payouts, req.num_trials, req.seed)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("ICM failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"ICM: {len(req.stacks)} players, {len(req.payouts)} payouts, exact={data['exact']} -> {elapsed:.3f}s")
+    return IcmResponse(**data, elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/solve-river", response_model=SolveSubgameResponse)
+def solve_river_spot(req: SolveRiverRequest):
+    """Heads-up river equilibrium between two ranges over a bet-size tree."""
+    t0 = time.perf_counter()
+    try:
+        data = solve_river(req.board, req.oop_range, req.ip_range, req.pot, req.stack, req.bets, req.raises,
+                           req.max_raises, req.all_in, req.max_iterations, req.target)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("River solve failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"River solve: {len(data['hands'][0])}x{len(data['hands'][1])} hands, {len(data['nodes'])} nodes, "
+                f"{data['iterations']} iterations -> {elapsed:.3f}s")
+    return SolveSubgameResponse(**data, elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/solve-turn", response_model=SolveSubgameResponse)
+def solve_turn_spot(req: SolveTurnRequest):
+    """Heads-up turn equilibrium played through the river, with one river's strategies."""
+    t0 = time.perf_counter()
+    try:
+        work = subgame_work(req.board, req.oop_range, req.ip_range, req.pot, req.stack, req.bets, req.raises,
+                            req.max_raises, req.all_in) * req.max_iterations
+        if work > SOLVE_TURN_MAX_WORK:
+            raise ValueError(f"tree nodes x live holdings x max_iterations is {work:,}; "
+                             f"it must be at most {SOLVE_TURN_MAX_WORK:,} (narrow the ranges or sizes)")
+        data = solve_turn(req.board, req.oop_range, req.ip_range, req.pot, req.stack, req.bets, req.raises,
+                          req.max_raises, req.all_in, req.max_iterations, req.target, req.river)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("Turn solve failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"Turn solve: {len(data['hands'][0])}x{len(data['hands'][1])} hands, "
+                f"{data['iterations']} iterations -> {elapsed:.3f}s")
+    return SolveSubgameResponse(**data, elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/self-play", response_model=SelfPlayResponse)
+def self_play_match(req: SelfPlayRequest):
+    """Bots playing full no-limit hands against each other; bb/100 per seat."""
+    t0 = time.perf_counter()
+    try:
+        data = self_play(req.bots, req.num_hands, req.stack, req.stacks, req.small_blind, req.seed)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("Self-play failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"Self-play: {len(req.bots)} bots, {data['hands']} hands -> {elapsed:.3f}s")
+    return SelfPlayResponse(**data, hands_per_second=data["hands"] / max(elapsed, 1e-9), elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/all-in-equity", response_model=AllInEquityResponse)
+def all_in_equity(req: AllInEquityRequest):
+    """Per-player equity of an all-in between known hands (split pots shared)."""
+    t0 = time.perf_counter()
+    try:
+        data = multiway_equity(req.hands, req.board, req.dead_cards, req.num_trials)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except Exception as e:
+        logger.exception("All-in equity failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"All-in equity: {len(req.hands)} players, {data['runouts']} runouts "
+                f"({'exact' if data['exact'] else 'sampled'}) -> {elapsed:.3f}s")
+    return AllInEquityResponse(**data, elapsed_ms=elapsed * 1000)
+
+
+@app.post("/api/outs")
+def outs(req: OutsRequest):
+    """Per-card outs heatmap: what every next card does for hero against a range."""
+    t0 = time.perf_counter()
+    try:
+        data = outs_analysis(req.hole_cards, req.board, req.opponent_range, req.dead_cards)
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
+    except Exception as e:
+        logger.exception("Outs analysis failed")
+        raise HTTPException(status_code=500, detail=str(e))
+    elapsed = time.perf_counter() - t0
+    logger.info(f"Outs: board {len(req.board)}, {data['outs']} outs -> {elapsed:.3f}s")
+    data["elapsed_ms"] = elapsed * 1000
+    return data
+
+
 @app.post("/api/analyze", response_model=AnalyzeResponse)
 def analyze(req: AnalyzeRequest):
     """Describe hero's hand, what beats it, and potential draws."""
@@ -613,8 +1031,27 @@ def analyze(req: AnalyzeRequest):
         if len(all_cards) < 5:
             return AnalyzeResponse(hand_name="Need 5+ cards", hands_that_beat=[], potential_draws=[])
         desc = describe_hand(all_cards)
-        beat_by = possible_hands_that_beat(req.hole_cards, req.board) if desc["hand_type_id"] >= 0 else []
-        draws = get_potential_draws(req.hole_cards, req.board)
+        # One enumeration of the opponent holdings gives both what beats hero
+        # and the counts; without the extension, fall back to the rules.
+        holdings = None
+        if 3 <= len(req.board) <= 5:
+            try:
+                holdings = holdings_vs_hero(req.hole_cards, req.board, req.dead_cards)
+            except NotImplementedError:
+                pass
+        beat_by = []
+        if desc["hand_type_id"] >= 0:
+            beat_by = (beating_categories(holdings) if holdings is not None
+                       else possible_hands_that_beat(req.hole_cards, req.board, req.dead_cards))
+        draws = get_potential_draws(req.hole_cards, req.board, req.dead_cards)
+        counts = {}
+        if holdings is not None:
+            counts = dict(
+                combos_ahead=len(holdings["ahead"]),
+                combos_tied=len(holdings["tied"]),
+                combos_behind=len(holdings["behind"]),
+                percentile=holdings["percentile"],
+            )
         elapsed = time.perf_counter() - t0
         logger.info(f"Analyze: {elapsed:.3f}s")
         return AnalyzeResponse(
@@ -622,7 +1059,10 @@ def analyze(req: AnalyzeRequest):
             hands_that_beat=beat_by,
             potential_draws=draws,
             elapsed_ms=elapsed * 1000,
+            **counts,
         )
+    except ValueError as e:
+        raise HTTPException(status_code=400, detail=str(e))
     except Exception as e:
         logger.exception("Analyze failed")
         raise HTTPException(status_code=500, detail=str(e))
@@ -637,22 +1077,31 @@ def simulate(req: SimulateRequest):
             board=req.board if req.board else None,
             num_opponents=req.num_opponents,
             num_trials=req.num_trials,
+            sampler=req.sampler,
+            opponent_ranges=req.opponent_ranges,
+            dead_cards=req.dead_cards,
         )
     except ValueError as e:
         raise HTTPException(status_code=400, detail=str(e))
+    except NotImplementedError as e:
+        raise HTTPException(status_code=501, detail=str(e))
     except Exception as e:
         logger.exception("Simulation failed")
         raise HTTPException(status_code=500, detail=str(e))
     elapsed = time.perf_counter() - t0
-    logger.info(f"Simulation: {req.num_trials} trials -> {elapsed:.3f}s")
+    logger.info(f"Simulation: {req.num_trials} trials ({req.sampler}{', ranges' if req.opponent_ranges else ''}) -> {elapsed:.3f}s")
     win_pct = result.win_rate()
     tie_pct = result.tie_rate()
+    equity = result.equity()
     return SimulateResponse(
         win_pct=win_pct,
         tie_pct=tie_pct,
         loss_pct=result.loss_rate(),
-        suggested_action=get_suggested_action(win_pct, tie_pct),
-        strategy_message=get_strategy_message(win_pct, tie_pct),
+        equity=equity,
+        suggested_action=get_suggested_action(win_pct, tie_pct, equity),
+        strategy_message=get_strategy_message(win_pct, tie_pct, equity),
+        effective_samples=result.effective_samples,
+        exact=result.exact,
         elapsed_ms=elapsed * 1000,
     )
 
@@ -6,6 +6,23 @@ Shows how probability evolves as each card is revealed.
 from typing import List, Optional
 
 from poker_sim.monte_carlo import run_monte_carlo
+
+try:
+    from poker_sim.poker_sim_cpp import range_vs_range_equity as _cpp_range_equity
+    from poker_sim.poker_sim_cpp import analyze_outs as _cpp_analyze_outs
+    from poker_sim.poker_sim_cpp import classify_holdings as _cpp_classify_holdings
+    from poker_sim.poker_sim_cpp import hand_strength as _cpp_hand_strength
+    from poker_sim.poker_sim_cpp import equity_histogram as _cpp_equity_histogram
+    from poker_sim.poker_sim_cpp import preflop_matchup as _cpp_preflop_matchup
+    from poker_sim.poker_sim_cpp import equity_grid as _cpp_equity_grid
+except ImportError:
+    _cpp_range_equity = None
+    _cpp_analyze_outs = None
+    _cpp_classify_holdings = None
+    _cpp_hand_strength = None
+    _cpp_equity_histogram = None
+    _cpp_preflop_matchup = None
+    _cpp_equity_grid = None
 from poker_sim.hand_eval import (
     evaluate_7,
     card_str,
@@ -39,42 +56,93 @@ def equity_at_each_street(
     num_opponents: int = 1,
     num_trials: int = 5000,
     seed: Optional[int] = None,
+    dead_cards: Optional[List[int]] = None,
 ) -> dict:
     """
-    Run Monte Carlo at each street: pre-flop, flop, turn, river.
+    Run Monte Carlo at each street: pre-flop, flop, turn, river, with
+    dead_cards removed from the deck.
     For pre-flop, board=[]; flop=3 cards; turn=4; river=5.
-    Returns equity (win%+tie%/2) at each street.
+    Returns equity (pot share, splits counted 1/k) at each street.
     """
     streets = []
     trials_per = max(500, num_trials // 4)  # Divide trials across streets
 
     # Pre-flop (board empty)
     if len(board) >= 0:
-        r = run_monte_carlo(hole_cards, [], num_opponents, trials_per, seed)
-        eq = r.win_rate() + r.tie_rate() / 2
+        r = run_monte_carlo(hole_cards, [], num_opponents, trials_per, seed, dead_cards=dead_cards)
+        eq = r.equity()
         streets.append({"street": "preflop", "board_len": 0, "equity": eq, "win_pct": r.win_rate(), "tie_pct": r.tie_rate(), "loss_pct": r.loss_rate()})
 
     # Flop (3 cards)
     if len(board) >= 3:
-        r = run_monte_carlo(hole_cards, board[:3], num_opponents, trials_per, seed)
-        eq = r.win_rate() + r.tie_rate() / 2
+        r = run_monte_carlo(hole_cards, board[:3], num_opponents, trials_per, seed, dead_cards=dead_cards)
+        eq = r.equity()
         streets.append({"street": "flop", "board_len": 3, "equity": eq, "win_pct": r.win_rate(), "tie_pct": r.tie_rate(), "loss_pct": r.loss_rate()})
 
     # Turn (4 cards)
     if len(board) >= 4:
-        r = run_monte_carlo(hole_cards, board[:4], num_opponents, trials_per, seed)
-        eq = r.win_rate() + r.tie_rate() / 2
+        r = run_monte_carlo(hole_cards, board[:4], num_opponents, trials_per, seed, dead_cards=dead_cards)
+        eq = r.equity()
         streets.append({"street": "turn", "board_len": 4, "equity": eq, "win_pct": r.win_rate(), "tie_pct": r.tie_rate(), "loss_pct": r.loss_rate()})
 
     # River (5 cards)
     if len(board) >= 5:
-        r = run_monte_carlo(hole_cards, board, num_opponents, trials_per, seed)
-        eq = r.win_rate() + r.tie_rate() / 2
+        r = run_monte_carlo(hole_cards, board, num_opponents, trials_per, seed, dead_cards=dead_cards)
+        eq = r.equity()
         streets.append({"street": "river", "board_len": 5, "equity": eq, "win_pct": r.win_rate(), "tie_pct": r.tie_rate(), "loss_pct": r.loss_rate()})
 
     return {"streets": streets}
 
 
+def range_vs_range_equity(range_a: str, range_b: str, board: List[int],
+                          dead_cards: Optional[List[int]] = None) -> dict:
+    """
+    Exact equity of range A against range B on a 3-5 card board, enumerating
+    every runout (C++ engine only); dead_cards are out of play. With an empty
+    board and no dead cards it is answered from the preflop matrix
+    (POKER_SIM_PREFLOP_MATRIX; NotImplementedError when none is loaded). Ranges use standard notation, e.g.
+    "TT+,AQs+,KQo". Returns equity_a/b, win_a/b, tie, runouts and per-hand
+    equities (hands_a/hands_b, strongest first).
+    """
+    if len(board) not in (0, 3, 4, 5):
+        raise ValueError("board must have 0, 3, 4, or 5 cards")
+    if _cpp_range_equity is None:
+        raise NotImplementedError("range-vs-range equity needs the C++ extension (poker_sim_cpp)")
+    try:
+        r = _cpp_range_equity(range_a, range_b, list(board), list(dead_cards or []))
+    except RuntimeError as e:
+        raise NotImplementedError(str(e)) from e
+
+    def hands(rows):
+        out = [{"hand": card_str(c1) + card_str(c2), "equity": eq, "weight": w} for c1, c2, eq, w in rows]
+        return sorted(out, key=lambda h: -h["equity"])
+
+    return {
+        "equity_a": r["equity"][0],
+        "equity_b": r["equity"][1],
+        "win_a": r["win"][0],
+        "win_b": r["win"][1],
+        "tie": r["tie"],
+        "runouts": r["runouts"],
+        "hands_a": hands(r["hands_a"]),
+        "hands_b": hands(r["hands_b"]),
+    }
+
+
+def preflop_matchup(hand_a: str, hand_b: str = "random") -> dict:
+    """
+    Exact all-in equity of starting-hand class hand_a (e.g. "AKs", "77")
+    against class hand_b or "random", from the preflop matrix (C++ only,
+    POKER_SIM_PREFLOP_MATRIX). Returns win, tie, equity and matchups.
+    """
+    if _cpp_preflop_matchup is None:
+        raise NotImplementedError("preflop matchups need the C++ extension (poker_sim_cpp)")
+    try:
+        return _cpp_preflop_matchup(hand_a, hand_b)
+    except RuntimeError as e:
+        raise NotImplementedError(str(e)) from e
+
+
 def describe_hand(cards: List[int]) -> dict:
     """Describe hero's best 5-card hand from 5, 6, or 7 cards."""
     from itertools import combinations
@@ -99,8 +167,122 @@ def describe_hand(cards: List[int]) -> dict:
     }
 
 
-def get_potential_draws(hole_cards: List[int], board: List[int]) -> List[str]:
-    """Identify draws hero could be on (flush draw, straight draw, etc.)."""
+def outs_analysis(
+    hole_cards: List[int],
+    board: List[int],
+    opponent_range: str = "random",
+    dead_cards: Optional[List[int]] = None,
+) -> dict:
+    """
+    Classify every possible next card on a flop or turn (C++ engine only),
+    heads-up against opponent_range. Per-card lists are 52 long, indexed by
+    card: live, improves (category goes up beyond the board's), leads (beats
+    over half the range after the card), card_category, card_strength,
+    card_equity (to showdown) and improving_pairs (flop: rivers improving
+    further). Totals: category, strength, live_cards, improving, outs.
+    """
+    if len(board) not in (3, 4):
+        raise ValueError("board must have 3 or 4 cards")
+    if _cpp_analyze_outs is None:
+        raise NotImplementedError("outs analysis needs the C++ extension (poker_sim_cpp)")
+    data = _cpp_analyze_outs(list(hole_cards), list(board), opponent_range, list(dead_cards or []))
+    data["cards"] = [card_str(c) for c in range(52)]
+    return data
+
+
+def hand_strength(
+    hole_cards: List[int],
+    board: List[int],
+    dead_cards: Optional[List[int]] = None,
+    flop_runouts: int = 256,
+) -> dict:
+    """
+    Hand strength and potential against one random hand (C++ engine only):
+    hs (share beaten now), ppot / npot (chance of moving ahead / falling
+    behind by the river), ehs, ehs2 (mean squared river strength) and
+    equity. Turn and river are exact; the flop samples flop_runouts of its
+    runouts (1081 or more enumerates them all).
+    """
+    if not 3 <= len(board) <= 5:
+        raise ValueError("board must have 3 to 5 cards")
+    if _cpp_hand_strength is None:
+        raise NotImplementedError("hand strength needs the C++ extension (poker_sim_cpp)")
+    return _cpp_hand_strength(list(hole_cards), list(board), list(dead_cards or []), flop_runouts)
+
+
+def equity_histogram(
+    hole_cards: List[int],
+    board: List[int],
+    opponent_range: str = "random",
+    dead_cards: Optional[List[int]] = None,
+    bins: int = 10,
+) -> dict:
+    """
+    How hero's equity against opponent_range spreads over the coming cards,
+    exactly (C++ engine only). Flop or turn board. next_card holds the
+    fraction of next cards leaving hero's equity in each of `bins` equal
+    bins over [0, 1]; on the flop next_two_cards does the same for complete
+    runouts. equity is the mean, from the same pass.
+    """
+    if len(board) not in (3, 4):
+        raise ValueError("board must have 3 or 4 cards")
+    if _cpp_equity_histogram is None:
+        raise NotImplementedError("equity histograms need the C++ extension (poker_sim_cpp)")
+    return _cpp_equity_histogram(list(hole_cards), list(board), opponent_range, list(dead_cards or []), bins)
+
+
+def equity_grid(
+    board: List[int],
+    num_opponents: int = 1,
+    dead_cards: Optional[List[int]] = None,
+    num_trials: int = 2000,
+    seed: Optional[int] = None,
+) -> dict:
+    """
+    Equity of all 169 starting hands on a board against num_opponents random
+    hands, in one pass (C++ engine only). grid is 13 rows of 13 cells, aces
+    first: pairs on the diagonal, suited hands above it, offsuit below. Each
+    cell has hand, equity (mean over its live holdings) and holdings (0 if
+    the board blocks the hand). Heads-up postflop grids are exact; preflop
+    and multiway grids sample (or read the precomputed tables when loaded).
+    """
+    if len(board) not in (0, 3, 4, 5):
+        raise ValueError("board must have 0, 3, 4, or 5 cards")
+    if _cpp_equity_grid is None:
+        raise NotImplementedError("equity grids need the C++ extension (poker_sim_cpp)")
+    r = _cpp_equity_grid(list(board), num_opponents, num_trials, seed, list(dead_cards or []))
+    grid = [
+        [
+            {"hand": r["classes"][row * 13 + col], "equity": r["equity"][row * 13 + col],
+             "holdings": r["holdings"][row * 13 + col]}
+            for col in range(13)
+        ]
+        for row in range(13)
+    ]
+    return {"ranks": "AKQJT98765432", "grid": grid, "exact": r["exact"], "runouts": r["runouts"]}
+
+
+def get_potential_draws(
+    hole_cards: List[int], board: List[int], dead_cards: Optional[List[int]] = None
+) -> List[str]:
+    """Identify draws hero could be on (flush draw, straight draw, etc.).
+
+    With the C++ extension, counts come from outs_analysis: real improving
+    cards net of blockers and dead cards, per category, plus the cards that
+    take the lead.
+    """
+    if _cpp_analyze_outs is not None and len(board) in (3, 4):
+        data = outs_analysis(hole_cards, board, dead_cards=dead_cards)
+        by_category = {}
+        for c in range(52):
+            if data["improves"][c]:
+                cat = data["card_category"][c]
+                by_category[cat] = by_category.get(cat, 0) + 1
+        draws = [f"{HAND_NAMES[cat]} ({n} outs)" for cat, n in sorted(by_category.items(), reverse=True)]
+        if data["strength"] < 0.5 and data["outs"]:
+            draws.append(f"Behind a random hand: {data['outs']} cards take the lead")
+        return draws
+
     from poker_sim.hand_eval import rank, suit
     from collections import Counter
     draws = []
@@ -133,9 +315,49 @@ def hands_that_beat(hero_hand_type: int) -> List[str]:
     return stronger
 
 
-def possible_hands_that_beat(hole_cards: List[int], board: List[int]) -> List[str]:
+def holdings_vs_hero(
+    hole_cards: List[int],
+    board: List[int],
+    dead_cards: Optional[List[int]] = None,
+) -> dict:
+    """
+    Rank every opponent holding left after hole cards, board (3-5 cards) and
+    dead cards against hero's current hand (C++ engine only). Returns
+    ahead / tied / behind lists of (card_high, card_low, category), strongest
+    first, per-category counts keyed by hand name, and percentile: the share
+    of holdings hero beats, ties counted half.
+    """
+    if not 3 <= len(board) <= 5:
+        raise ValueError("board must have 3 to 5 cards")
+    if _cpp_classify_holdings is None:
+        raise NotImplementedError("holding enumeration needs the C++ extension (poker_sim_cpp)")
+    data = _cpp_classify_holdings(list(hole_cards), list(board), list(dead_cards or []))
+    for key in ("ahead_by_category", "tied_by_category", "behind_by_category"):
+        data[key] = {HAND_NAMES[cat]: n for cat, n in enumerate(data[key]) if n}
+    return data
+
+
+def beating_categories(holdings: dict) -> List[str]:
+    """Hand types of the holdings ahead of hero in a holdings_vs_hero result,
+    with their combo counts ("Flush (12 combos)"), strongest first."""
+    counts = {}
+    for _, _, cat in holdings["ahead"]:
+        counts[cat] = counts.get(cat, 0) + 1
+    return [f"{HAND_NAMES[cat]} ({n} combos)" for cat, n in sorted(counts.items(), reverse=True)]
+
+
+def possible_hands_that_beat(
+    hole_cards: List[int], board: List[int], dead_cards: Optional[List[int]] = None
+) -> List[str]:
     """Return hand types that could actually beat hero given hero's cards and board.
-    Filters out impossible hands based on deck/board constraints."""
+
+    With the C++ extension these come from an exact enumeration of opponent
+    holdings ("Flush (12 combos)", strongest first); otherwise from
+    feasibility rules over the deck/board constraints.
+    """
+    if _cpp_classify_holdings is not None and 3 <= len(board) <= 5:
+        return beating_categories(holdings_vs_hero(hole_cards, board, dead_cards))
+
     from poker_sim.hand_eval import rank, suit
     from collections import Counter
     all_known = list(hole_cards) + list(board)
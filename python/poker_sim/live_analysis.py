@@ -21,23 +21,27 @@ def hand_distribution_and_win(
     num_opponents: int = 1,
     num_trials: int = 5000,
     seed: Optional[int] = None,
+    dead_cards: Optional[List[int]] = None,
 ) -> Dict:
     """
     With hole_cards + board (any valid combo), run Monte Carlo and also sample
     hand type distribution (what hands hero makes over random board completions).
+    dead_cards (folded or exposed) are removed from the deck.
     """
     if len(hole_cards) != 2:
         return {"error": "Need exactly 2 hole cards"}
     if len(board) not in (0, 1, 2, 3, 4, 5):
         return {"error": "Board must have 0-5 cards"}
 
-    used = set(hole_cards) | set(board)
-    if len(used) != len(hole_cards) + len(board):
+    dead_cards = list(dead_cards or [])
+    used = set(hole_cards) | set(board) | set(dead_cards)
+    if len(used) != len(hole_cards) + len(board) + len(dead_cards):
         return {"error": "Overlapping cards"}
 
     rng = random.Random(seed)
     hand_counts: Counter = Counter()
     wins = ties = losses = 0
+    pot_share = 0.0
 
     for _ in range(num_trials):
         deck = [c for c in range(52) if c not in used]
@@ -58,22 +62,24 @@ def hand_distribution_and_win(
         hand_type, _ = evaluate_7(hero_7)
         hand_counts[hand_type] += 1
 
-        hero_value = 1
+        split = 1
         for opp in opp_hands:
             opp_hand = opp + board_final
             from poker_sim.hand_eval import compare_hands
             cmp = compare_hands(hero_7, opp_hand)
             if cmp < 0:
-                hero_value = -1
+                split = 0
                 break
             if cmp == 0:
-                hero_value = 0
-        if hero_value > 0:
-            wins += 1
-        elif hero_value < 0:
+                split += 1
+        if split == 0:
             losses += 1
+        elif split == 1:
+            wins += 1
         else:
             ties += 1
+        if split:
+            pot_share += 1 / split
 
     dist = {HAND_NAMES.get(ht, f"Type{ht}"): count / num_trials for ht, count in hand_counts.most_common()}
     best_hand_type = max(hand_counts.keys()) if hand_counts else -1
@@ -84,7 +90,7 @@ def hand_distribution_and_win(
         "loss_pct": losses / num_trials,
         "hand_distribution": dist,
         "best_possible_hand": HAND_NAMES.get(best_hand_type, "Unknown"),
-        "equity": wins / num_trials + (ties / num_trials) / 2,
+        "equity": pot_share / num_trials,
     }
 
 
@@ -93,9 +99,10 @@ def live_analysis(
     num_opponents: int = 1,
     num_trials: int = 3000,
     seed: Optional[int] = None,
+    dead_cards: Optional[List[int]] = None,
 ) -> Dict:
     """
-    Analyze any number of cards (1-7).
+    Analyze any number of cards (1-7); dead_cards are out of the deck.
     Convention: first 2 = hole, rest = board.
     - 1 card: not enough for sim; return card info only
     - 2 cards: assume hole cards, run preflop sim + hand distribution over random boards
@@ -125,7 +132,7 @@ def live_analysis(
     if len(board) not in (0, 1, 2, 3, 4, 5):
         return {"error": "Invalid card count", "win_pct": 0, "tie_pct": 0, "loss_pct": 0}
 
-    result = hand_distribution_and_win(hole, board, num_opponents, num_trials, seed)
+    result = hand_distribution_and_win(hole, board, num_opponents, num_trials, seed, dead_cards)
 
     if "error" in result:
         return result
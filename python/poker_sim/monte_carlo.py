@@ -4,15 +4,64 @@ Given hero hole cards, optional board, and number of opponents, estimates win/ti
 Uses C++ extension when built for ~10-50x speedup.
 """
 
+import os
 import random
+import warnings
 from typing import List, Optional
 
 try:
     from poker_sim.poker_sim_cpp import run_monte_carlo as _cpp_run
+    from poker_sim.poker_sim_cpp import run_monte_carlo_ranges as _cpp_run_ranges
+    from poker_sim.poker_sim_cpp import multiway_equity as _cpp_multiway
+    from poker_sim.poker_sim_cpp import POT_SHARE_UNIT as _POT_SHARE_UNIT
+    from poker_sim.poker_sim_cpp import load_flop_equity_table as _cpp_load_flop_equity
+    from poker_sim.poker_sim_cpp import load_preflop_matrix as _cpp_load_preflop_matrix
 except ImportError:
     _cpp_run = None
+    _cpp_run_ranges = None
+    _cpp_multiway = None
+    _cpp_load_flop_equity = None
+    _cpp_load_preflop_matrix = None
 
-from poker_sim.hand_eval import compare_hands
+# Precomputed flop equities (built by poker_sim_flop_equity) answer flop spots
+# with 1-3 opponents and no dead cards exactly, without sampling.
+_FLOP_EQUITY_PATH = os.environ.get("POKER_SIM_FLOP_EQUITY")
+if _FLOP_EQUITY_PATH and _cpp_load_flop_equity is not None:
+    try:
+        _cpp_load_flop_equity(_FLOP_EQUITY_PATH)
+    except RuntimeError as e:
+        warnings.warn(f"flop equity table not loaded: {e}")
+
+# The precomputed preflop matrix (poker_sim_preflop_matrix) answers heads-up
+# preflop spots and preflop range-vs-range equity exactly.
+_PREFLOP_MATRIX_PATH = os.environ.get("POKER_SIM_PREFLOP_MATRIX")
+if _PREFLOP_MATRIX_PATH and _cpp_load_preflop_matrix is not None:
+    try:
+        _cpp_load_preflop_matrix(_PREFLOP_MATRIX_PATH)
+    except RuntimeError as e:
+        warnings.warn(f"preflop matrix not loaded: {e}")
+
+from poker_sim.hand_eval import compare_hands, evaluate_7
+
+SAMPLERS = ("iid", "stratified", "antithetic", "lhs", "sobol", "sobol_scrambled")
+
+
+def _from_cpp(r, num_trials: int) -> "SimResult":
+    from poker_sim.types import SimResult
+    splits = {k: n for k, n in enumerate(r.split_ways) if n}
+    return SimResult(wins=r.wins, ties=r.ties, losses=r.losses, total=num_trials,
+                     effective_samples=r.effective_samples,
+                     pot_share=r.pot_share / _POT_SHARE_UNIT, split_ways=splits, exact=r.exact)
+
+
+def _check_dead_cards(dead_cards: Optional[List[int]], used: set) -> List[int]:
+    """Validate dead cards against the known ones; returns them as a list."""
+    dead_cards = list(dead_cards or [])
+    if any(c < 0 or c > 51 for c in dead_cards):
+        raise ValueError("dead card index out of range 0-51")
+    if len(set(dead_cards)) != len(dead_cards) or used & set(dead_cards):
+        raise ValueError("dead cards must be distinct and not overlap hole_cards or board")
+    return dead_cards
 
 
 def run_monte_carlo(
@@ -21,6 +70,9 @@ def run_monte_carlo(
     num_opponents: int = 1,
     num_trials: int = 10000,
     seed: Optional[int] = None,
+    sampler: str = "iid",
+    opponent_ranges: Optional[List[str]] = None,
+    dead_cards: Optional[List[int]] = None,
 ) -> "SimResult":
     """
     Run Monte Carlo simulation.
@@ -31,10 +83,23 @@ def run_monte_carlo(
         num_opponents: Number of opponents (1–8).
         num_trials: Number of trials.
         seed: Optional RNG seed for reproducibility.
+        sampler: Deal sampler (C++ engine only; the Python fallback is always iid):
+            "iid", "stratified" (equal trials per board runout), "antithetic"
+            (mirrored deal pairs), "lhs" (Latin hypercube), "sobol" (quasi-Monte
+            Carlo, deterministic) or "sobol_scrambled" (randomly shifted Sobol).
+        opponent_ranges: Optional hand ranges in standard notation (e.g.
+            "TT+,AQs+,KQo", "77-99:0.5", "random"), one per opponent or a single
+            range for all of them. Needs the C++ engine and the iid sampler.
+        dead_cards: Folded or exposed cards, removed from the deck.
 
     Returns:
-        SimResult with wins, ties, losses, total, win_rate(), tie_rate(), loss_rate().
+        SimResult with wins, ties, losses, total, effective_samples, pot_share,
+        split_ways, win_rate(), tie_rate(), loss_rate() and equity() (pot share,
+        a k-way split counting 1/k). exact is True when a flop spot was answered
+        from the flop equity table (POKER_SIM_FLOP_EQUITY) instead of sampled.
     """
+    if sampler not in SAMPLERS:
+        raise ValueError(f"sampler must be one of {', '.join(SAMPLERS)}")
     if board is None:
         board = []
     if len(hole_cards) != 2:
@@ -46,18 +111,33 @@ def run_monte_carlo(
     used = set(hole_cards) | set(board)
     if len(used) != len(hole_cards) + len(board):
         raise ValueError("hole_cards and board must not overlap")
+    dead_cards = _check_dead_cards(dead_cards, used)
+    used |= set(dead_cards)
     deck_size = 52 - len(used)
     need_per_trial = 5 - len(board) + num_opponents * 2  # remaining board + each opponent's 2
     if     need_per_trial > deck_size:
         raise ValueError("not enough cards in deck for this configuration")
 
+    if opponent_ranges:
+        if len(opponent_ranges) == 1:
+            opponent_ranges = list(opponent_ranges) * num_opponents
+        if len(opponent_ranges) != num_opponents:
+            raise ValueError("opponent_ranges must have one range, or one per opponent")
+        if sampler != "iid":
+            raise ValueError("opponent_ranges only supports the iid sampler")
+        if _cpp_run_ranges is None:
+            raise NotImplementedError("opponent ranges need the C++ extension (poker_sim_cpp)")
+        r = _cpp_run_ranges(hole_cards, board, list(opponent_ranges), num_trials, seed, dead_cards)
+        return _from_cpp(r, num_trials)
+
     if _cpp_run is not None:
-        r = _cpp_run(hole_cards, board, num_opponents, num_trials, seed)
-        from poker_sim.types import SimResult
-        return SimResult(wins=r.wins, ties=r.ties, losses=r.losses, total=num_trials)
+        r = _cpp_run(hole_cards, board, num_opponents, num_trials, seed, sampler, dead_cards)
+        return _from_cpp(r, num_trials)
 
     rng = random.Random(seed)
     wins = ties = losses = 0
+    pot_share = 0.0
+    split_ways = {}
 
     for _ in range(num_trials):
         deck = [c for c in range(52) if c not in used]
@@ -74,29 +154,117 @@ def run_monte_carlo(
             opp_hands.append([deck[idx], deck[idx + 1]])
             idx += 2
         hero_hand = list(hole_cards) + board_final
-        hero_value = 1  # assume win until we lose or tie
+        split = 1  # players sharing the pot with hero; 0 once hero loses
         for opp in opp_hands:
             opp_hand = opp + board_final
             cmp = compare_hands(hero_hand, opp_hand)
             if cmp < 0:
-                hero_value = -1
+                split = 0
                 break  # loss: at least one opponent beats us
             if cmp == 0:
-                hero_value = 0  # tie: at least one opponent ties us (split pot)
-        if hero_value > 0:
-            wins += 1
-        elif hero_value < 0:
+                split += 1  # tie: this opponent splits the pot with us
+        if split == 0:
             losses += 1
+            continue
+        pot_share += 1 / split
+        if split == 1:
+            wins += 1
         else:
             ties += 1
+            split_ways[split] = split_ways.get(split, 0) + 1
 
     from poker_sim.types import SimResult
-    return SimResult(wins=wins, ties=ties, losses=losses, total=num_trials)
+    return SimResult(wins=wins, ties=ties, losses=losses, total=num_trials,
+                     pot_share=pot_share, split_ways=split_ways)
+
 
+def multiway_equity(
+    hands: List[List[int]],
+    board: Optional[List[int]] = None,
+    dead_cards: Optional[List[int]] = None,
+    num_trials: int = 20000,
+    seed: Optional[int] = None,
+) -> dict:
+    """
+    All-in equity between 2–9 players with known hole cards.
 
-def get_suggested_action(win_pct: float, tie_pct: float) -> str:
-    """Return suggested action: Raise, Bet, Check, or Check / Fold."""
-    equity = win_pct + tie_pct / 2
+    Every runout is enumerated when there are at most num_trials of them
+    (always on the flop, turn and river); otherwise num_trials runouts are
+    sampled. A k-way split gives each winner 1/k of the pot.
+
+    Args:
+        hands: One [card, card] pair per player.
+        board: 0, 3, 4, or 5 card indices.
+        dead_cards: Cards known to be out of the deck (e.g. folded hands).
+        num_trials: Enumeration limit and sample count.
+        seed: Optional RNG seed for the sampled case.
+
+    Returns:
+        dict with per-player lists equity, win, tie, plus runouts and exact.
+    """
+    from itertools import combinations
+    from math import comb
+    board = list(board or [])
+    dead = list(dead_cards or [])
+    if not (2 <= len(hands) <= 9):
+        raise ValueError("need 2-9 players")
+    if any(len(h) != 2 for h in hands):
+        raise ValueError("every player needs exactly 2 hole cards")
+    if len(board) not in (0, 3, 4, 5):
+        raise ValueError("board must have 0, 3, 4, or 5 cards")
+    known = [c for h in hands for c in h] + board + dead
+    if any(c < 0 or c > 51 for c in known):
+        raise ValueError("card index out of range 0-51")
+    if len(set(known)) != len(known):
+        raise ValueError("hands, board and dead cards must not overlap")
+    deck = [c for c in range(52) if c not in set(known)]
+    need = 5 - len(board)
+    if need > len(deck):
+        raise ValueError("not enough cards in deck for this configuration")
+
+    if _cpp_multiway is not None:
+        return _cpp_multiway([list(h) for h in hands], board, dead, num_trials, seed)
+
+    n = len(hands)
+    share = [0.0] * n
+    win = [0] * n
+    tie = [0] * n
+    exact = comb(len(deck), need) <= num_trials
+    if exact:
+        runouts = combinations(deck, need)
+    else:
+        rng = random.Random(seed)
+        runouts = (rng.sample(deck, need) for _ in range(num_trials))
+    count = 0
+    for runout in runouts:
+        full = board + list(runout)
+        values = [evaluate_7(list(h) + full) for h in hands]
+        best = max(values)
+        winners = [p for p in range(n) if values[p] == best]
+        for p in winners:
+            share[p] += 1 / len(winners)
+            if len(winners) == 1:
+                win[p] += 1
+            else:
+                tie[p] += 1
+        count += 1
+    return {
+        "equity": [x / count for x in share],
+        "win": [x / count for x in win],
+        "tie": [x / count for x in tie],
+        "runouts": count,
+        "exact": exact,
+    }
+
+
+def get_suggested_action(win_pct: float, tie_pct: float, equity: Optional[float] = None) -> str:
+    """Return suggested action: Raise, Bet, Check, or Check / Fold.
+
+    Pass equity (SimResult.equity()) when known; win_pct + tie_pct / 2 is only
+    exact heads-up, since a k-way split is worth 1/k of the pot.
+    """
+    if equity is None:
+        equity = win_pct + tie_pct / 2
     if equity >= 0.65:
         return "Raise"
     if equity >= 0.50:
@@ -106,9 +274,10 @@ def get_suggested_action(win_pct: float, tie_pct: float) -> str:
     return "Check / Fold"
 
 
-def get_strategy_message(win_pct: float, tie_pct: float) -> str:
-    """Simple EV-oriented message for the UI."""
-    equity = win_pct + tie_pct / 2
+def get_strategy_message(win_pct: float, tie_pct: float, equity: Optional[float] = None) -> str:
+    """Simple EV-oriented message for the UI (equity as in get_suggested_action)."""
+    if equity is None:
+        equity = win_pct + tie_pct / 2
     if equity >= 0.65:
         return "Strong equity — consider betting or raising for value."
     if equity >= 0.50:
@@ -0,0 +1,35 @@
+"""
+Self-play: complete no-limit hands between bot policies, played by the C++
+engine to stress-test strategies against each other.
+"""
+
+from typing import List, Optional
+
+try:
+    from poker_sim.poker_sim_cpp import self_play as _cpp_self_play
+except ImportError:
+    _cpp_self_play = None
+
+BOTS = ["station", "maniac", "random", "rock", "tag", "lag"]
+
+
+def self_play(
+    bots: List[str],
+    num_hands: int = 100000,
+    stack: float = 100.0,
+    stacks: Optional[List[float]] = None,
+    small_blind: float = 0.5,
+    seed: Optional[int] = None,
+    num_threads: Optional[int] = None,
+) -> dict:
+    """
+    Play num_hands independent no-limit hands between built-in bots, one per
+    seat (2-9; see BOTS), with the blinds at small_blind and 1 (C++ engine
+    only). Every hand starts from stack big blinds per seat, or stacks per
+    seat, and the button moves one seat per hand. Returns seats (bot,
+    bb_per_100, ci95 (half-width of its 95% confidence interval) and won, in
+    big blinds) and hands.
+    """
+    if _cpp_self_play is None:
+        raise NotImplementedError("self-play needs the C++ extension (poker_sim_cpp)")
+    return _cpp_self_play(list(bots), num_hands, stack, list(stacks or []), small_blind, seed, num_threads or 0)
@@ -0,0 +1,129 @@
+"""
+Tournament play: ICM prize equity, and push/fold (jam-or-fold) equilibria in
+chips or ICM dollars, solved by the C++ engine from the precomputed preflop
+matrix (POKER_SIM_PREFLOP_MATRIX).
+"""
+
+from typing import List, Optional
+
+# Importing monte_carlo loads the preflop matrix named by POKER_SIM_PREFLOP_MATRIX.
+import poker_sim.monte_carlo  # noqa: F401
+
+try:
+    from poker_sim.poker_sim_cpp import push_fold as _cpp_push_fold
+    from poker_sim.poker_sim_cpp import push_fold_charts as _cpp_push_fold_charts
+    from poker_sim.poker_sim_cpp import icm_equity as _cpp_icm_equity
+except ImportError:
+    _cpp_push_fold = None
+    _cpp_push_fold_charts = None
+    _cpp_icm_equity = None
+
+RANKS = "AKQJT98765432"
+
+
+def _class_combos(row: int, col: int) -> int:
+    """Holdings of a grid cell: 6 per pair, 4 suited (above the diagonal), 12 offsuit."""
+    return 6 if row == col else 4 if col > row else 12
+
+
+def positions(players: int) -> List[str]:
+    """Seat names in action order, blinds last (heads-up: SB, BB)."""
+    back = ["BB", "SB", "BTN", "CO", "HJ", "LJ"][: players if players >= 7 else min(players, 5)]
+    front = ["UTG" if i == 0 else f"UTG+{i}" for i in range(players - len(back))]
+    return front + back[::-1]
+
+
+def _chart(probs: List[float]) -> dict:
+    """13x13 grid of one decision's per-class probabilities and the share of all hands it plays."""
+    grid = [[probs[row * 13 + col] for col in range(13)] for row in range(13)]
+    played = sum(grid[r][c] * _class_combos(r, c) for r in range(13) for c in range(13))
+    return {"grid": grid, "percent": 100.0 * played / 1326}
+
+
+def _charts(r: dict, stacks: List[float], payouts: Optional[List[float]]) -> dict:
+    n = len(stacks)
+    names = positions(n)
+    jam = [{"position": names[p], **_chart(r["jam"][p])} for p in range(n - 1)]
+    call = [
+        {"position": names[q], "versus": names[p], **_chart(r["call"][q][p])}
+        for p in range(n - 1)
+        for q in range(p + 1, n)
+    ]
+    return {
+        "ranks": RANKS,
+        "positions": names,
+        "stacks": list(stacks),
+        "jam": jam,
+        "call": call,
+        "ev": list(r["ev"]),
+        "icm": icm_equity(stacks, payouts)["equity"] if payouts else None,
+        "exploitability": r["exploitability"],
+        "iterations": r["iterations"],
+    }
+
+
+def _require_extension() -> None:
+    if _cpp_push_fold is None:
+        raise NotImplementedError("push/fold needs the C++ extension (poker_sim_cpp)")
+
+
+def icm_equity(
+    stacks: List[float],
+    payouts: List[float],
+    num_trials: int = 20000,
+    seed: Optional[int] = None,
+) -> dict:
+    """
+    Malmuth-Harville ICM prize equity of each player (C++ engine only):
+    payouts[k] is the prize for place k + 1. Exact up to 20 players with chips;
+    larger fields sample num_trials finishing orders. Returns equity (per
+    player, in payout units), exact and trials.
+    """
+    if _cpp_icm_equity is None:
+        raise NotImplementedError("ICM needs the C++ extension (poker_sim_cpp)")
+    return _cpp_icm_equity(list(stacks), list(payouts), num_trials, seed)
+
+
+def push_fold(
+    stacks: List[float],
+    ante: float = 0.0,
+    small_blind: float = 0.5,
+    payouts: Optional[List[float]] = None,
+    max_iterations: int = 2000,
+    tolerance: float = 1e-4,
+) -> dict:
+    """
+    Push/fold equilibrium for stacks in big blinds, in action order with the
+    blinds last (C++ engine and preflop matrix only). Returns a jam chart for
+    each seat that can open and a call chart for each seat facing each jammer
+    (13x13 grids of probabilities, aces first, suited above the diagonal,
+    with the percent of hands played), ev per seat and exploitability (what a
+    seat could gain per hand by deviating). With payouts the players play for
+    ICM prize equity: ev is each seat's expected change in it ($EV) and icm
+    its equity before the hand; otherwise ev is in big blinds.
+    """
+    _require_extension()
+    try:
+        r = _cpp_push_fold(list(stacks), small_blind, ante, list(payouts or []), max_iterations, tolerance)
+    except RuntimeError as e:
+        raise NotImplementedError(str(e)) from e
+    return _charts(r, stacks, payouts)
+
+
+def push_fold_charts(
+    depths: List[float],
+    players: int = 2,
+    ante: float = 0.0,
+    payouts: Optional[List[float]] = None,
+    max_iterations: int = 2000,
+    tolerance: float = 1e-4,
+    num_threads: Optional[int] = None,
+) -> List[dict]:
+    """push_fold for players equal stacks at each depth (big blinds), solved in parallel."""
+    _require_extension()
+    try:
+        rs = _cpp_push_fold_charts(list(depths), players, ante, list(payouts or []), max_iterations, tolerance,
+                                   num_threads or 0)
+    except RuntimeError as e:
+        raise NotImplementedError(str(e)) from e
+    return [_charts(r, [d] * players, payouts) for r, d in zip(rs, depths)]
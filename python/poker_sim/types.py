@@ -4,13 +4,26 @@
 class SimResult:
     """Result of a Monte Carlo simulation run."""
 
-    __slots__ = ("wins", "ties", "losses", "total")
+    __slots__ = ("wins", "ties", "losses", "total", "effective_samples", "pot_share", "split_ways", "exact")
 
-    def __init__(self, wins: int, ties: int, total: int, losses: int = 0):
+    def __init__(self, wins: int, ties: int, total: int, losses: int = 0, effective_samples: float = None,
+                 pot_share: float = None, split_ways: dict = None, exact: bool = False):
         self.wins = wins
         self.ties = ties
         self.losses = losses if losses else (total - wins - ties)
         self.total = total
+        # i.i.d.-equivalent trial count; above total for variance-reduced samplers
+        self.effective_samples = float(total) if effective_samples is None else effective_samples
+        # pots won, with a k-way split counting 1/k (ties/2 when unknown)
+        self.pot_share = wins + ties / 2 if pot_share is None else pot_share
+        # {k: trials where the pot was split k ways}
+        self.split_ways = split_ways or {}
+        # counts are exact proportions from the flop equity table, not samples
+        self.exact = exact
+
+    def equity(self) -> float:
+        """Mean fraction of the pot won; exact for multiway splits."""
+        return self.pot_share / self.total if self.total else 0.0
 
     def win_rate(self) -> float:
         return self.wins / self.total if self.total else 0.0
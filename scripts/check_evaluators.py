@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Cross-check the Python hand evaluator against the C++ extension.
+
+Enumerates all 2,598,960 five-card hands through python/poker_sim/hand_eval.py
+and checks category frequencies against the known totals, then compares packed
+ranks with poker_sim_cpp.evaluate_hand on every 5-card hand and on random 7-card
+hands. The exhaustive 7-card check lives in the C++ harness (poker_sim_verify_eval).
+
+Usage: python scripts/check_evaluators.py [--samples N] [--seed S]
+"""
+import argparse
+import random
+import sys
+import time
+from itertools import combinations
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "python"))
+
+from poker_sim.hand_eval import _evaluate_5, evaluate_7  # noqa: E402
+
+try:
+    from poker_sim.poker_sim_cpp import evaluate_hand as cpp_evaluate_hand
+except ImportError:
+    cpp_evaluate_hand = None
+
+EXPECTED_5 = [1302540, 1098240, 123552, 54912, 10200, 5108, 3744, 624, 40]
+
+
+def pack(hand_type, tiebreaker):
+    """Python (type, tiebreaker) -> the C++ packed HandRank layout."""
+    tb = list(tiebreaker) + [0] * (5 - len(tiebreaker))
+    value = hand_type
+    for r in tb[:5]:
+        value = (value << 4) | r
+    return value
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--samples", type=int, default=200000, help="random 7-card hands to compare")
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+    if cpp_evaluate_hand is None:
+        print("C++ extension not built; checking Python frequencies only")
+
+    ok = True
+    freq = [0] * 9
+    mismatches = 0
+    t0 = time.perf_counter()
+    for five in combinations(range(52), 5):
+        hand_type, tb = _evaluate_5(list(five))
+        freq[hand_type] += 1
+        if cpp_evaluate_hand is not None and cpp_evaluate_hand(list(five)) != pack(hand_type, tb):
+            if mismatches < 5:
+                print(f"  5-card mismatch: {five}")
+            mismatches += 1
+    elapsed = time.perf_counter() - t0
+    print(f"5-card: {sum(freq)} hands in {elapsed:.1f}s, frequencies {'OK' if freq == EXPECTED_5 else 'MISMATCH'}")
+    if freq != EXPECTED_5:
+        ok = False
+        print(f"  got {freq}\n  expected {EXPECTED_5}")
+
+    if cpp_evaluate_hand is not None:
+        rng = random.Random(args.seed)
+        deck = list(range(52))
+        for _ in range(args.samples):
+            seven = rng.sample(deck, 7)
+            if cpp_evaluate_hand(seven) != pack(*evaluate_7(seven)):
+                if mismatches < 5:
+                    print(f"  7-card mismatch: {seven}")
+                mismatches += 1
+        print(f"7-card: {args.samples} random hands compared")
+        print(f"mismatches: {mismatches}")
+        ok = ok and mismatches == 0
+
+    print("PASS" if ok else "FAIL")
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
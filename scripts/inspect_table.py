@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Inspect a precomputed table file (bucket, flop equity, preflop matrix, ...).
+
+Prints the container header (format version, table kind and version, index
+scheme, kind parameters) and the section directory. --verify recomputes the
+header and section CRC-32s, inflating compressed sections, and exits non-zero
+on a mismatch. --dump NAME prints the first values of a section, as uint16
+or (--float) float32.
+The layout is documented in cpp/include/poker_sim/table_file.hpp.
+
+Usage: python scripts/inspect_table.py FILE [--verify] [--dump NAME [--float]] [--count N]
+"""
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b"PSTABLE\0"
+PAGE = 4096
+DIRECTORY_OFFSET = 128
+HEADER = struct.Struct("<8sIIII4I4QII")
+ENTRY = struct.Struct("<24sQQQIIQ")
+KINDS = {1: "buckets", 2: "flop_equity", 3: "preflop_matrix"}
+COMPRESSION = {0: "stored", 1: "zlib blocks"}
+
+
+def read_header(data):
+    if len(data) < PAGE or data[:8] != MAGIC:
+        raise ValueError("not a table file")
+    fields = HEADER.unpack_from(data, 0)
+    header = {
+        "format_version": fields[1],
+        "kind": fields[2],
+        "kind_version": fields[3],
+        "cards_per_round": list(fields[5:5 + fields[4]]),
+        "params": list(fields[9:13]),
+        "section_count": fields[13],
+        "crc": fields[14],
+    }
+    sections = []
+    for i in range(header["section_count"]):
+        name, offset, stored, size, compression, crc, _ = ENTRY.unpack_from(data, DIRECTORY_OFFSET + i * ENTRY.size)
+        sections.append({
+            "name": name.rstrip(b"\0").decode(),
+            "offset": offset,
+            "stored_bytes": stored,
+            "bytes": size,
+            "compression": compression,
+            "crc": crc,
+        })
+    return header, sections
+
+
+def header_crc(data, section_count):
+    head = bytearray(data[:HEADER.size])
+    head[HEADER.size - 4:] = b"\0\0\0\0"
+    crc = zlib.crc32(bytes(head))
+    return zlib.crc32(data[DIRECTORY_OFFSET:DIRECTORY_OFFSET + section_count * ENTRY.size], crc)
+
+
+def section_bytes(data, section):
+    stored = data[section["offset"]:section["offset"] + section["stored_bytes"]]
+    if section["compression"] == 0:
+        return stored
+    block_bytes, blocks = struct.unpack_from("<QQ", stored, 0)
+    ends = struct.unpack_from(f"<{blocks}Q", stored, 16)
+    streams = stored[16 + 8 * blocks:]
+    out, begin = [], 0
+    for end in ends:
+        out.append(zlib.decompress(streams[begin:end]))
+        begin = end
+    return b"".join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("path")
+    ap.add_argument("--verify", action="store_true", help="check header and section CRC-32s")
+    ap.add_argument("--dump", metavar="NAME", help="print the first values of a section as uint16")
+    ap.add_argument("--float", action="store_true", help="read --dump values as float32")
+    ap.add_argument("--count", type=int, default=16, help="values to print with --dump")
+    args = ap.parse_args()
+
+    with open(args.path, "rb") as f:
+        data = f.read()
+    try:
+        header, sections = read_header(data)
+    except (ValueError, struct.error) as e:
+        print(f"{args.path}: {e}", file=sys.stderr)
+        return 1
+
+    print(f"{args.path}: {len(data):,} bytes")
+    print(f"  format version {header['format_version']}")
+    print(f"  kind           {KINDS.get(header['kind'], 'unknown')} ({header['kind']}), version {header['kind_version']}")
+    print(f"  index scheme   {header['cards_per_round'] or 'none'}")
+    print(f"  params         {header['params']}")
+    for s in sections:
+        ratio = s["stored_bytes"] / s["bytes"] if s["bytes"] else 1.0
+        print(f"  section {s['name']!r}: {s['bytes']:,} bytes at {s['offset']:#x}, "
+              f"{COMPRESSION.get(s['compression'], 'unknown')} ({ratio:.0%}), crc {s['crc']:#010x}")
+
+    failed = False
+    if args.verify:
+        if header_crc(data, header["section_count"]) != header["crc"]:
+            print("  header: CRC MISMATCH")
+            failed = True
+        for s in sections:
+            body = section_bytes(data, s)
+            ok = len(body) == s["bytes"] and zlib.crc32(body) == s["crc"]
+            print(f"  section {s['name']!r}: {'ok' if ok else 'CRC MISMATCH'}")
+            failed |= not ok
+
+    if args.dump:
+        match = [s for s in sections if s["name"] == args.dump]
+        if not match:
+            print(f"no section {args.dump!r}", file=sys.stderr)
+            return 1
+        body = section_bytes(data, match[0])
+        code, size = ("f", 4) if args.float else ("H", 2)
+        n = min(args.count, len(body) // size)
+        print(f"  {args.dump}[:{n}] = {list(struct.unpack_from(f'<{n}{code}', body, 0))}")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,149 @@
+import { useEffect, useState } from 'react'
+import { apiUrl } from '../lib/api'
+import './PushFoldChart.css'
+
+interface Chart {
+  position: string
+  versus?: string
+  grid: number[][]
+  percent: number
+}
+
+interface PushFoldData {
+  ranks: string
+  positions: string[]
+  jam: Chart[]
+  call: Chart[]
+  ev: number[]
+  icm: number[] | null
+  exploitability: number
+  elapsed_ms?: number
+}
+
+function handName(ranks: string, row: number, col: number): string {
+  if (row === col) return ranks[row] + ranks[row]
+  return row < col ? `${ranks[row]}${ranks[col]}s` : `${ranks[col]}${ranks[row]}o`
+}
+
+/** Prize structures to play for; chips when empty (percent of the prize pool otherwise). */
+const PAYOUTS: Record<string, number[]> = {
+  Chips: [],
+  'ICM 50/30/20': [50, 30, 20],
+  'ICM 65/35': [65, 35],
+  'ICM 100': [100],
+}
+
+/** Jam/call charts of the push/fold equilibrium for equal stacks, re-solved as the inputs change. */
+export default function PushFoldChart() {
+  const [players, setPlayers] = useState(2)
+  const [depth, setDepth] = useState(10)
+  const [ante, setAnte] = useState(0)
+  const [prizes, setPrizes] = useState('Chips')
+  const [data, setData] = useState<PushFoldData | null>(null)
+  const [selected, setSelected] = useState(0)
+  const [error, setError] = useState<string | null>(null)
+
+  useEffect(() => {
+    let cancelled = false
+    const timer = setTimeout(() => {
+      fetch(apiUrl('/api/push-fold'), {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify({ stacks: Array(players).fill(depth), ante, payouts: PAYOUTS[prizes] }),
+      })
+        .then(async (res) => {
+          if (!res.ok) throw new Error((await res.json().catch(() => ({}))).detail || 'Push/fold solve failed')
+          return res.json()
+        })
+        .then((d: PushFoldData) => {
+          if (cancelled) return
+          setData(d)
+          setError(null)
+        })
+        .catch((e) => {
+          if (!cancelled) setError(e instanceof Error ? e.message : 'Request failed')
+        })
+    }, 150)
+    return () => {
+      cancelled = true
+      clearTimeout(timer)
+    }
+  }, [players, depth, ante, prizes])
+
+  const charts = data ? [...data.jam, ...data.call] : []
+  const chart = charts[Math.min(selected, charts.length - 1)]
+
+  return (
+    <div className="push-fold">
+      <h3>Push/fold equilibrium</h3>
+      <p className="push-fold-desc">Jam-or-fold ranges at equal stacks. Darker cells are played more often.</p>
+      <div className="push-fold-controls">
+        <label>
+          Players{' '}
+          <select value={players} onChange={(e) => { setPlayers(Number(e.target.value)); setSelected(0) }}>
+            {[2, 3, 4, 5, 6, 7, 8, 9].map((n) => (
+              <option key={n} value={n}>{n}</option>
+            ))}
+          </select>
+        </label>
+        <label>
+          Stack {depth} bb{' '}
+          <input type="range" min={1} max={25} step={0.5} value={depth} onChange={(e) => setDepth(Number(e.target.value))} />
+        </label>
+        <label>
+          Ante{' '}
+          <select value={ante} onChange={(e) => setAnte(Number(e.target.value))}>
+            {[0, 0.1, 0.125, 0.2].map((a) => (
+              <option key={a} value={a}>{a} bb</option>
+            ))}
+          </select>
+        </label>
+        <label>
+          Play for{' '}
+          <select value={prizes} onChange={(e) => setPrizes(e.target.value)}>
+            {Object.keys(PAYOUTS).map((k) => (
+              <option key={k} value={k}>{k}</option>
+            ))}
+          </select>
+        </label>
+        {charts.length > 0 && (
+          <label>
+            Chart{' '}
+            <select value={selected} onChange={(e) => setSelected(Number(e.target.value))}>
+              {charts.map((c, i) => (
+                <option key={i} value={i}>
+                  {c.versus ? `${c.position} call vs ${c.versus}` : `${c.position} jam`}
+                </option>
+              ))}
+            </select>
+          </label>
+        )}
+      </div>
+      {error && <p className="push-fold-error">{error}</p>}
+      {data && chart && (
+        <>
+          <div className="push-fold-grid">
+            {chart.grid.map((row, r) =>
+              row.map((p, c) => (
+                <div
+                  key={`${r}-${c}`}
+                  className="push-fold-cell"
+                  title={`${handName(data.ranks, r, c)}: ${(p * 100).toFixed(0)}%`}
+                  style={{ background: `rgba(46, 160, 90, ${p.toFixed(2)})` }}
+                >
+                  {handName(data.ranks, r, c)}
+                </div>
+              )),
+            )}
+          </div>
+          <p className="push-fold-summary">
+            Plays {chart.percent.toFixed(1)}% of hands · {data.icm ? '$EV' : 'EV'}{' '}
+            {data.positions.map((p, i) => `${p} ${data.ev[i] >= 0 ? '+' : ''}${data.ev[i].toFixed(2)}`).join(', ')}
+            {data.icm ? '% of the prize pool' : ' bb'}
+            {data.elapsed_ms != null && ` · solved in ${data.elapsed_ms.toFixed(0)} ms`}
+          </p>
+        </>
+      )}
+    </div>
+  )
+}
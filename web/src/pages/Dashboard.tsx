@@ -3,6 +3,7 @@ import { useAuth } from '../context/AuthContext'
 import CameraScanModal from '../components/CameraScanModal'
 import EquityGraph from '../components/EquityGraph'
 import PokerTips from '../components/PokerTips'
+import PushFoldChart from '../components/PushFoldChart'
 import AIChatPanel from '../components/AIChatPanel'
 import { apiUrl } from '../lib/api'
 import '../App.css'
@@ -636,6 +637,9 @@ export default function Dashboard() {
             )}
           </section>
         )}
+        <section className="section">
+          <PushFoldChart />
+        </section>
       </main>
     </div>
   )
@@ -1,4 +1,6 @@
+import { useEffect, useState } from 'react'
 import { Link } from 'react-router-dom'
+import { apiUrl } from '../lib/api'
 import './HandHierarchy.css'
 
 const RANKINGS = [
@@ -14,6 +16,84 @@ const RANKINGS = [
   { rank: 10, name: 'High Card', desc: 'A♠ K♦ 9♥ 5♣ 2♠', ex: 'No pair; highest card wins' },
 ]
 
+type GridCell = { hand: string; equity: number; holdings: number }
+
+/** Green above a fair share of the pot (1 / players), red below. */
+function equityColor(equity: number, players: number): string {
+  const ratio = Math.min(2, Math.max(0.5, equity * players))
+  const hue = ratio >= 1 ? 60 + 60 * (ratio - 1) : 120 * (ratio - 0.5)
+  return `hsl(${hue.toFixed(0)}, 70%, 55%)`
+}
+
+function StartingHandGrid() {
+  const [opponents, setOpponents] = useState(1)
+  const [grid, setGrid] = useState<GridCell[][] | null>(null)
+  const [exact, setExact] = useState(false)
+  const [error, setError] = useState<string | null>(null)
+
+  useEffect(() => {
+    let cancelled = false
+    setError(null)
+    fetch(apiUrl('/api/equity-grid'), {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/json' },
+      body: JSON.stringify({ board: [], num_opponents: opponents }),
+    })
+      .then(async (res) => {
+        if (!res.ok) throw new Error((await res.json().catch(() => ({}))).detail || 'Equity grid failed')
+        return res.json()
+      })
+      .then((data) => {
+        if (cancelled) return
+        setGrid(data.grid)
+        setExact(data.exact)
+      })
+      .catch((e) => {
+        if (!cancelled) setError(e instanceof Error ? e.message : 'Request failed')
+      })
+    return () => {
+      cancelled = true
+    }
+  }, [opponents])
+
+  return (
+    <section className="hand-grid-section">
+      <div className="hand-grid-header">
+        <h2>Starting-hand equity</h2>
+        <label>
+          Opponents{' '}
+          <select value={opponents} onChange={(e) => setOpponents(Number(e.target.value))}>
+            {[1, 2, 3, 4, 5, 6, 7, 8].map((n) => (
+              <option key={n} value={n}>{n}</option>
+            ))}
+          </select>
+        </label>
+      </div>
+      <p className="hand-hierarchy-intro">
+        All-in preflop equity of every starting hand against random hands{exact ? ' (exact)' : ''}. Suited hands are
+        above the diagonal, offsuit below.
+      </p>
+      {error && <p className="hand-grid-error">{error}</p>}
+      {grid && (
+        <div className="hand-grid" role="table" aria-label="Starting-hand equity grid">
+          {grid.flat().map((cell) => (
+            <div
+              key={cell.hand}
+              className="hand-grid-cell"
+              role="cell"
+              title={`${cell.hand}: ${(cell.equity * 100).toFixed(1)}%`}
+              style={{ background: cell.holdings ? equityColor(cell.equity, opponents + 1) : undefined }}
+            >
+              <span className="hand-grid-name">{cell.hand}</span>
+              <span className="hand-grid-equity">{cell.holdings ? (cell.equity * 100).toFixed(0) : '-'}</span>
+            </div>
+          ))}
+        </div>
+      )}
+    </section>
+  )
+}
+
 export default function HandHierarchy() {
   const col1 = RANKINGS.filter((h) => h.rank <= 5)
   const col2 = RANKINGS.filter((h) => h.rank > 5)
@@ -72,6 +152,7 @@ export default function HandHierarchy() {
           ))}
         </div>
       </div>
+      <StartingHandGrid />
     </div>
   )
 }